@@ -0,0 +1,102 @@
+#include "wdeque.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+static const int kCount = 20000000;
+
+static size_t g_allocs = 0;
+static size_t g_alloc_bytes = 0;
+static volatile long long g_sink = 0;
+
+void* operator new(size_t n)
+{
+    ++g_allocs;
+    g_alloc_bytes += n;
+    void* p = std::malloc(n);
+    if(nullptr == p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+template <class Func>
+double elapsedMs(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// a FIFO that holds up to [window] items, then drains completely
+template <size_t BufSize>
+void benchFifo(const char* name, int window)
+{
+    wstl::deque<int, BufSize> dq;
+    long long sum = 0;
+    const size_t allocs = g_allocs;
+    double ms = elapsedMs([&]() {
+        for(int i = 0; i < kCount; i += window) {
+            for(int j = 0; j < window; ++j) {
+                dq.push_back(j);
+            }
+            while (!dq.empty())
+            {
+                sum += dq.front();
+                dq.pop_front();
+            }
+        }
+    });
+    g_sink = sum;
+    LOGI(name, " buffer:", wstl::deque<int, BufSize>::buffer_size, " window:", window,
+         " (ms):", ms, " allocations:", g_allocs - allocs);
+}
+
+// the live range keeps drifting through the map, once the window is full every
+// allocation left is a map growth (buffers are recycled)
+template <size_t BufSize>
+void benchMapDrift(const char* name, int window)
+{
+    wstl::deque<int, BufSize> dq;
+    for(int i = 0; i < window; ++i) {
+        dq.push_back(i);
+    }
+    const size_t allocs = g_allocs;
+    const size_t bytes = g_alloc_bytes;
+    double ms = elapsedMs([&]() {
+        for(int i = 0; i < kCount; ++i) {
+            dq.push_back(i);
+            dq.pop_front();
+        }
+    });
+    LOGI(name, " window:", window, " (ms):", ms, " map allocations:", g_allocs - allocs,
+         " bytes:", g_alloc_bytes - bytes);
+}
+
+int main()
+{
+    LOGI("items:", kCount);
+    LOGI("-- buffer size --");
+    benchFifo<16>("deque<int, 16>    ", 64);
+    benchFifo<0>("deque<int>        ", 64);
+    benchFifo<16>("deque<int, 16>    ", 1 << 16);
+    benchFifo<0>("deque<int>        ", 1 << 16);
+    benchFifo<(2 << 20) / sizeof(int)>("deque<int, 2MB>   ", 1 << 16);
+    benchFifo<(2 << 20) / sizeof(int)>("deque<int, 2MB>   ", 1 << 20);
+    benchFifo<0>("deque<int>        ", 1 << 20);
+    LOGI("-- map growth --");
+    benchMapDrift<16>("deque<int, 16>    ", 100);
+    benchMapDrift<16>("deque<int, 16>    ", 10000);
+    benchMapDrift<0>("deque<int>        ", 10000);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "wdeque.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+// rebuild with -DDEQUE_SPARE_BUFFERS=0 to see the deque without buffer recycling
+
+static const int kCount = 20000000;
+static const int kWindow = 1000;
+
+static size_t g_allocs = 0;
+static volatile long long g_sink = 0;
+
+void* operator new(size_t n)
+{
+    ++g_allocs;
+    void* p = std::malloc(n);
+    if(nullptr == p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+template <class Func>
+double elapsedMs(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// keep the newest kWindow items: push_back / pop_front
+double benchSlidingWindow(size_t& allocs)
+{
+    wstl::deque<int> dq;
+    long long sum = 0;
+    const size_t before = g_allocs;
+    double ms = elapsedMs([&]() {
+        for(int i = 0; i < kCount; ++i) {
+            dq.push_back(i);
+            if(dq.size() > static_cast<size_t>(kWindow)) {
+                sum += dq.front();
+                dq.pop_front();
+            }
+        }
+    });
+    allocs = g_allocs - before;
+    g_sink = sum;
+    return ms;
+}
+
+// a queue whose length keeps crossing the same buffer boundary
+double benchBoundary(size_t& allocs)
+{
+    wstl::deque<int> dq;
+    const int buf = static_cast<int>(wstl::deque<int>::buffer_size);
+    for(int i = 0; i < buf - 1; ++i) {
+        dq.push_back(i);
+    }
+    const size_t before = g_allocs;
+    double ms = elapsedMs([&]() {
+        for(int i = 0; i < kCount / 4; ++i) {
+            dq.push_back(i);
+            dq.push_back(i);
+            dq.pop_back();
+            dq.pop_back();
+        }
+    });
+    allocs = g_allocs - before;
+    return ms;
+}
+
+int main()
+{
+    size_t allocs = 0;
+    LOGI("items:", kCount, " window:", kWindow, " spare buffers:", DEQUE_SPARE_BUFFERS);
+    LOGI("sliding window push_back/pop_front (ms):", benchSlidingWindow(allocs));
+    LOGI("    allocations:", allocs);
+    LOGI("boundary push_back/pop_back        (ms):", benchBoundary(allocs));
+    LOGI("    allocations:", allocs);
+    return 0;
+}
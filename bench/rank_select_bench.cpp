@@ -0,0 +1,101 @@
+#include "wrank_select.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+static const size_t kBits = size_t(1) << 27;
+static const int kQueries = 10000000;
+
+static volatile size_t g_sink = 0;
+
+template <class Func>
+double elapsedMs(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static uint64_t nextRandom(uint64_t& s)
+{
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+}
+
+// the plain alternative: ones before every word, 64 extra bits per word
+struct word_prefix_index
+{
+    const uint64_t*         words;
+    std::vector<uint64_t>   before;
+
+    word_prefix_index(const uint64_t* w, size_t nwords) : words(w), before(nwords + 1, 0) {
+        for(size_t i = 0; i < nwords; ++i) {
+            before[i + 1] = before[i] + wstl::bit_popcount(w[i]);
+        }
+    }
+
+    size_t rank1(size_t pos) const {
+        const uint64_t bits = words[pos / 64] & ((uint64_t(1) << (pos % 64)) - 1);
+        return before[pos / 64] + wstl::bit_popcount(bits);
+    }
+
+    size_t select1(size_t k) const {
+        const size_t w = static_cast<size_t>(std::upper_bound(before.begin(), before.end(), k) - before.begin()) - 1;
+        return w * 64 + wstl::select_in_word(words[w], k - before[w]);
+    }
+};
+
+static void benchDensity(int percent)
+{
+    wstl::vector<uint64_t> words;
+    uint64_t seed = 88172645463325252ull + static_cast<uint64_t>(percent);
+    for(size_t i = 0; i < kBits / 64; ++i) {
+        uint64_t w = 0;
+        for(int b = 0; b < 64; ++b) {
+            if(nextRandom(seed) % 100 < static_cast<uint64_t>(percent)) {
+                w |= uint64_t(1) << b;
+            }
+        }
+        words.push_back(w);
+    }
+    wstl::rank_select rs(words, kBits);
+    word_prefix_index plain(words.data(), kBits / 64);
+
+    std::vector<size_t> positions(kQueries), ranks(kQueries);
+    for(int i = 0; i < kQueries; ++i) {
+        positions[i] = static_cast<size_t>(nextRandom(seed) % kBits);
+        ranks[i] = static_cast<size_t>(nextRandom(seed) % rs.ones());
+    }
+
+    size_t sum = 0;
+    const double rank9 = elapsedMs([&]() {
+        for(int i = 0; i < kQueries; ++i) sum += rs.rank1(positions[i]);
+    });
+    const double rankPlain = elapsedMs([&]() {
+        for(int i = 0; i < kQueries; ++i) sum -= plain.rank1(positions[i]);
+    });
+    const double select9 = elapsedMs([&]() {
+        for(int i = 0; i < kQueries; ++i) sum += rs.select1(ranks[i]);
+    });
+    const double selectPlain = elapsedMs([&]() {
+        for(int i = 0; i < kQueries; ++i) sum -= plain.select1(ranks[i]);
+    });
+    g_sink = sum;
+
+    LOGI("density ", percent, "%, ", kQueries, " queries over ", kBits, " bits");
+    LOGI("    index bytes  rank_select:", rs.overhead_bytes(), " per-word prefix:", plain.before.size() * 8);
+    LOGI("    rank1   (ms) rank_select:", rank9, " per-word prefix:", rankPlain);
+    LOGI("    select1 (ms) rank_select:", select9, " per-word prefix (binary search):", selectPlain);
+}
+
+int main()
+{
+    benchDensity(50);
+    benchDensity(5);
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "wspsc_ring.hpp"
+#include "wqueue.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+static const int kCount = 10000000;
+static const int kBatch = 64;
+
+template <class Func>
+double elapsedMs(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double benchMutexQueue()
+{
+    wstl::queue<int, wstl::deque<int>> q;
+    std::mutex mtx;
+    return elapsedMs([&]() {
+        std::thread producer([&]() {
+            for(int i = 0; i < kCount; ++i) {
+                std::lock_guard<std::mutex> lock(mtx);
+                q.push(i);
+            }
+        });
+        long long sum = 0;
+        for(int got = 0; got < kCount;) {
+            std::lock_guard<std::mutex> lock(mtx);
+            while (!q.empty())
+            {
+                sum += q.front();
+                q.pop();
+                ++got;
+            }
+        }
+        producer.join();
+    });
+}
+
+double benchRing()
+{
+    wstl::spsc_ring<int> ring(4096);
+    return elapsedMs([&]() {
+        std::thread producer([&]() {
+            for(int i = 0; i < kCount;) {
+                if(ring.push(i)) ++i;
+                else std::this_thread::yield();
+            }
+        });
+        long long sum = 0;
+        int value = 0;
+        for(int got = 0; got < kCount;) {
+            if(ring.try_pop(value)) {
+                sum += value;
+                ++got;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    });
+}
+
+double benchRingBatch()
+{
+    wstl::spsc_ring<int> ring(4096);
+    return elapsedMs([&]() {
+        std::thread producer([&]() {
+            int batch[kBatch];
+            for(int i = 0; i < kCount;) {
+                int n = 0;
+                for(; n < kBatch && i + n < kCount; ++n) batch[n] = i + n;
+                const int pushed = static_cast<int>(ring.push_n(batch, n));
+                if(0 == pushed) std::this_thread::yield();
+                i += pushed;
+            }
+        });
+        long long sum = 0;
+        int out[kBatch];
+        for(int got = 0; got < kCount;) {
+            const int n = static_cast<int>(ring.pop_n(out, kBatch));
+            if(0 == n) std::this_thread::yield();
+            for(int j = 0; j < n; ++j) sum += out[j];
+            got += n;
+        }
+        producer.join();
+    });
+}
+
+int main()
+{
+    LOGI("items:", kCount);
+    LOGI("mutex + queue<int, deque<int>> (ms):", benchMutexQueue());
+    LOGI("spsc_ring push/try_pop        (ms):", benchRing());
+    LOGI("spsc_ring push_n/pop_n x64    (ms):", benchRingBatch());
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "wunrolled_list.hpp"
+#include "wlist.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+static const int kCount = 4000000;
+static const int kInsertBase = 100000;
+static const int kInserts = 2000;
+
+static volatile long long g_sink = 0;
+
+template <class Func>
+double elapsedMs(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <class List>
+double benchTraversal(const List& lst, int rounds)
+{
+    long long sum = 0;
+    double ms = elapsedMs([&]() {
+        for(int r = 0; r < rounds; ++r) {
+            for(auto it = lst.begin(); it != lst.end(); ++it) {
+                sum += *it;
+            }
+        }
+    });
+    g_sink = sum;
+    return ms / rounds;
+}
+
+// walk to a random position and insert there
+template <class List>
+double benchMidInsert()
+{
+    List lst;
+    for(int i = 0; i < kInsertBase; ++i) {
+        lst.push_back(i);
+    }
+    std::srand(1);
+    double ms = elapsedMs([&]() {
+        for(int i = 0; i < kInserts; ++i) {
+            auto it = lst.begin();
+            wstl::advance(it, std::rand() % static_cast<int>(lst.size()));
+            lst.insert(it, i);
+        }
+    });
+    g_sink = static_cast<long long>(lst.size());
+    return ms;
+}
+
+int main()
+{
+    LOGI("items:", kCount, " unrolled_list<int> node capacity:", wstl::unrolled_list<int>::node_capacity);
+
+    {
+        wstl::list<int> lst;
+        wstl::unrolled_list<int> ulst;
+        std::srand(2);
+        for(int i = 0; i < kCount; ++i) {
+            const int v = std::rand();
+            lst.push_back(v);
+            ulst.push_back(v);
+        }
+        LOGI("traversal, built by push_back");
+        LOGI("    list<int>          (ms):", benchTraversal(lst, 5));
+        LOGI("    unrolled_list<int> (ms):", benchTraversal(ulst, 5));
+
+        // relink the list nodes in a random order, so they are scattered over the
+        // heap like in a long lived list
+        std::vector<wstl::list<int>::iterator> nodes;
+        nodes.reserve(kCount);
+        for(auto it = lst.begin(); it != lst.end(); ++it) {
+            nodes.push_back(it);
+        }
+        for(int i = kCount - 1; i > 0; --i) {
+            wstl::swap(nodes[i], nodes[std::rand() % (i + 1)]);
+        }
+        wstl::list<int> scattered;
+        for(auto it : nodes) {
+            scattered.splice(scattered.end(), lst, it);
+        }
+        LOGI("traversal, list nodes scattered");
+        LOGI("    list<int>          (ms):", benchTraversal(scattered, 5));
+    }
+
+    LOGI("mid-list insert, ", kInserts, " inserts at random positions of ", kInsertBase, " items");
+    LOGI("    list<int>          (ms):", benchMidInsert<wstl::list<int>>());
+    LOGI("    unrolled_list<int> (ms):", benchMidInsert<wstl::unrolled_list<int>>());
+    return 0;
+}
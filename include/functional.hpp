@@ -1,6 +1,10 @@
 #ifndef FUNCTION_HPP__
 #define FUNCTION_HPP__
 
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
 namespace wstl
 {
 
@@ -37,6 +41,64 @@ struct greater : public binary_function<T,T,bool>
     }
 };
 
+// FNV-1a over [n] bytes
+inline size_t hash_bytes(const void* data, size_t n) noexcept
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    unsigned long long h = 14695981039346656037ull;
+    for(size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return static_cast<size_t>(h);
+}
+
+/**
+ * @brief integers and enums hash to themselves, the containers mix the bits
+ */
+template <class T>
+struct hash
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "wstl::hash<T> has no specialization for this type");
+
+    size_t operator()(const T& v) const noexcept {
+        return static_cast<size_t>(v);
+    }
+};
+
+template <class T>
+struct hash<T*>
+{
+    size_t operator()(T* p) const noexcept {
+        return reinterpret_cast<size_t>(p);
+    }
+};
+
+template <>
+struct hash<float>
+{
+    size_t operator()(float v) const noexcept {
+        return v == 0.0f ? 0 : hash_bytes(&v, sizeof(v));   // +0 == -0
+    }
+};
+
+template <>
+struct hash<double>
+{
+    size_t operator()(double v) const noexcept {
+        return v == 0.0 ? 0 : hash_bytes(&v, sizeof(v));
+    }
+};
+
+template <>
+struct hash<std::string>
+{
+    size_t operator()(const std::string& s) const noexcept {
+        return hash_bytes(s.data(), s.size());
+    }
+};
+
 }
 
 
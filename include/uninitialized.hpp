@@ -27,6 +27,27 @@ ForwardIter unchecked_uninit_fill_n(ForwardIter first
     return fill_n(first, n, value);
 }
 
+template <class ForwardIter, class Size, class T>
+ForwardIter unchecked_uninit_fill_n(ForwardIter first
+                                    , Size n
+                                    , const T& value
+                                    , std::false_type)
+{
+    auto cur = first;
+    try
+    {
+        for(; n > 0; --n, ++cur) {
+            wstl::construct(&*cur, value);
+        }
+    }
+    catch(...)
+    {
+        wstl::destroy(first, cur);
+        throw;
+    }
+    return cur;
+}
+
 template <class ForwardIter, class Size, class T>
 ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value)
 {
@@ -56,8 +77,8 @@ void unchecked_uninit_fill(ForwardIter first, ForwardIter last, const T& value,
         for(; first != cur; ++first) {
             wstl::destroy(&*first);
         }
+        throw;
     }
-    
 }
 
 template <class ForwardIter, class T>
@@ -88,9 +109,8 @@ unchecked_uninit_copy(InputIter first, InputIter last, ForwardIter result, std::
     }
     catch(...)
     {
-        for(; result != cur; --cur) {
-            wstl::destroy(&*cur);
-        }
+        wstl::destroy(result, cur);
+        throw;
     }
     return cur;
 }
@@ -126,6 +146,7 @@ unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::
     catch(...)
     {
         wstl::destroy(result, cur);
+        throw;
     }
     return cur;
 }
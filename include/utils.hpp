@@ -48,7 +48,7 @@ void swap(Tp& lhs, Tp& rhs)
 {
     auto tmp(wstl::move(lhs));
     lhs = wstl::move(rhs);
-    rhs = move(tmp);
+    rhs = wstl::move(tmp);
 }
 
 }
@@ -213,7 +213,10 @@ unchecked_move(Tp* first, Tp* last, Up* result)
 template <class InputIter, class OutputIter>
 OutputIter unchecked_move(InputIter first, InputIter last, OutputIter result)
 {
-    return unchecked_copy_cat(first, last, result, iterator_category(first));
+    for(; first != last; ++first, ++result) {
+        *result = wstl::move(*first);
+    }
+    return result;
 }
 
 // move
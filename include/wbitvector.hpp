@@ -0,0 +1,816 @@
+#ifndef WBITVECTOR_HPP__
+#define WBITVECTOR_HPP__
+
+/**
+ * @file wbitvector.hpp
+ * @brief vector<bool> packed one bit per element, also usable as dynamic_bitset
+ */
+
+#include "wvector.hpp"
+
+#include <climits>
+#include <cstring>
+
+namespace wstl
+{
+
+typedef unsigned long long bit_word;
+
+static const size_t bit_word_bits = sizeof(bit_word) * CHAR_BIT;
+
+inline size_t bit_popcount(bit_word w) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(w));
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ull);
+    w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<size_t>((w * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// index of the lowest set bit, w must not be 0
+inline size_t bit_ctz(bit_word w) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(w));
+#else
+    size_t n = 0;
+    while (!(w & 1))
+    {
+        w >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief stands in for bool& to a single bit
+ */
+class bit_reference
+{
+private:
+    bit_word*   word_;
+    bit_word    mask_;
+
+public:
+    bit_reference(bit_word* w, bit_word mask) noexcept : word_(w), mask_(mask) {}
+    bit_reference(const bit_reference&) = default;
+
+    operator bool() const noexcept {
+        return (*word_ & mask_) != 0;
+    }
+
+    bit_reference& operator=(bool x) noexcept {
+        if(x) {
+            *word_ |= mask_;
+        }
+        else {
+            *word_ &= ~mask_;
+        }
+        return *this;
+    }
+
+    bit_reference& operator=(const bit_reference& x) noexcept {
+        return *this = static_cast<bool>(x);
+    }
+
+    bool operator~() const noexcept {
+        return !static_cast<bool>(*this);
+    }
+
+    void flip() noexcept {
+        *word_ ^= mask_;
+    }
+};
+
+inline void swap(bit_reference lhs, bit_reference rhs) noexcept
+{
+    const bool tmp = lhs;
+    lhs = rhs;
+    rhs = tmp;
+}
+
+/**
+ * @brief position of a bit, shared by the mutable and the const iterator
+ */
+struct bit_iterator_base
+{
+    bit_word*   word_;
+    size_t      offset_;    // [0, bit_word_bits)
+
+    bit_iterator_base(bit_word* w, size_t off) noexcept : word_(w), offset_(off) {}
+
+    void bump_up() noexcept {
+        if(++offset_ == bit_word_bits) {
+            offset_ = 0;
+            ++word_;
+        }
+    }
+
+    void bump_down() noexcept {
+        if(0 == offset_) {
+            offset_ = bit_word_bits;
+            --word_;
+        }
+        --offset_;
+    }
+
+    void advance(ptrdiff_t n) noexcept {
+        ptrdiff_t pos = static_cast<ptrdiff_t>(offset_) + n;
+        ptrdiff_t w = pos / static_cast<ptrdiff_t>(bit_word_bits);
+        pos %= static_cast<ptrdiff_t>(bit_word_bits);
+        if(pos < 0) {
+            pos += static_cast<ptrdiff_t>(bit_word_bits);
+            --w;
+        }
+        word_ += w;
+        offset_ = static_cast<size_t>(pos);
+    }
+
+    bool operator==(const bit_iterator_base& rhs) const noexcept {
+        return word_ == rhs.word_ && offset_ == rhs.offset_;
+    }
+    bool operator!=(const bit_iterator_base& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+    bool operator<(const bit_iterator_base& rhs) const noexcept {
+        return word_ < rhs.word_ || (word_ == rhs.word_ && offset_ < rhs.offset_);
+    }
+    bool operator>(const bit_iterator_base& rhs) const noexcept {
+        return rhs < *this;
+    }
+    bool operator<=(const bit_iterator_base& rhs) const noexcept {
+        return !(rhs < *this);
+    }
+    bool operator>=(const bit_iterator_base& rhs) const noexcept {
+        return !(*this < rhs);
+    }
+};
+
+inline ptrdiff_t operator-(const bit_iterator_base& lhs, const bit_iterator_base& rhs) noexcept
+{
+    return static_cast<ptrdiff_t>(bit_word_bits) * (lhs.word_ - rhs.word_) +
+           static_cast<ptrdiff_t>(lhs.offset_) - static_cast<ptrdiff_t>(rhs.offset_);
+}
+
+struct bit_iterator : public bit_iterator_base
+                    , public wstl::iterator<wstl::random_access_iterator_tag, bool, ptrdiff_t, void, bit_reference>
+{
+    typedef bit_reference   reference;
+    typedef void            pointer;
+    typedef bit_iterator    self;
+
+    bit_iterator() noexcept : bit_iterator_base(nullptr, 0) {}
+    bit_iterator(bit_word* w, size_t off) noexcept : bit_iterator_base(w, off) {}
+
+    reference operator*() const noexcept {
+        return reference(word_, bit_word(1) << offset_);
+    }
+
+    reference operator[](ptrdiff_t n) const noexcept {
+        return *(*this + n);
+    }
+
+    self& operator++() noexcept {
+        bump_up();
+        return *this;
+    }
+    self operator++(int) noexcept {
+        self tmp = *this;
+        bump_up();
+        return tmp;
+    }
+    self& operator--() noexcept {
+        bump_down();
+        return *this;
+    }
+    self operator--(int) noexcept {
+        self tmp = *this;
+        bump_down();
+        return tmp;
+    }
+    self& operator+=(ptrdiff_t n) noexcept {
+        advance(n);
+        return *this;
+    }
+    self& operator-=(ptrdiff_t n) noexcept {
+        advance(-n);
+        return *this;
+    }
+    self operator+(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self operator-(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp -= n;
+    }
+};
+
+struct bit_const_iterator : public bit_iterator_base
+                          , public wstl::iterator<wstl::random_access_iterator_tag, bool, ptrdiff_t, void, bool>
+{
+    typedef bool                reference;
+    typedef void                pointer;
+    typedef bit_const_iterator  self;
+
+    bit_const_iterator() noexcept : bit_iterator_base(nullptr, 0) {}
+    bit_const_iterator(const bit_word* w, size_t off) noexcept
+        : bit_iterator_base(const_cast<bit_word*>(w), off) {}
+    bit_const_iterator(const bit_iterator& it) noexcept : bit_iterator_base(it.word_, it.offset_) {}
+
+    reference operator*() const noexcept {
+        return (*word_ >> offset_) & 1;
+    }
+
+    reference operator[](ptrdiff_t n) const noexcept {
+        return *(*this + n);
+    }
+
+    self& operator++() noexcept {
+        bump_up();
+        return *this;
+    }
+    self operator++(int) noexcept {
+        self tmp = *this;
+        bump_up();
+        return tmp;
+    }
+    self& operator--() noexcept {
+        bump_down();
+        return *this;
+    }
+    self operator--(int) noexcept {
+        self tmp = *this;
+        bump_down();
+        return tmp;
+    }
+    self& operator+=(ptrdiff_t n) noexcept {
+        advance(n);
+        return *this;
+    }
+    self& operator-=(ptrdiff_t n) noexcept {
+        advance(-n);
+        return *this;
+    }
+    self operator+(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self operator-(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp -= n;
+    }
+};
+
+inline bit_iterator operator+(ptrdiff_t n, const bit_iterator& it) noexcept
+{
+    return it + n;
+}
+
+inline bit_const_iterator operator+(ptrdiff_t n, const bit_const_iterator& it) noexcept
+{
+    return it + n;
+}
+
+/**
+ * @brief vector<bool> stored one bit per element in 64-bit words
+ * @note    1. operator[] and *iterator return a proxy (bit_reference), there is
+ *             no bool* into the container
+ *          2. bits past size() in the last word are always 0, so count, any,
+ *             ==, and the bulk operations work a whole word at a time
+ *          3. &=, |=, ^= need both operands to have the same size
+ *          4. find_first / find_next return npos when no set bit is left
+ */
+template <>
+class vector<bool>
+{
+public:
+    typedef bool                                    value_type;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+    typedef bit_word                                word_type;
+    typedef bit_reference                           reference;
+    typedef bool                                    const_reference;
+    typedef bit_iterator                            iterator;
+    typedef bit_const_iterator                      const_iterator;
+    typedef wstl::reverse_iterator<iterator>        reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+    typedef wstl::allocator<word_type>              data_allocator;
+
+    static const size_type npos = static_cast<size_type>(-1);
+    static const size_type word_bits = bit_word_bits;
+
+private:
+    word_type*  words_;
+    size_type   size_;      // in bits
+    size_type   cap_;       // in words
+
+public:
+    vector() noexcept : words_(nullptr), size_(0), cap_(0) {}
+
+    explicit vector(size_type n) : words_(nullptr), size_(0), cap_(0) {
+        resize(n, false);
+    }
+
+    vector(size_type n, bool value) : words_(nullptr), size_(0), cap_(0) {
+        resize(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+            wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    vector(Iter first, Iter last) : words_(nullptr), size_(0), cap_(0) {
+        try
+        {
+            for(; first != last; ++first) {
+                push_back(static_cast<bool>(*first));
+            }
+        }
+        catch(...)
+        {
+            data_allocator::deallocate(words_, cap_);
+            throw;
+        }
+    }
+
+    vector(std::initializer_list<bool> _list) : vector(_list.begin(), _list.end()) {}
+
+    vector(const vector& rhs) : words_(nullptr), size_(0), cap_(0) {
+        const size_type n = words_for(rhs.size_);
+        if(n > 0) {
+            words_ = data_allocator::allocate(n);
+            std::memcpy(words_, rhs.words_, n * sizeof(word_type));
+            cap_ = n;
+            size_ = rhs.size_;
+        }
+    }
+
+    vector(vector&& rhs) noexcept : words_(rhs.words_), size_(rhs.size_), cap_(rhs.cap_) {
+        rhs.words_ = nullptr;
+        rhs.size_ = 0;
+        rhs.cap_ = 0;
+    }
+
+    vector& operator=(const vector& rhs) {
+        if(this != &rhs) {
+            vector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    vector& operator=(vector&& rhs) noexcept {
+        vector tmp(wstl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    vector& operator=(std::initializer_list<bool> _list) {
+        vector tmp(_list);
+        swap(tmp);
+        return *this;
+    }
+
+    ~vector() {
+        data_allocator::deallocate(words_, cap_);
+    }
+
+public:
+    // iterator
+    iterator begin() noexcept {
+        return iterator(words_, 0);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(words_, 0);
+    }
+    iterator end() noexcept {
+        return begin() + static_cast<difference_type>(size_);
+    }
+    const_iterator end() const noexcept {
+        return begin() + static_cast<difference_type>(size_);
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(word_type);
+    }
+    size_type capacity() const noexcept {
+        return cap_ * word_bits;
+    }
+    void reserve(size_type n);
+    void shrink_to_fit();
+
+    // visit
+    reference operator[](size_type n) {
+        WSTL_DEBUG(n < size_);
+        return reference(words_ + n / word_bits, word_type(1) << (n % word_bits));
+    }
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return test(n);
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "vector<bool>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "vector<bool>::at() subscript out of range");
+        return (*this)[n];
+    }
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return (*this)[0];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return test(0);
+    }
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return (*this)[size_ - 1];
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return test(size_ - 1);
+    }
+
+    // the packed words, bit i is bit (i % 64) of word (i / 64)
+    word_type* data() noexcept {
+        return words_;
+    }
+    const word_type* data() const noexcept {
+        return words_;
+    }
+    size_type word_count() const noexcept {
+        return words_for(size_);
+    }
+
+    // bitset interface
+    bool test(size_type n) const noexcept {
+        return (words_[n / word_bits] >> (n % word_bits)) & 1;
+    }
+    vector& set(size_type n, bool value = true) noexcept {
+        (*this)[n] = value;
+        return *this;
+    }
+    vector& reset(size_type n) noexcept {
+        return set(n, false);
+    }
+    vector& flip(size_type n) noexcept {
+        words_[n / word_bits] ^= word_type(1) << (n % word_bits);
+        return *this;
+    }
+    vector& set() noexcept {
+        fill_bits(0, size_, true);
+        return *this;
+    }
+    vector& reset() noexcept {
+        fill_bits(0, size_, false);
+        return *this;
+    }
+    vector& flip() noexcept;
+
+    size_type count() const noexcept;
+    bool any() const noexcept;
+    bool all() const noexcept {
+        return count() == size_;
+    }
+    bool none() const noexcept {
+        return !any();
+    }
+    size_type find_first() const noexcept {
+        return find_from(0);
+    }
+    size_type find_next(size_type pos) const noexcept {
+        return pos + 1 >= size_ ? npos : find_from(pos + 1);
+    }
+
+    vector& operator&=(const vector& rhs) noexcept;
+    vector& operator|=(const vector& rhs) noexcept;
+    vector& operator^=(const vector& rhs) noexcept;
+
+    vector operator~() const {
+        vector tmp(*this);
+        tmp.flip();
+        return tmp;
+    }
+
+    // modify
+    void assign(size_type n, bool value) {
+        clear();
+        resize(n, value);
+    }
+    void push_back(bool value) {
+        if(size_ == capacity()) {
+            reallocate(get_new_cap(1));
+        }
+        ++size_;
+        set(size_ - 1, value);
+    }
+    void emplace_back(bool value) {
+        push_back(value);
+    }
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        reset(size_ - 1);
+        --size_;
+    }
+    iterator insert(const_iterator pos, bool value) {
+        return insert(pos, 1, value);
+    }
+    iterator insert(const_iterator pos, size_type n, bool value);
+    iterator erase(const_iterator pos) {
+        WSTL_DEBUG(pos >= cbegin() && pos < cend());
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator first, const_iterator last);
+    void resize(size_type n, bool value = false);
+    void clear() noexcept {
+        fill_bits(0, size_, false);
+        size_ = 0;
+    }
+    void swap(vector& rhs) noexcept {
+        wstl::swap(words_, rhs.words_);
+        wstl::swap(size_, rhs.size_);
+        wstl::swap(cap_, rhs.cap_);
+    }
+
+private:
+    static size_type words_for(size_type bits) noexcept {
+        return (bits + word_bits - 1) / word_bits;
+    }
+    size_type get_new_cap(size_type add_bits) const;
+    void reallocate(size_type new_cap);
+    void fill_bits(size_type first, size_type last, bool value) noexcept;
+    size_type find_from(size_type pos) const noexcept;
+};
+
+/*************** private ***************/
+
+// in words, the same growth as vector<T>
+inline vector<bool>::size_type vector<bool>::get_new_cap(size_type add_bits) const
+{
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - add_bits, "vector<bool>'s size too big");
+    const size_type need = words_for(size_ + add_bits);
+    return wstl::grow_capacity(cap_, need - wstl::min(need, cap_), max_size() / word_bits);
+}
+
+inline void vector<bool>::reallocate(size_type new_cap)
+{
+    word_type* words = data_allocator::allocate(new_cap);
+    const size_type used = words_for(size_);
+    if(used > 0) {
+        std::memcpy(words, words_, used * sizeof(word_type));
+    }
+    std::memset(words + used, 0, (new_cap - used) * sizeof(word_type));
+    data_allocator::deallocate(words_, cap_);
+    words_ = words;
+    cap_ = new_cap;
+}
+
+/**
+ * @brief set [first, last) to value, whole words in the middle
+ */
+inline void vector<bool>::fill_bits(size_type first, size_type last, bool value) noexcept
+{
+    if(first >= last) {
+        return;
+    }
+    size_type fw = first / word_bits;
+    const size_type lw = (last - 1) / word_bits;
+    const word_type head = ~word_type(0) << (first % word_bits);
+    const word_type tail = ~word_type(0) >> (word_bits - 1 - (last - 1) % word_bits);
+    if(fw == lw) {
+        const word_type mask = head & tail;
+        words_[fw] = value ? (words_[fw] | mask) : (words_[fw] & ~mask);
+        return;
+    }
+    words_[fw] = value ? (words_[fw] | head) : (words_[fw] & ~head);
+    const word_type fill = value ? ~word_type(0) : word_type(0);
+    for(++fw; fw < lw; ++fw) {
+        words_[fw] = fill;
+    }
+    words_[lw] = value ? (words_[lw] | tail) : (words_[lw] & ~tail);
+}
+
+inline vector<bool>::size_type vector<bool>::find_from(size_type pos) const noexcept
+{
+    if(pos >= size_) {
+        return npos;
+    }
+    size_type w = pos / word_bits;
+    word_type bits = words_[w] & (~word_type(0) << (pos % word_bits));
+    const size_type n = words_for(size_);
+    while (0 == bits)
+    {
+        if(++w == n) {
+            return npos;
+        }
+        bits = words_[w];
+    }
+    return w * word_bits + bit_ctz(bits);
+}
+
+/**************public **************/
+
+inline void vector<bool>::reserve(size_type n)
+{
+    if(words_for(n) > cap_) {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in vector<bool>::reserve(n)");
+        reallocate(words_for(n));
+    }
+}
+
+inline void vector<bool>::shrink_to_fit()
+{
+    const size_type used = words_for(size_);
+    if(used < cap_) {
+        if(0 == used) {
+            data_allocator::deallocate(words_, cap_);
+            words_ = nullptr;
+            cap_ = 0;
+        }
+        else {
+            reallocate(used);
+        }
+    }
+}
+
+inline vector<bool>& vector<bool>::flip() noexcept
+{
+    const size_type n = words_for(size_);
+    for(size_type i = 0; i < n; ++i) {
+        words_[i] = ~words_[i];
+    }
+    if(size_ % word_bits) {
+        words_[n - 1] &= ~word_type(0) >> (word_bits - size_ % word_bits);
+    }
+    return *this;
+}
+
+inline vector<bool>::size_type vector<bool>::count() const noexcept
+{
+    const size_type n = words_for(size_);
+    size_type c = 0;
+    for(size_type i = 0; i < n; ++i) {
+        c += bit_popcount(words_[i]);
+    }
+    return c;
+}
+
+inline bool vector<bool>::any() const noexcept
+{
+    const size_type n = words_for(size_);
+    for(size_type i = 0; i < n; ++i) {
+        if(words_[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline vector<bool>& vector<bool>::operator&=(const vector& rhs) noexcept
+{
+    WSTL_DEBUG(size_ == rhs.size_);
+    const size_type n = words_for(size_);
+    for(size_type i = 0; i < n; ++i) {
+        words_[i] &= rhs.words_[i];
+    }
+    return *this;
+}
+
+inline vector<bool>& vector<bool>::operator|=(const vector& rhs) noexcept
+{
+    WSTL_DEBUG(size_ == rhs.size_);
+    const size_type n = words_for(size_);
+    for(size_type i = 0; i < n; ++i) {
+        words_[i] |= rhs.words_[i];
+    }
+    return *this;
+}
+
+inline vector<bool>& vector<bool>::operator^=(const vector& rhs) noexcept
+{
+    WSTL_DEBUG(size_ == rhs.size_);
+    const size_type n = words_for(size_);
+    for(size_type i = 0; i < n; ++i) {
+        words_[i] ^= rhs.words_[i];
+    }
+    return *this;
+}
+
+inline vector<bool>::iterator vector<bool>::insert(const_iterator pos, size_type n, bool value)
+{
+    WSTL_DEBUG(pos >= cbegin() && pos <= cend());
+    const size_type idx = static_cast<size_type>(pos - cbegin());
+    if(0 == n) {
+        return begin() + static_cast<difference_type>(idx);
+    }
+    if(size_ + n > capacity()) {
+        reallocate(get_new_cap(n));
+    }
+    const size_type old_size = size_;
+    size_ += n;
+    for(size_type i = old_size; i > idx; --i) {
+        set(i - 1 + n, test(i - 1));
+    }
+    fill_bits(idx, idx + n, value);
+    return begin() + static_cast<difference_type>(idx);
+}
+
+inline vector<bool>::iterator vector<bool>::erase(const_iterator first, const_iterator last)
+{
+    WSTL_DEBUG(first >= cbegin() && last <= cend() && !(last < first));
+    const size_type f = static_cast<size_type>(first - cbegin());
+    const size_type l = static_cast<size_type>(last - cbegin());
+    for(size_type i = l; i < size_; ++i) {
+        set(f + i - l, test(i));
+    }
+    const size_type new_size = size_ - (l - f);
+    fill_bits(new_size, size_, false);
+    size_ = new_size;
+    return begin() + static_cast<difference_type>(f);
+}
+
+inline void vector<bool>::resize(size_type n, bool value)
+{
+    if(n < size_) {
+        fill_bits(n, size_, false);
+        size_ = n;
+        return;
+    }
+    if(n > capacity()) {
+        reallocate(get_new_cap(n - size_));
+    }
+    const size_type old_size = size_;
+    size_ = n;
+    if(value) {
+        fill_bits(old_size, n, true);
+    }
+}
+
+inline bool operator==(const vector<bool>& lhs, const vector<bool>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        (0 == lhs.size() || 0 == std::memcmp(lhs.data(), rhs.data(), lhs.word_count() * sizeof(bit_word)));
+}
+
+inline bool operator<(const vector<bool>& lhs, const vector<bool>& rhs)
+{
+    return wstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+inline vector<bool> operator&(const vector<bool>& lhs, const vector<bool>& rhs)
+{
+    vector<bool> tmp(lhs);
+    tmp &= rhs;
+    return tmp;
+}
+
+inline vector<bool> operator|(const vector<bool>& lhs, const vector<bool>& rhs)
+{
+    vector<bool> tmp(lhs);
+    tmp |= rhs;
+    return tmp;
+}
+
+inline vector<bool> operator^(const vector<bool>& lhs, const vector<bool>& rhs)
+{
+    vector<bool> tmp(lhs);
+    tmp ^= rhs;
+    return tmp;
+}
+
+// bloom filters, visited sets: the bitset spelling of the same container
+typedef vector<bool> dynamic_bitset;
+
+}   // wstl
+
+#endif
@@ -0,0 +1,571 @@
+#ifndef WCIRCULAR_BUFFER_HPP__
+#define WCIRCULAR_BUFFER_HPP__
+
+#include "witerator.hpp"
+#include "wmemory.hpp"
+#include "walgorithm.hpp"
+#include "uninitialized.hpp"
+#include "wspan.hpp"
+
+#include <initializer_list>
+#include <utility>
+
+namespace wstl
+{
+
+#ifndef CIRCULAR_BUFFER_INIT_SIZE
+#define CIRCULAR_BUFFER_INIT_SIZE 16
+#endif
+
+template <class T, class Ref, class Ptr>
+struct circular_buffer_iterator : public iterator<random_access_iterator_tag, T>
+{
+    typedef circular_buffer_iterator<T, T&, T*>             iterator;
+    typedef circular_buffer_iterator<T, const T&, const T*> const_iterator;
+    typedef circular_buffer_iterator                        self;
+
+    typedef Ref                                             reference;
+    typedef Ptr                                             pointer;
+    typedef ptrdiff_t                                       difference_type;
+    typedef size_t                                          size_type;
+
+    T*              buf;
+    size_type       cap;
+    size_type       head;
+    difference_type idx;        // logical position, 0 is front()
+
+    circular_buffer_iterator() noexcept : buf(nullptr), cap(0), head(0), idx(0) {}
+
+    circular_buffer_iterator(T* b, size_type c, size_type h, difference_type i) noexcept
+                : buf(b), cap(c), head(h), idx(i) {}
+
+    circular_buffer_iterator(const iterator& rhs) noexcept
+                : buf(rhs.buf), cap(rhs.cap), head(rhs.head), idx(rhs.idx) {}
+
+    reference operator*() const {
+        size_type pos = head + static_cast<size_type>(idx);
+        if(pos >= cap) pos -= cap;
+        return buf[pos];
+    }
+
+    pointer operator->() const {
+        return &(operator*());
+    }
+
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    self& operator++() { ++idx; return *this; }
+    self& operator--() { --idx; return *this; }
+
+    self operator++(int) {
+        self tmp = *this;
+        ++idx;
+        return tmp;
+    }
+
+    self operator--(int) {
+        self tmp = *this;
+        --idx;
+        return tmp;
+    }
+
+    self& operator+=(difference_type n) { idx += n; return *this; }
+    self& operator-=(difference_type n) { idx -= n; return *this; }
+
+    self operator+(difference_type n) const {
+        self tmp = *this;
+        return tmp += n;
+    }
+
+    self operator-(difference_type n) const {
+        self tmp = *this;
+        return tmp -= n;
+    }
+
+    difference_type operator-(const self& rhs) const {
+        return idx - rhs.idx;
+    }
+
+    bool operator==(const self& rhs) const { return idx == rhs.idx; }
+    bool operator!=(const self& rhs) const { return idx != rhs.idx; }
+    bool operator<(const self& rhs) const { return idx < rhs.idx; }
+    bool operator>(const self& rhs) const { return rhs < *this; }
+    bool operator<=(const self& rhs) const { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+/**
+ * @brief A ring buffer stored in one contiguous allocation
+ * @note    1. push/pop at both ends never allocate while size() < capacity(),
+ *             a growable buffer doubles its storage when it is full
+ *          2. in overwrite mode the capacity is fixed and pushing into a full
+ *             buffer replaces the element at the opposite end
+ *          3. as_spans() hands out the (at most two) contiguous runs that hold
+ *             the elements, in order, so they can be written without copying
+ */
+template <class T>
+class circular_buffer
+{
+public:
+    typedef wstl::allocator<T>                          allocator_type;
+    typedef wstl::allocator<T>                          data_allocator;
+
+    typedef typename allocator_type::value_type         value_type;
+    typedef typename allocator_type::pointer            pointer;
+    typedef typename allocator_type::const_pointer      const_pointer;
+    typedef typename allocator_type::reference          reference;
+    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_type::size_type          size_type;
+    typedef typename allocator_type::difference_type    difference_type;
+
+    typedef circular_buffer_iterator<T, T&, T*>             iterator;
+    typedef circular_buffer_iterator<T, const T&, const T*> const_iterator;
+    typedef wstl::reverse_iterator<iterator>                reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>          const_reverse_iterator;
+
+    typedef span<T>                                     span_type;
+    typedef span<const T>                               const_span_type;
+
+private:
+    pointer     buffer_;
+    size_type   cap_;
+    size_type   head_;
+    size_type   size_;
+    bool        overwrite_;
+
+public:
+    circular_buffer() noexcept
+        : buffer_(nullptr), cap_(0), head_(0), size_(0), overwrite_(false) {}
+
+    explicit circular_buffer(size_type n) {
+        fill_init(n, value_type());
+    }
+
+    circular_buffer(size_type n, const value_type& value) {
+        fill_init(n, value);
+    }
+
+    template <class IIter, typename std::enable_if<
+                wstl::is_input_iterator<IIter>::value, int>::type = 0>
+    circular_buffer(IIter first, IIter last) {
+        range_init(first, last, CIRCULAR_BUFFER_INIT_SIZE);
+    }
+
+    circular_buffer(std::initializer_list<value_type> ilist) {
+        range_init(ilist.begin(), ilist.end(), CIRCULAR_BUFFER_INIT_SIZE);
+    }
+
+    // same capacity, an overwrite-mode copy drops its oldest elements at the same point
+    circular_buffer(const circular_buffer& rhs) {
+        range_init(rhs.begin(), rhs.end(), rhs.cap_);
+        overwrite_ = rhs.overwrite_;
+    }
+
+    circular_buffer(circular_buffer&& rhs) noexcept
+        : buffer_(rhs.buffer_), cap_(rhs.cap_), head_(rhs.head_)
+        , size_(rhs.size_), overwrite_(rhs.overwrite_)
+    {
+        rhs.buffer_ = nullptr;
+        rhs.cap_ = 0;
+        rhs.head_ = 0;
+        rhs.size_ = 0;
+    }
+
+    circular_buffer& operator=(const circular_buffer& rhs) {
+        if(this != &rhs) {
+            circular_buffer tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    circular_buffer& operator=(circular_buffer&& rhs) noexcept {
+        circular_buffer tmp(wstl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    // in overwrite mode the capacity stays and the newest elements are kept,
+    // as pushing them one by one would
+    circular_buffer& operator=(std::initializer_list<value_type> ilist) {
+        circular_buffer tmp;
+        if(overwrite_ && 0 != cap_) {
+            const size_type n = ilist.size();
+            tmp.range_init(ilist.begin() + (n > cap_ ? n - cap_ : 0), ilist.end(), cap_);
+            tmp.overwrite_ = true;
+        }
+        else {
+            tmp.range_init(ilist.begin(), ilist.end(), CIRCULAR_BUFFER_INIT_SIZE);
+        }
+        swap(tmp);
+        return *this;
+    }
+
+    ~circular_buffer() {
+        clear();
+        data_allocator::deallocate(buffer_, cap_);
+    }
+
+public:
+    // iterator related
+    iterator begin() noexcept {
+        return iterator(buffer_, cap_, head_, 0);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(buffer_, cap_, head_, 0);
+    }
+    iterator end() noexcept {
+        return iterator(buffer_, cap_, head_, static_cast<difference_type>(size_));
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(buffer_, cap_, head_, static_cast<difference_type>(size_));
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    bool full() const noexcept {
+        return size_ == cap_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    size_type capacity() const noexcept {
+        return cap_;
+    }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(T);
+    }
+
+    void reserve(size_type n) {
+        if(n > cap_) {
+            THROW_LENGTH_ERROR_IF(n > max_size(),
+                "n can't larger than max_size() in circular_buffer<T>::reserve(n)");
+            reallocate(n);
+        }
+    }
+
+    void shrink_to_fit() {
+        if(size_ < cap_) {
+            reallocate(size_);
+        }
+    }
+
+    // overwrite mode keeps the current capacity
+    bool overwrite() const noexcept {
+        return overwrite_;
+    }
+    void set_overwrite(bool on) noexcept {
+        overwrite_ = on;
+    }
+
+    // visit
+    reference operator[](size_type n) {
+        WSTL_DEBUG(n < size_);
+        return buffer_[physical(n)];
+    }
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return buffer_[physical(n)];
+    }
+
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "circular_buffer<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "circular_buffer<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return buffer_[head_];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return buffer_[head_];
+    }
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return buffer_[physical(size_ - 1)];
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return buffer_[physical(size_ - 1)];
+    }
+
+    std::pair<span_type, span_type> as_spans() noexcept {
+        const size_type first_len = wstl::min(size_, cap_ - head_);
+        return std::pair<span_type, span_type>(span_type{buffer_ + head_, first_len},
+                                               span_type{buffer_, size_ - first_len});
+    }
+
+    std::pair<const_span_type, const_span_type> as_spans() const noexcept {
+        const size_type first_len = wstl::min(size_, cap_ - head_);
+        return std::pair<const_span_type, const_span_type>(
+                    const_span_type{buffer_ + head_, first_len},
+                    const_span_type{buffer_, size_ - first_len});
+    }
+
+    // move the elements so that they start at the beginning of the storage
+    pointer linearize();
+
+    // modify
+    template <class ...Args>
+    void emplace_back(Args&& ...args);
+    template <class ...Args>
+    void emplace_front(Args&& ...args);
+
+    void push_back(const value_type& value) {
+        emplace_back(value);
+    }
+    void push_back(value_type&& value) {
+        emplace_back(wstl::move(value));
+    }
+    void push_front(const value_type& value) {
+        emplace_front(value);
+    }
+    void push_front(value_type&& value) {
+        emplace_front(wstl::move(value));
+    }
+
+    void pop_front() {
+        WSTL_DEBUG(!empty());
+        data_allocator::destroy(buffer_ + head_);
+        head_ = next(head_);
+        --size_;
+    }
+
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        data_allocator::destroy(buffer_ + physical(size_ - 1));
+        --size_;
+    }
+
+    void clear() noexcept {
+        while (!empty())
+        {
+            pop_back();
+        }
+        head_ = 0;
+    }
+
+    void swap(circular_buffer& rhs) noexcept {
+        wstl::swap(buffer_, rhs.buffer_);
+        wstl::swap(cap_, rhs.cap_);
+        wstl::swap(head_, rhs.head_);
+        wstl::swap(size_, rhs.size_);
+        wstl::swap(overwrite_, rhs.overwrite_);
+    }
+
+private:
+    size_type physical(size_type n) const noexcept {
+        const size_type pos = head_ + n;
+        return pos >= cap_ ? pos - cap_ : pos;
+    }
+    size_type next(size_type pos) const noexcept {
+        return pos + 1 == cap_ ? 0 : pos + 1;
+    }
+    size_type prev(size_type pos) const noexcept {
+        return 0 == pos ? cap_ - 1 : pos - 1;
+    }
+
+    void init_space(size_type cap);
+    void fill_init(size_type n, const value_type& value);
+    template <class IIter>
+    void range_init(IIter first, IIter last, size_type min_cap);
+
+    size_type get_new_cap() const;
+    void reallocate(size_type new_cap);
+};
+
+/************* private ***************/
+
+template <class T>
+void circular_buffer<T>::init_space(size_type cap)
+{
+    buffer_ = data_allocator::allocate(cap);
+    cap_ = cap;
+    head_ = 0;
+    size_ = 0;
+    overwrite_ = false;
+}
+
+template <class T>
+void circular_buffer<T>::fill_init(size_type n, const value_type& value)
+{
+    init_space(wstl::max(n, static_cast<size_type>(CIRCULAR_BUFFER_INIT_SIZE)));
+    try
+    {
+        wstl::uninitialized_fill(buffer_, buffer_ + n, value);
+    }
+    catch(...)
+    {
+        data_allocator::deallocate(buffer_, cap_);
+        throw;
+    }
+    size_ = n;
+}
+
+template <class T>
+template <class IIter>
+void circular_buffer<T>::range_init(IIter first, IIter last, size_type min_cap)
+{
+    const size_type n = wstl::distance(first, last);
+    init_space(wstl::max(n, min_cap));
+    try
+    {
+        wstl::uninitialized_copy(first, last, buffer_);
+    }
+    catch(...)
+    {
+        data_allocator::deallocate(buffer_, cap_);
+        throw;
+    }
+    size_ = n;
+}
+
+template <class T>
+typename circular_buffer<T>::size_type circular_buffer<T>::get_new_cap() const
+{
+    THROW_LENGTH_ERROR_IF(cap_ > max_size() / 2, "circular_buffer<T>'s size too big");
+    return 0 == cap_ ? static_cast<size_type>(CIRCULAR_BUFFER_INIT_SIZE) : cap_ * 2;
+}
+
+template <class T>
+void circular_buffer<T>::reallocate(size_type new_cap)
+{
+    pointer new_buffer = data_allocator::allocate(new_cap);
+    auto spans = as_spans();
+    pointer new_end = new_buffer;
+    try
+    {
+        new_end = wstl::uninitialized_move(spans.first.begin(), spans.first.end(), new_buffer);
+        wstl::uninitialized_move(spans.second.begin(), spans.second.end(), new_end);
+    }
+    catch(...)
+    {
+        data_allocator::deallocate(new_buffer, new_cap);
+        throw;
+    }
+
+    data_allocator::destroy(spans.first.begin(), spans.first.end());
+    data_allocator::destroy(spans.second.begin(), spans.second.end());
+    data_allocator::deallocate(buffer_, cap_);
+    buffer_ = new_buffer;
+    cap_ = new_cap;
+    head_ = 0;
+}
+
+/************* public ***************/
+
+template <class T>
+typename circular_buffer<T>::pointer circular_buffer<T>::linearize()
+{
+    if(head_ + size_ > cap_) {
+        reallocate(cap_);
+    }
+    return buffer_ + head_;
+}
+
+template <class T>
+template <class ...Args>
+void circular_buffer<T>::emplace_back(Args&& ...args)
+{
+    if(size_ == cap_) {
+        if(overwrite_ && 0 != cap_) {
+            // the slot after back() is front()
+            buffer_[head_] = value_type(wstl::forward<Args>(args)...);
+            head_ = next(head_);
+            return;
+        }
+        // the arguments may refer to elements, build the value before they move
+        value_type value(wstl::forward<Args>(args)...);
+        reallocate(get_new_cap());
+        data_allocator::construct(buffer_ + physical(size_), wstl::move(value));
+        ++size_;
+        return;
+    }
+    data_allocator::construct(buffer_ + physical(size_), wstl::forward<Args>(args)...);
+    ++size_;
+}
+
+template <class T>
+template <class ...Args>
+void circular_buffer<T>::emplace_front(Args&& ...args)
+{
+    if(size_ == cap_) {
+        if(overwrite_ && 0 != cap_) {
+            // the slot before front() is back()
+            head_ = prev(head_);
+            buffer_[head_] = value_type(wstl::forward<Args>(args)...);
+            return;
+        }
+        value_type value(wstl::forward<Args>(args)...);
+        reallocate(get_new_cap());
+        const size_type pos = prev(head_);
+        data_allocator::construct(buffer_ + pos, wstl::move(value));
+        head_ = pos;
+        ++size_;
+        return;
+    }
+    const size_type pos = prev(head_);
+    data_allocator::construct(buffer_ + pos, wstl::forward<Args>(args)...);
+    head_ = pos;
+    ++size_;
+}
+
+/******************************************* */
+// overload operator
+
+template <class T>
+bool operator==(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+{
+    return lhs.size() == rhs.size() && wstl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T>
+bool operator!=(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T>
+bool operator<(const circular_buffer<T>& lhs, const circular_buffer<T>& rhs)
+{
+    return wstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T>
+void swap(circular_buffer<T>& lhs, circular_buffer<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
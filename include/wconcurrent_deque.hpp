@@ -0,0 +1,410 @@
+#ifndef WCONCURRENT_DEQUE_HPP__
+#define WCONCURRENT_DEQUE_HPP__
+
+#include "wdeque.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace wstl
+{
+
+#ifndef WSTL_CACHE_LINE_SIZE
+#define WSTL_CACHE_LINE_SIZE 64
+#endif
+
+// number of recycled segments a concurrent_deque keeps for reuse
+#ifndef CONCURRENT_DEQUE_MAX_SPARE
+#define CONCURRENT_DEQUE_MAX_SPARE 8
+#endif
+
+/**
+ * @brief An unbounded multi-producer / multi-consumer FIFO built from the
+ *        same fixed size buffers as wstl::deque
+ * @note    1. segments hold deque_buf_size<T> slots and are chained by [next],
+ *             producers reserve a slot with one fetch_add on [reserve],
+ *             consumers claim a slot with one CAS on [claim]
+ *          2. only the producer that finds a segment full links the next one,
+ *             so allocation is amortized over buffer_size pushes
+ *          3. a segment whose slots were all claimed is unlinked from head_ and
+ *             retired, it is recycled only once no operation that started
+ *             before the unlink is still running (active_ counts them)
+ */
+template <class T>
+class concurrent_deque
+{
+public:
+    typedef wstl::allocator<T>                          allocator_type;
+    typedef wstl::allocator<T>                          data_allocator;
+
+    typedef typename allocator_type::value_type         value_type;
+    typedef typename allocator_type::pointer            pointer;
+    typedef typename allocator_type::reference          reference;
+    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_type::size_type          size_type;
+
+    static const size_type buffer_size = deque_buf_size<T>::value;
+
+private:
+    enum slot_state : unsigned char
+    {
+        slot_empty = 0,
+        slot_ready,
+        slot_abandoned      // the producer's constructor threw
+    };
+
+    struct segment
+    {
+        std::atomic<size_type>          reserve;
+        std::atomic<size_type>          claim;
+        std::atomic<segment*>           next;
+        std::atomic<unsigned char>      state[buffer_size];
+        pointer                         buffer;
+        segment*                        link;       // free_ / retired_ list
+
+        void reset() {
+            reserve.store(0, std::memory_order_relaxed);
+            claim.store(0, std::memory_order_relaxed);
+            next.store(nullptr, std::memory_order_relaxed);
+            for(size_type i = 0; i < buffer_size; ++i) {
+                state[i].store(slot_empty, std::memory_order_relaxed);
+            }
+            link = nullptr;
+        }
+    };
+
+    typedef wstl::allocator<segment>                    segment_allocator;
+
+    struct op_guard
+    {
+        concurrent_deque* dq;
+
+        explicit op_guard(concurrent_deque* d) : dq(d) {
+            dq->active_.fetch_add(1);
+        }
+
+        ~op_guard() {
+            if(dq->active_.fetch_sub(1) == 1 &&
+               dq->retired_count_.load(std::memory_order_relaxed) != 0) {
+                dq->try_reclaim(0);
+            }
+        }
+    };
+
+private:
+    alignas(WSTL_CACHE_LINE_SIZE) std::atomic<segment*>     head_;
+    alignas(WSTL_CACHE_LINE_SIZE) std::atomic<segment*>     tail_;
+    alignas(WSTL_CACHE_LINE_SIZE) std::atomic<size_type>    active_;
+    std::atomic<size_type>                                  retired_count_;
+
+    std::mutex      pool_mutex_;
+    segment*        free_;
+    size_type       free_count_;
+    segment*        retired_;
+
+public:
+    concurrent_deque() : active_(0), retired_count_(0), free_(nullptr),
+                         free_count_(0), retired_(nullptr)
+    {
+        segment* seg = create_segment();
+        head_.store(seg);
+        tail_.store(seg);
+    }
+
+    concurrent_deque(const concurrent_deque&) = delete;
+    concurrent_deque& operator=(const concurrent_deque&) = delete;
+
+    ~concurrent_deque();
+
+public:
+    /**
+     * @brief a snapshot, other threads may change the answer right away
+     */
+    bool empty();
+
+    template <class ...Args>
+    void emplace_back(Args&& ...args);
+
+    void push_back(const value_type& value) {
+        emplace_back(value);
+    }
+
+    void push_back(value_type&& value) {
+        emplace_back(wstl::move(value));
+    }
+
+    bool try_pop_front(value_type& value);
+
+private:
+    segment*    create_segment();
+    void        destroy_segment(segment* seg);
+    segment*    acquire_segment();
+    void        release_segment(segment* seg);
+    void        destroy_list(segment* seg);
+
+    void        advance_tail(segment* seg);
+    void        retire(segment* seg);
+    void        try_reclaim(size_type self);
+};
+
+template <class T>
+const typename concurrent_deque<T>::size_type concurrent_deque<T>::buffer_size;
+
+/************* private ***************/
+
+template <class T>
+typename concurrent_deque<T>::segment* concurrent_deque<T>::create_segment()
+{
+    segment* seg = segment_allocator::allocate(1);
+    try
+    {
+        wstl::construct(seg);
+        seg->buffer = data_allocator::allocate(buffer_size);
+    }
+    catch(...)
+    {
+        segment_allocator::deallocate(seg);
+        throw;
+    }
+    seg->reset();
+    return seg;
+}
+
+template <class T>
+void concurrent_deque<T>::destroy_segment(segment* seg)
+{
+    data_allocator::deallocate(seg->buffer, buffer_size);
+    segment_allocator::destroy(seg);
+    segment_allocator::deallocate(seg);
+}
+
+template <class T>
+typename concurrent_deque<T>::segment* concurrent_deque<T>::acquire_segment()
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if(free_ != nullptr) {
+            segment* seg = free_;
+            free_ = seg->link;
+            --free_count_;
+            seg->reset();
+            return seg;
+        }
+    }
+    return create_segment();
+}
+
+template <class T>
+void concurrent_deque<T>::release_segment(segment* seg)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if(free_count_ < CONCURRENT_DEQUE_MAX_SPARE) {
+            seg->link = free_;
+            free_ = seg;
+            ++free_count_;
+            return;
+        }
+    }
+    destroy_segment(seg);
+}
+
+template <class T>
+void concurrent_deque<T>::destroy_list(segment* seg)
+{
+    while (seg != nullptr)
+    {
+        segment* next = seg->link;
+        destroy_segment(seg);
+        seg = next;
+    }
+}
+
+/**
+ * @brief move tail_ from a full segment to its successor, linking a fresh
+ *        segment first if nobody has done so yet
+ */
+template <class T>
+void concurrent_deque<T>::advance_tail(segment* seg)
+{
+    segment* next = seg->next.load(std::memory_order_acquire);
+    if(nullptr == next) {
+        segment* fresh = acquire_segment();
+        segment* expected = nullptr;
+        if(seg->next.compare_exchange_strong(expected, fresh)) {
+            next = fresh;
+        }
+        else {
+            release_segment(fresh);
+            next = expected;
+        }
+    }
+    tail_.compare_exchange_strong(seg, next);
+}
+
+template <class T>
+void concurrent_deque<T>::retire(segment* seg)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        seg->link = retired_;
+        retired_ = seg;
+    }
+    retired_count_.fetch_add(1);
+    try_reclaim(1);
+}
+
+/**
+ * @brief recycle the retired segments if no other operation is in flight
+ * @param self : 1 when called from inside an operation, 0 otherwise
+ * @note the list is taken before active_ is read, so every segment in it was
+ *       unlinked before the check and a thread still using one would be counted
+ */
+template <class T>
+void concurrent_deque<T>::try_reclaim(size_type self)
+{
+    segment* batch = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        batch = retired_;
+        retired_ = nullptr;
+    }
+    if(nullptr == batch) {
+        return;
+    }
+
+    if(active_.load() == self) {
+        while (batch != nullptr)
+        {
+            segment* next = batch->link;
+            retired_count_.fetch_sub(1);
+            release_segment(batch);
+            batch = next;
+        }
+    }
+    else {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        while (batch != nullptr)
+        {
+            segment* next = batch->link;
+            batch->link = retired_;
+            retired_ = batch;
+            batch = next;
+        }
+    }
+}
+
+/************* public ***************/
+
+template <class T>
+concurrent_deque<T>::~concurrent_deque()
+{
+    segment* seg = head_.load();
+    while (seg != nullptr)
+    {
+        const size_type last = wstl::min(seg->reserve.load(), buffer_size);
+        for(size_type i = seg->claim.load(); i < last; ++i) {
+            if(seg->state[i].load() == slot_ready) {
+                data_allocator::destroy(seg->buffer + i);
+            }
+        }
+        segment* next = seg->next.load();
+        destroy_segment(seg);
+        seg = next;
+    }
+
+    destroy_list(free_);
+    destroy_list(retired_);
+}
+
+template <class T>
+bool concurrent_deque<T>::empty()
+{
+    op_guard guard(this);
+    segment* seg = head_.load();
+    const size_type idx = seg->claim.load(std::memory_order_acquire);
+    if(idx < wstl::min(seg->reserve.load(std::memory_order_acquire), buffer_size)) {
+        return false;
+    }
+    segment* next = seg->next.load(std::memory_order_acquire);
+    return nullptr == next || 0 == next->reserve.load(std::memory_order_acquire);
+}
+
+template <class T>
+template <class ...Args>
+void concurrent_deque<T>::emplace_back(Args&& ...args)
+{
+    op_guard guard(this);
+    while (true)
+    {
+        segment* seg = tail_.load();
+        const size_type idx = seg->reserve.fetch_add(1, std::memory_order_acq_rel);
+        if(idx < buffer_size) {
+            try
+            {
+                data_allocator::construct(seg->buffer + idx, wstl::forward<Args>(args)...);
+            }
+            catch(...)
+            {
+                seg->state[idx].store(slot_abandoned, std::memory_order_release);
+                throw;
+            }
+            seg->state[idx].store(slot_ready, std::memory_order_release);
+            return;
+        }
+        advance_tail(seg);
+    }
+}
+
+template <class T>
+bool concurrent_deque<T>::try_pop_front(value_type& value)
+{
+    op_guard guard(this);
+    while (true)
+    {
+        segment* seg = head_.load();
+        size_type idx = seg->claim.load(std::memory_order_acquire);
+        if(idx >= buffer_size) {
+            segment* next = seg->next.load(std::memory_order_acquire);
+            if(nullptr == next) {
+                return false;
+            }
+            // tail_ must never point at an unlinked segment
+            segment* expected = seg;
+            tail_.compare_exchange_strong(expected, next);
+            expected = seg;
+            if(head_.compare_exchange_strong(expected, next)) {
+                retire(seg);
+            }
+            continue;
+        }
+
+        if(idx >= seg->reserve.load(std::memory_order_acquire)) {
+            return false;
+        }
+        if(!seg->claim.compare_exchange_weak(idx, idx + 1, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        // the slot is reserved, its producer may still be constructing it
+        unsigned char state = seg->state[idx].load(std::memory_order_acquire);
+        while (slot_empty == state)
+        {
+            std::this_thread::yield();
+            state = seg->state[idx].load(std::memory_order_acquire);
+        }
+        if(slot_abandoned == state) {
+            continue;
+        }
+
+        pointer p = seg->buffer + idx;
+        value = wstl::move(*p);
+        data_allocator::destroy(p);
+        return true;
+    }
+}
+
+}   // wstl
+
+#endif
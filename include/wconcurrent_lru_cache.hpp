@@ -0,0 +1,217 @@
+#ifndef WCONCURRENT_LRU_CACHE_HPP__
+#define WCONCURRENT_LRU_CACHE_HPP__
+
+#include "wlru_cache.hpp"
+
+#include <mutex>
+
+namespace wstl
+{
+
+#ifndef WSTL_CACHE_LINE_SIZE
+#define WSTL_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @brief lru_cache split into shards, each behind its own mutex
+ * @note    1. a key always lands in the same shard, picked from the hash with a
+ *             different mix than the shard's index uses
+ *          2. the capacity is divided evenly, so recency is per shard: the
+ *             entry evicted is the least recently used of its shard
+ *          3. values are copied out, a pointer into a shard would outlive the lock
+ *          4. the eviction callback runs under the shard lock
+ */
+template <class Key, class Value, class Hash = wstl::hash<Key>, class KeyEqual = wstl::equal_to<Key>>
+class concurrent_lru_cache
+{
+public:
+    typedef Key                                                 key_type;
+    typedef Value                                               mapped_type;
+    typedef size_t                                              size_type;
+    typedef lru_cache<Key, Value, Hash, KeyEqual>               shard_cache;
+    typedef typename shard_cache::eviction_callback             eviction_callback;
+
+private:
+    struct shard
+    {
+        std::mutex  mutex;
+        shard_cache cache;
+        char        pad[WSTL_CACHE_LINE_SIZE];  // keeps the next shard's mutex off this line
+
+        shard(size_type capacity, const Hash& hash, const KeyEqual& equal)
+            : cache(capacity, hash, equal) {}
+    };
+
+    shard*      shards_;
+    size_type   shard_count_;       // a power of two
+    Hash        hasher_;
+
+public:
+    /**
+     * @param shards rounded up to a power of two
+     */
+    explicit concurrent_lru_cache(size_type capacity, size_type shards = 16,
+                                  const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+
+    concurrent_lru_cache(const concurrent_lru_cache&) = delete;
+    concurrent_lru_cache& operator=(const concurrent_lru_cache&) = delete;
+
+    ~concurrent_lru_cache();
+
+public:
+    /**
+     * @brief copy the value of [key] into [value] and promote it
+     */
+    bool get(const Key& key, Value& value) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        const Value* v = s.cache.get(key);
+        if(nullptr == v) {
+            return false;
+        }
+        value = *v;
+        return true;
+    }
+
+    bool contains(const Key& key) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.cache.contains(key);
+    }
+
+    template <class K, class V>
+    bool put(K&& key, V&& value, size_type cost = 1) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.cache.put(wstl::forward<K>(key), wstl::forward<V>(value), cost);
+    }
+
+    bool erase(const Key& key) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.cache.erase(key);
+    }
+
+    void clear();
+
+    // sums over the shards, each shard is locked in turn
+    size_type       size();
+    size_type       total_cost();
+    lru_cache_stats stats();
+
+    size_type shard_count() const noexcept {
+        return shard_count_;
+    }
+
+    void set_eviction_callback(const eviction_callback& cb);
+
+private:
+    shard& shard_of(const Key& key) {
+        // murmur3 finalizer, its low bits do not follow the index's high bits
+        unsigned long long h = static_cast<unsigned long long>(hasher_(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return shards_[static_cast<size_type>(h) & (shard_count_ - 1)];
+    }
+};
+
+template <class Key, class Value, class Hash, class KeyEqual>
+concurrent_lru_cache<Key, Value, Hash, KeyEqual>::concurrent_lru_cache(size_type capacity, size_type shards,
+                                                                       const Hash& hash, const KeyEqual& equal)
+    : shards_(nullptr), shard_count_(1), hasher_(hash)
+{
+    while (shard_count_ < shards)
+    {
+        shard_count_ <<= 1;
+    }
+    const size_type per_shard = (capacity + shard_count_ - 1) / shard_count_;
+
+    shards_ = static_cast<shard*>(::operator new(shard_count_ * sizeof(shard)));
+    size_type i = 0;
+    try
+    {
+        for(; i < shard_count_; ++i) {
+            ::new (static_cast<void*>(shards_ + i)) shard(per_shard, hash, equal);
+        }
+    }
+    catch(...)
+    {
+        while (i > 0)
+        {
+            shards_[--i].~shard();
+        }
+        ::operator delete(shards_);
+        throw;
+    }
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+concurrent_lru_cache<Key, Value, Hash, KeyEqual>::~concurrent_lru_cache()
+{
+    for(size_type i = 0; i < shard_count_; ++i) {
+        shards_[i].~shard();
+    }
+    ::operator delete(shards_);
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void concurrent_lru_cache<Key, Value, Hash, KeyEqual>::clear()
+{
+    for(size_type i = 0; i < shard_count_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        shards_[i].cache.clear();
+    }
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+typename concurrent_lru_cache<Key, Value, Hash, KeyEqual>::size_type
+concurrent_lru_cache<Key, Value, Hash, KeyEqual>::size()
+{
+    size_type n = 0;
+    for(size_type i = 0; i < shard_count_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        n += shards_[i].cache.size();
+    }
+    return n;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+typename concurrent_lru_cache<Key, Value, Hash, KeyEqual>::size_type
+concurrent_lru_cache<Key, Value, Hash, KeyEqual>::total_cost()
+{
+    size_type n = 0;
+    for(size_type i = 0; i < shard_count_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        n += shards_[i].cache.total_cost();
+    }
+    return n;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+lru_cache_stats concurrent_lru_cache<Key, Value, Hash, KeyEqual>::stats()
+{
+    lru_cache_stats total;
+    for(size_type i = 0; i < shard_count_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        const lru_cache_stats& s = shards_[i].cache.stats();
+        total.hits += s.hits;
+        total.misses += s.misses;
+        total.insertions += s.insertions;
+        total.evictions += s.evictions;
+    }
+    return total;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void concurrent_lru_cache<Key, Value, Hash, KeyEqual>::set_eviction_callback(const eviction_callback& cb)
+{
+    for(size_type i = 0; i < shard_count_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        shards_[i].cache.set_eviction_callback(cb);
+    }
+}
+
+}   // wstl
+
+#endif
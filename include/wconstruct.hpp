@@ -33,7 +33,7 @@ void construct(Ty* ptr)
 template <class Ty1, class Ty2>
 void construct (Ty1* ptr, const Ty2& value)
 {
-    ::new ((void*)ptr) Ty2(value);
+    ::new ((void*)ptr) Ty1(value);
 }
 
 template <class Ty, class... Args>
@@ -55,6 +55,12 @@ void destroy_one(Ty* pointer, std::false_type)
     }
 }
 
+template <class Ty>
+void destroy(Ty* pointer)
+{
+    destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+}
+
 template <class ForwardIter>
 void destroy_cat(ForwardIter, ForwardIter, std::true_type){}
 
@@ -66,12 +72,6 @@ void destroy_cat(Forwarditer first, Forwarditer last, std::false_type)
     }
 }
 
-template <class Ty>
-void destroy(Ty* pointer)
-{
-    destroy_one(pointer, std::is_trivially_destructible<Ty>{});
-}
-
 template <class ForwardIter>
 void destroy(ForwardIter first, ForwardIter last)
 {
@@ -5,6 +5,7 @@
 #include "wmemory.hpp"
 #include "walgorithm.hpp"
 #include "uninitialized.hpp"
+#include "wspan.hpp"
 
 #include <initializer_list>
 
@@ -15,18 +16,27 @@ namespace wstl
 #define DEQUE_MAP_INIT_SIZE 8
 #endif
 
-template <class T>
+// number of emptied buffers a deque keeps for reuse instead of freeing them
+#ifndef DEQUE_SPARE_BUFFERS
+#define DEQUE_SPARE_BUFFERS 2
+#endif
+
+/**
+ * @brief number of elements in one deque buffer
+ * @note BufSize == 0 picks the default: 4096 bytes, or 16 elements once T is 256 bytes or larger
+ */
+template <class T, size_t BufSize = 0>
 struct deque_buf_size
 {
-    static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+    static constexpr size_t value = BufSize != 0 ? BufSize : (sizeof(T) < 256 ? 4096 / sizeof(T) : 16);
 };
 
-template <class T, class Ref, class Ptr>
+template <class T, class Ref, class Ptr, size_t BufSize = 0>
 struct deque_iterator : public iterator<random_access_iterator_tag, T>
 {
-    typedef deque_iterator<T, T&, T*>               iterator;
-    typedef deque_iterator<T, const T&, const T*>   const_iterator;
-    typedef deque_iterator                          self;
+    typedef deque_iterator<T, T&, T*, BufSize>              iterator;
+    typedef deque_iterator<T, const T&, const T*, BufSize>  const_iterator;
+    typedef deque_iterator                                  self;
 
     typedef Ref                                     reference;
     typedef ptrdiff_t                               difference_type;
@@ -39,7 +49,7 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
     value_pointer   last;
     map_pointer     node;
 
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = deque_buf_size<T, BufSize>::value;
 
     deque_iterator() noexcept
                 : cur(nullptr), first(nullptr), last(nullptr), node(nullptr){}
@@ -173,7 +183,333 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
     }
 };
 
-template <class T>
+/************* segmented algorithms ***************/
+
+/**
+ * @brief overloads of the algorithms for deque_iterator
+ * @note    1. a deque range is a chain of contiguous buffers, these overloads walk
+ *             it one buffer at a time and hand every chunk to the pointer version,
+ *             so the memmove / memset paths of walgorithm.hpp are taken
+ *          2. they have to be declared before deque, its calls are qualified
+ *             (wstl::copy ...) and only see the overloads declared so far
+ *          3. [first, last) as a deque range: the pointer kernel handles one buffer,
+ *             then first jumps to the next node
+ */
+
+// copy: deque -> any
+template <class T, class Ref, class Ptr, size_t BufSize, class OutputIter>
+OutputIter copy(deque_iterator<T, Ref, Ptr, BufSize> first,
+                deque_iterator<T, Ref, Ptr, BufSize> last,
+                OutputIter result)
+{
+    while (first.node != last.node)
+    {
+        result = wstl::copy(first.cur, first.last, result);
+        first.set_node(first.node + 1);
+        first.cur = first.first;
+    }
+    return wstl::copy(first.cur, last.cur, result);
+}
+
+// copy: random access -> deque
+template <class RandomIter, class T, size_t BufSize>
+typename std::enable_if<wstl::is_random_access_iterator<RandomIter>::value,
+                        deque_iterator<T, T&, T*, BufSize>>::type
+copy(RandomIter first, RandomIter last, deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    for(difference_type n = last - first; n > 0;) {
+        const difference_type len = wstl::min(n, static_cast<difference_type>(result.last - result.cur));
+        wstl::copy(first, first + len, result.cur);
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+// copy: deque -> deque
+template <class T, class Ref, class Ptr, size_t BufSize>
+deque_iterator<T, T&, T*, BufSize> copy(deque_iterator<T, Ref, Ptr, BufSize> first,
+                                        deque_iterator<T, Ref, Ptr, BufSize> last,
+                                        deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    for(difference_type n = last - first; n > 0;) {
+        const difference_type len = wstl::min(n, static_cast<difference_type>(result.last - result.cur));
+        wstl::copy(first, first + len, result.cur);
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+// move: deque -> any
+template <class T, class Ref, class Ptr, size_t BufSize, class OutputIter>
+OutputIter move(deque_iterator<T, Ref, Ptr, BufSize> first,
+                deque_iterator<T, Ref, Ptr, BufSize> last,
+                OutputIter result)
+{
+    while (first.node != last.node)
+    {
+        result = wstl::move(first.cur, first.last, result);
+        first.set_node(first.node + 1);
+        first.cur = first.first;
+    }
+    return wstl::move(first.cur, last.cur, result);
+}
+
+// move: random access -> deque
+template <class RandomIter, class T, size_t BufSize>
+typename std::enable_if<wstl::is_random_access_iterator<RandomIter>::value,
+                        deque_iterator<T, T&, T*, BufSize>>::type
+move(RandomIter first, RandomIter last, deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    for(difference_type n = last - first; n > 0;) {
+        const difference_type len = wstl::min(n, static_cast<difference_type>(result.last - result.cur));
+        wstl::move(first, first + len, result.cur);
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+// move: deque -> deque
+template <class T, class Ref, class Ptr, size_t BufSize>
+deque_iterator<T, T&, T*, BufSize> move(deque_iterator<T, Ref, Ptr, BufSize> first,
+                                        deque_iterator<T, Ref, Ptr, BufSize> last,
+                                        deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    for(difference_type n = last - first; n > 0;) {
+        const difference_type len = wstl::min(n, static_cast<difference_type>(result.last - result.cur));
+        wstl::move(first, first + len, result.cur);
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+// copy_backward: deque -> any
+template <class T, class Ref, class Ptr, size_t BufSize, class BidirectionalIter>
+BidirectionalIter copy_backward(deque_iterator<T, Ref, Ptr, BufSize> first,
+                                deque_iterator<T, Ref, Ptr, BufSize> last,
+                                BidirectionalIter result)
+{
+    while (first.node != last.node)
+    {
+        result = wstl::copy_backward(last.first, last.cur, result);
+        last.set_node(last.node - 1);
+        last.cur = last.last;
+    }
+    return wstl::copy_backward(first.cur, last.cur, result);
+}
+
+// copy_backward: random access -> deque
+template <class RandomIter, class T, size_t BufSize>
+typename std::enable_if<wstl::is_random_access_iterator<RandomIter>::value,
+                        deque_iterator<T, T&, T*, BufSize>>::type
+copy_backward(RandomIter first, RandomIter last, deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    for(difference_type n = last - first; n > 0;) {
+        if(result.cur == result.first) {
+            result.set_node(result.node - 1);
+            result.cur = result.last;
+        }
+        const difference_type len = wstl::min(n, static_cast<difference_type>(result.cur - result.first));
+        wstl::copy_backward(last - len, last, result.cur);
+        last -= len;
+        result.cur -= len;
+        n -= len;
+    }
+    return result;
+}
+
+// copy_backward: deque -> deque
+template <class T, class Ref, class Ptr, size_t BufSize>
+deque_iterator<T, T&, T*, BufSize> copy_backward(deque_iterator<T, Ref, Ptr, BufSize> first,
+                                                 deque_iterator<T, Ref, Ptr, BufSize> last,
+                                                 deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    for(difference_type n = last - first; n > 0;) {
+        if(result.cur == result.first) {
+            result.set_node(result.node - 1);
+            result.cur = result.last;
+        }
+        const difference_type len = wstl::min(n, static_cast<difference_type>(result.cur - result.first));
+        wstl::copy_backward(last - len, last, result.cur);
+        last -= len;
+        result.cur -= len;
+        n -= len;
+    }
+    return result;
+}
+
+template <class T, size_t BufSize, class Size, class U>
+deque_iterator<T, T&, T*, BufSize> fill_n(deque_iterator<T, T&, T*, BufSize> first, Size n, const U& value)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    for(difference_type left = static_cast<difference_type>(n); left > 0;) {
+        const difference_type len = wstl::min(left, static_cast<difference_type>(first.last - first.cur));
+        wstl::fill_n(first.cur, len, value);
+        first += len;
+        left -= len;
+    }
+    return first;
+}
+
+template <class T, size_t BufSize, class U>
+void fill(deque_iterator<T, T&, T*, BufSize> first,
+          deque_iterator<T, T&, T*, BufSize> last, const U& value)
+{
+    wstl::fill_n(first, last - first, value);
+}
+
+template <class T, class Ref, class Ptr, size_t BufSize, class U>
+deque_iterator<T, Ref, Ptr, BufSize> find(deque_iterator<T, Ref, Ptr, BufSize> first,
+                                          deque_iterator<T, Ref, Ptr, BufSize> last,
+                                          const U& value)
+{
+    while (first.node != last.node)
+    {
+        T* found = wstl::find(first.cur, first.last, value);
+        if(found != first.last) {
+            first.cur = found;
+            return first;
+        }
+        first.set_node(first.node + 1);
+        first.cur = first.first;
+    }
+    first.cur = wstl::find(first.cur, last.cur, value);
+    return first;
+}
+
+// uninitialized_copy: deque -> any
+template <class T, class Ref, class Ptr, size_t BufSize, class ForwardIter>
+ForwardIter uninitialized_copy(deque_iterator<T, Ref, Ptr, BufSize> first,
+                               deque_iterator<T, Ref, Ptr, BufSize> last,
+                               ForwardIter result)
+{
+    ForwardIter cur = result;
+    try
+    {
+        while (first.node != last.node)
+        {
+            cur = wstl::uninitialized_copy(first.cur, first.last, cur);
+            first.set_node(first.node + 1);
+            first.cur = first.first;
+        }
+        return wstl::uninitialized_copy(first.cur, last.cur, cur);
+    }
+    catch(...)
+    {
+        wstl::destroy(result, cur);
+        throw;
+    }
+}
+
+// uninitialized_copy: random access -> deque
+template <class RandomIter, class T, size_t BufSize>
+typename std::enable_if<wstl::is_random_access_iterator<RandomIter>::value,
+                        deque_iterator<T, T&, T*, BufSize>>::type
+uninitialized_copy(RandomIter first, RandomIter last, deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    deque_iterator<T, T&, T*, BufSize> cur = result;
+    try
+    {
+        for(difference_type n = last - first; n > 0;) {
+            const difference_type len = wstl::min(n, static_cast<difference_type>(cur.last - cur.cur));
+            wstl::uninitialized_copy(first, first + len, cur.cur);
+            first += len;
+            cur += len;
+            n -= len;
+        }
+    }
+    catch(...)
+    {
+        wstl::destroy(result, cur);
+        throw;
+    }
+    return cur;
+}
+
+// uninitialized_copy: deque -> deque
+template <class T, class Ref, class Ptr, size_t BufSize>
+deque_iterator<T, T&, T*, BufSize> uninitialized_copy(deque_iterator<T, Ref, Ptr, BufSize> first,
+                                                      deque_iterator<T, Ref, Ptr, BufSize> last,
+                                                      deque_iterator<T, T&, T*, BufSize> result)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    deque_iterator<T, T&, T*, BufSize> cur = result;
+    try
+    {
+        for(difference_type n = last - first; n > 0;) {
+            const difference_type len = wstl::min(n, static_cast<difference_type>(cur.last - cur.cur));
+            wstl::uninitialized_copy(first, first + len, cur.cur);
+            first += len;
+            cur += len;
+            n -= len;
+        }
+    }
+    catch(...)
+    {
+        wstl::destroy(result, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <class T, size_t BufSize, class Size, class U>
+deque_iterator<T, T&, T*, BufSize> uninitialized_fill_n(deque_iterator<T, T&, T*, BufSize> first, Size n, const U& value)
+{
+    typedef typename deque_iterator<T, T&, T*, BufSize>::difference_type difference_type;
+    deque_iterator<T, T&, T*, BufSize> cur = first;
+    try
+    {
+        for(difference_type left = static_cast<difference_type>(n); left > 0;) {
+            const difference_type len = wstl::min(left, static_cast<difference_type>(cur.last - cur.cur));
+            wstl::uninitialized_fill(cur.cur, cur.cur + len, value);
+            cur += len;
+            left -= len;
+        }
+    }
+    catch(...)
+    {
+        wstl::destroy(first, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <class T, size_t BufSize, class U>
+void uninitialized_fill(deque_iterator<T, T&, T*, BufSize> first,
+                        deque_iterator<T, T&, T*, BufSize> last, const U& value)
+{
+    wstl::uninitialized_fill_n(first, last - first, value);
+}
+
+/**
+ * @brief memory held by a deque, returned by deque::memory_usage()
+ * @note reserved_bytes counts the buffers, the spare buffers and the map,
+ *       live_bytes only the constructed elements
+ */
+struct deque_memory_usage
+{
+    size_t  buffers;            // buffers linked in the map
+    size_t  spare_buffers;      // emptied buffers kept for reuse
+    size_t  map_slots;
+    size_t  live_bytes;
+    size_t  reserved_bytes;
+};
+
+template <class T, size_t BufSize = 0>
 class deque
 {
 
@@ -190,17 +526,25 @@ public:
     typedef typename allocator_type::const_reference    const_reference;
 
     typedef pointer*                                    map_pointer;
-    typedef deque_iterator<T, T&, T*>                   iterator;
-    typedef deque_iterator<T, const T&, const T*>       const_iterator;
+    typedef deque_iterator<T, T&, T*, BufSize>                   iterator;
+    typedef deque_iterator<T, const T&, const T*, BufSize>       const_iterator;
 
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = deque_buf_size<T, BufSize>::value;
 
 // private member
 private:
+    // elements allocated per buffer, at least one pointer wide so an emptied
+    // buffer can hold the spare chain link even when BufSize is tiny
+    static const size_type buffer_alloc =
+        buffer_size * sizeof(T) >= sizeof(T*) ? buffer_size
+                                              : (sizeof(T*) + sizeof(T) - 1) / sizeof(T);
+
     iterator            begin_;
     iterator            end_;
     map_pointer         map_;
     size_type           map_size_;
+    pointer             spare_;         // emptied buffers, chained through their first bytes
+    size_type           spare_count_;
 
 // public function
 public:
@@ -237,14 +581,20 @@ public:
         , end_(wstl::move(rhs.end_))
         , map_(rhs.map_)
         , map_size_(rhs.map_size_)
+        , spare_(rhs.spare_)
+        , spare_count_(rhs.spare_count_)
     {
         rhs.map_ = nullptr;
         rhs.map_size_ = 0;
+        rhs.spare_ = nullptr;
+        rhs.spare_count_ = 0;
     }
 
     deque& operator=(const deque& rhs);
     deque& operator=(deque&& rhs);
 
+    ~deque();
+
 public:
     
     // iterator related
@@ -264,6 +614,15 @@ public:
         return end_;
     }
 
+    // the elements as one contiguous span per buffer
+    segmented_span<T, BufSize> segments() noexcept {
+        return segmented_span<T, BufSize>(begin(), end());
+    }
+
+    segmented_span<const T, BufSize> segments() const noexcept {
+        return segmented_span<const T, BufSize>(begin(), end());
+    }
+
     // capacity
     bool empty() const noexcept {
         return begin() == end();
@@ -275,6 +634,7 @@ public:
         return static_cast<size_type>(-1);
     }
     void shrink_to_fit() noexcept;
+    deque_memory_usage memory_usage() const noexcept;
 
     // visit
     reference operator[](size_type n) {
@@ -341,6 +701,21 @@ public:
         insert_dispatch(position, first, last, iterator_category(first));
     }
 
+    // bulk append / prepend
+    template <class IIter, typename std::enable_if<
+                wstl::is_input_iterator<IIter>::value, int>::type = 0>
+    void append_range(IIter first, IIter last) {
+        append_aux(first, last, iterator_category(first));
+    }
+
+    template <class IIter, typename std::enable_if<
+                wstl::is_input_iterator<IIter>::value, int>::type = 0>
+    void prepend_range(IIter first, IIter last) {
+        prepend_aux(first, last, iterator_category(first));
+    }
+
+    void resize_for_overwrite(size_type n);
+
     // clear / erase
     iterator erase(iterator position);
     iterator erase(iterator first, iterator last);
@@ -356,6 +731,9 @@ private:
     map_pointer create_map(size_type size);
     void create_buffer(map_pointer nstart, map_pointer nfinish);
     void destroy_buffer(map_pointer nstart, map_pointer nfinish);
+    void release_spare() noexcept;
+    void compact_map() noexcept;
+    void release_storage() noexcept;
 
     // initialize
     void map_init(size_type nElem);
@@ -371,6 +749,7 @@ private:
     void require_capacity(size_type n, bool front);
     void reallocate_map_at_front(size_type need);
     void reallocate_map_at_back(size_type need);
+    void recenter_map(map_pointer nstart);
 
     // insert
     template <class... Args>
@@ -382,12 +761,26 @@ private:
     void insert_dispatch(iterator, IIter, IIter, input_iterator_tag);
     template <class FIter>
     void insert_dispatch(iterator, FIter, FIter, forward_iterator_tag);
+
+    // append / prepend
+    template <class FIter>
+    iterator segment_copy(FIter first, size_type n, iterator result);
+    template <class IIter>
+    void append_aux(IIter, IIter, input_iterator_tag);
+    template <class FIter>
+    void append_aux(FIter, FIter, forward_iterator_tag);
+    template <class IIter>
+    void prepend_aux(IIter, IIter, input_iterator_tag);
+    template <class FIter>
+    void prepend_aux(FIter, FIter, forward_iterator_tag);
+    void default_init(iterator, iterator, std::true_type) {}
+    void default_init(iterator first, iterator last, std::false_type);
 };
 
 /************* construct fonction */
 
-template <class T>
-deque<T>& deque<T>::operator=(const deque& rhs)
+template <class T, size_t BufSize>
+deque<T, BufSize>& deque<T, BufSize>::operator=(const deque& rhs)
 {
     if(this != &rhs) {
         const auto len = size();
@@ -403,23 +796,35 @@ deque<T>& deque<T>::operator=(const deque& rhs)
     return *this;
 }
 
-template <class T>
-deque<T>& deque<T>::operator=(deque&& rhs)
+template <class T, size_t BufSize>
+deque<T, BufSize>& deque<T, BufSize>::operator=(deque&& rhs)
 {
-    clear();
-    begin_ = wstl::move(rhs.begin_);
-    end_ = wstl::move(rhs.end_);
-    map_ = rhs.map_;
-    map_size_ = rhs.map_size_;
-    rhs.map_ = nullptr;
-    rhs.map_size_ = 0;
+    if(this != &rhs) {
+        release_storage();
+        begin_ = wstl::move(rhs.begin_);
+        end_ = wstl::move(rhs.end_);
+        map_ = rhs.map_;
+        map_size_ = rhs.map_size_;
+        spare_ = rhs.spare_;
+        spare_count_ = rhs.spare_count_;
+        rhs.map_ = nullptr;
+        rhs.map_size_ = 0;
+        rhs.spare_ = nullptr;
+        rhs.spare_count_ = 0;
+    }
     return *this;
 }
 
+template <class T, size_t BufSize>
+deque<T, BufSize>::~deque()
+{
+    release_storage();
+}
+
 /** implementation of private member functions start */
 
-template <class T>
-typename deque<T>::map_pointer deque<T>::create_map(size_type size)
+template <class T, size_t BufSize>
+typename deque<T, BufSize>::map_pointer deque<T, BufSize>::create_map(size_type size)
 {
     map_pointer mp = nullptr;
     mp = map_allocator::allocate(size);
@@ -429,41 +834,135 @@ typename deque<T>::map_pointer deque<T>::create_map(size_type size)
     return mp;
 }
 
-template <class T>
-void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::create_buffer(map_pointer nstart, map_pointer nfinish)
 {
     map_pointer cur = nullptr;
     try
     {
         for(cur = nstart; cur <= nfinish; ++cur) {
-            *cur = data_allocator::allocate(buffer_size);
+            if(*cur != nullptr) {
+                continue;   // left behind by erase(), still allocated
+            }
+            if(spare_ != nullptr) {
+                *cur = spare_;
+                spare_ = *reinterpret_cast<pointer*>(spare_);
+                --spare_count_;
+            }
+            else {
+                *cur = data_allocator::allocate(buffer_alloc);
+            }
         }
     }
     catch(...)
     {
-        while (cur != nstart)
-        {
-            --cur;
-            data_allocator::deallocate(*cur, buffer_size);
-            *cur = nullptr;
-        }
+        destroy_buffer(nstart, cur - 1);
         throw;
     }
     
 }
 
-template <class T>
-void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
+/**
+ * @brief hand the buffers back, up to DEQUE_SPARE_BUFFERS of them are kept
+ *        for the next create_buffer() so a deque that keeps crossing a buffer
+ *        boundary does not go back to the allocator every time
+ */
+template <class T, size_t BufSize>
+void deque<T, BufSize>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
 {
     for(map_pointer n = nstart; n <= nfinish; ++n) {
-        data_allocator::deallocate(*n, buffer_size);
+        if(nullptr == *n) {
+            continue;
+        }
+        if(spare_count_ < DEQUE_SPARE_BUFFERS) {
+            ::new(static_cast<void*>(*n)) pointer(spare_);
+            spare_ = *n;
+            ++spare_count_;
+        }
+        else {
+            data_allocator::deallocate(*n, buffer_alloc);
+        }
         *n = nullptr;
     }
 }
 
-template <class T>
-void deque<T>::map_init(size_type nElem)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::release_spare() noexcept
+{
+    while (spare_ != nullptr)
+    {
+        pointer next = *reinterpret_cast<pointer*>(spare_);
+        data_allocator::deallocate(spare_, buffer_alloc);
+        spare_ = next;
+    }
+    spare_count_ = 0;
+}
+
+/**
+ * @brief move the live node pointers into a map of max(DEQUE_MAP_INIT_SIZE, nodes + 2)
+ *        slots, the slots outside [begin_, end_] must already be empty
+ * @note the deque keeps its old map if the new one cannot be allocated
+ */
+template <class T, size_t BufSize>
+void deque<T, BufSize>::compact_map() noexcept
+{
+    if(nullptr == map_) {
+        return;
+    }
+    const size_type nodes = end_.node - begin_.node + 1;
+    const size_type new_map_size = wstl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nodes + 2);
+    if(new_map_size >= map_size_) {
+        return;
+    }
+
+    map_pointer new_map = nullptr;
+    try
+    {
+        new_map = create_map(new_map_size);
+    }
+    catch(...)
+    {
+        return;
+    }
+    const difference_type begin_offset = begin_.cur - begin_.first;
+    const difference_type end_offset = end_.cur - end_.first;
+    map_pointer nstart = new_map + (new_map_size - nodes) / 2;
+    wstl::copy(begin_.node, end_.node + 1, nstart);
+
+    map_allocator::deallocate(map_, map_size_);
+    map_ = new_map;
+    map_size_ = new_map_size;
+    begin_ = iterator(*nstart + begin_offset, nstart);
+    end_ = iterator(*(nstart + nodes - 1) + end_offset, nstart + nodes - 1);
+}
+
+/**
+ * @brief destroy every element and free all memory, the deque is left without a map
+ * @note does not go through clear(), whose shrink_to_fit() would allocate a compacted map
+ */
+template <class T, size_t BufSize>
+void deque<T, BufSize>::release_storage() noexcept
+{
+    if(nullptr == map_) {
+        return;
+    }
+    wstl::destroy(begin_, end_);
+    release_spare();
+    for(map_pointer cur = map_; cur < map_ + map_size_; ++cur) {
+        data_allocator::deallocate(*cur, buffer_alloc);
+    }
+    map_allocator::deallocate(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+    begin_ = iterator();
+    end_ = iterator();
+}
+
+template <class T, size_t BufSize>
+void deque<T, BufSize>::map_init(size_type nElem)
 {
+    spare_ = nullptr;
+    spare_count_ = 0;
     const size_type nNode = nElem / buffer_size + 1;
     map_size_ = wstl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nNode+2);
     try
@@ -497,8 +996,8 @@ void deque<T>::map_init(size_type nElem)
     end_.cur = end_.first + (nElem % buffer_size);
 }
 
-template <class T>
-void deque<T>::fill_init(size_type n, const value_type& value)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::fill_init(size_type n, const value_type& value)
 {
     map_init(n);
     if(0 != n) {
@@ -509,9 +1008,9 @@ void deque<T>::fill_init(size_type n, const value_type& value)
     }
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class IIter>
-void deque<T>::copy_init(IIter first, IIter last, input_iterator_tag)
+void deque<T, BufSize>::copy_init(IIter first, IIter last, input_iterator_tag)
 {
     const size_type n = wstl::distance(first, last);
     map_init(n);
@@ -520,9 +1019,9 @@ void deque<T>::copy_init(IIter first, IIter last, input_iterator_tag)
     }
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class IIter>
-void deque<T>::copy_init(IIter first, IIter last, forward_iterator_tag)
+void deque<T, BufSize>::copy_init(IIter first, IIter last, forward_iterator_tag)
 {
     const size_type n = wstl::distance(first, last);
     map_init(n);
@@ -535,18 +1034,34 @@ void deque<T>::copy_init(IIter first, IIter last, forward_iterator_tag)
     wstl::uninitialized_copy(first, last, end_.first);
 }
 
-template <class T>
-void deque<T>::reallocate_map_at_front(size_type need_buffer)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::reallocate_map_at_front(size_type need_buffer)
 {
-    const size_type new_map_size = wstl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
-    map_pointer new_map = create_map(new_map_size);
     const size_type old_buffer = end_.node - begin_.node + 1;
     const size_type new_buffer = old_buffer + need_buffer;
+    destroy_buffer(map_, begin_.node - 1);
+    destroy_buffer(end_.node + 1, map_ + map_size_ - 1);
+
+    if(map_size_ > 2 * new_buffer) {
+        recenter_map(map_ + (map_size_ - new_buffer) / 2 + need_buffer);
+        create_buffer(begin_.node - need_buffer, begin_.node - 1);
+        return;
+    }
 
+    const size_type new_map_size = wstl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
+    map_pointer new_map = create_map(new_map_size);
     auto begin = new_map + (new_map_size - new_buffer) / 2;
     auto mid = begin + need_buffer;
-    auto end = mid + need_buffer;
-    create_buffer(begin, mid-1);
+    auto end = mid + old_buffer;
+    try
+    {
+        create_buffer(begin, mid-1);
+    }
+    catch(...)
+    {
+        map_allocator::deallocate(new_map, new_map_size);
+        throw;
+    }
 
     for(auto begin1 = mid, begin2 = begin_.node; begin1 != end; ++begin1, ++begin2) {
         *begin1 = *begin2;
@@ -559,22 +1074,38 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer)
     end_ = iterator(*(end - 1) + (end_.cur - end_.first), end - 1);
 }
 
-template <class T>
-void deque<T>::reallocate_map_at_back(size_type need_buffer)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::reallocate_map_at_back(size_type need_buffer)
 {
-    const size_type new_map_size = wstl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
-    map_pointer new_map = create_map(new_map_size);
     const size_type old_buffer = end_.node - begin_.node + 1;
     const size_type new_buffer = old_buffer + need_buffer;
+    destroy_buffer(map_, begin_.node - 1);
+    destroy_buffer(end_.node + 1, map_ + map_size_ - 1);
 
+    if(map_size_ > 2 * new_buffer) {
+        recenter_map(map_ + (map_size_ - new_buffer) / 2);
+        create_buffer(end_.node + 1, end_.node + need_buffer);
+        return;
+    }
+
+    const size_type new_map_size = wstl::max(map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
+    map_pointer new_map = create_map(new_map_size);
     auto begin = new_map + ((new_map_size - new_buffer) / 2);
     auto mid = begin + old_buffer;
     auto end = mid + need_buffer;
+    try
+    {
+        create_buffer(mid, end-1);
+    }
+    catch(...)
+    {
+        map_allocator::deallocate(new_map, new_map_size);
+        throw;
+    }
 
     for(auto begin1 = begin, begin2 = begin_.node; begin1 != mid; ++begin1, ++begin2){
         *begin1 = *begin2;
     }
-    create_buffer(mid, end-1);
 
     map_allocator::deallocate(map_, map_size_);
     map_ = new_map;
@@ -583,8 +1114,36 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer)
     end_ = iterator(*(mid - 1) + (end_.cur - end_.first), mid - 1);
 }
 
-template <class T>
-void deque<T>::require_capacity(size_type n, bool front)
+/**
+ * @brief move the node pointers of [begin_, end_] inside the current map so the
+ *        first one lands on nstart, used when the map still has enough room and
+ *        only one end is exhausted (a deque used as a FIFO keeps drifting to the back)
+ * @note the slots outside the live range must already be empty
+ */
+template <class T, size_t BufSize>
+void deque<T, BufSize>::recenter_map(map_pointer nstart)
+{
+    const size_type old_buffer = end_.node - begin_.node + 1;
+    const difference_type begin_offset = begin_.cur - begin_.first;
+    const difference_type end_offset = end_.cur - end_.first;
+    if(nstart < begin_.node) {
+        wstl::copy(begin_.node, end_.node + 1, nstart);
+    }
+    else {
+        wstl::copy_backward(begin_.node, end_.node + 1, nstart + old_buffer);
+    }
+    for(map_pointer cur = map_; cur < nstart; ++cur) {
+        *cur = nullptr;
+    }
+    for(map_pointer cur = nstart + old_buffer; cur < map_ + map_size_; ++cur) {
+        *cur = nullptr;
+    }
+    begin_ = iterator(*nstart + begin_offset, nstart);
+    end_ = iterator(*(nstart + old_buffer - 1) + end_offset, nstart + old_buffer - 1);
+}
+
+template <class T, size_t BufSize>
+void deque<T, BufSize>::require_capacity(size_type n, bool front)
 {
     if(front && (static_cast<size_type>(begin_.cur - begin_.first) < n)) {
         const size_type need_buffer = (n - (begin_.cur - begin_.first)) / buffer_size + 1;
@@ -596,7 +1155,7 @@ void deque<T>::require_capacity(size_type n, bool front)
     }
     else if (!front && (static_cast<size_type>(end_.last - end_.cur - 1) < n)) {
         const size_type need_buffer = (n - (end_.last - end_.cur - 1)) / buffer_size + 1;
-        if(need_buffer > static_cast<size_type>((map_ + map_size_) - end_.node)) {
+        if(need_buffer > static_cast<size_type>((map_ + map_size_) - end_.node - 1)) {
             reallocate_map_at_back(need_buffer);
             return;
         }
@@ -604,8 +1163,8 @@ void deque<T>::require_capacity(size_type n, bool front)
     }
 }
 
-template <class T>
-typename deque<T>::iterator deque<T>::insert(iterator position, const value_type& value)
+template <class T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::insert(iterator position, const value_type& value)
 {
     LOGD("insert(iterator, const value_type&)");
     if(position.cur == begin_.cur) {
@@ -623,8 +1182,8 @@ typename deque<T>::iterator deque<T>::insert(iterator position, const value_type
     }
 }
 
-template <class T>
-void deque<T>::insert(iterator position, size_type n, const value_type& value)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::insert(iterator position, size_type n, const value_type& value)
 {
     LOGD("insert(iterator,n,value)");
     if(position.cur == begin_.cur) {
@@ -644,8 +1203,8 @@ void deque<T>::insert(iterator position, size_type n, const value_type& value)
     }
 }
 
-template <class T>
-typename deque<T>::iterator deque<T>::insert(iterator position, value_type&& value)
+template <class T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::insert(iterator position, value_type&& value)
 {
     LOGD("insert(iterator, value_type&&)");
     if(position.cur == begin_.cur) {
@@ -663,8 +1222,8 @@ typename deque<T>::iterator deque<T>::insert(iterator position, value_type&& val
     }
 }
 
-template <class T>
-void deque<T>::fill_insert(iterator position, size_type n, const value_type& value)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::fill_insert(iterator position, size_type n, const value_type& value)
 {
     const size_type elems_before = position - begin_;
     const size_type len = size();
@@ -728,9 +1287,9 @@ void deque<T>::fill_insert(iterator position, size_type n, const value_type& val
     }
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class... Args>
-typename deque<T>::iterator deque<T>::insert_aux(iterator position, Args&& ...args)
+typename deque<T, BufSize>::iterator deque<T, BufSize>::insert_aux(iterator position, Args&& ...args)
 {
     const size_type elems_before = position - begin_;
     value_type value_copy = value_type(wstl::forward<Args>(args)...);
@@ -758,9 +1317,9 @@ typename deque<T>::iterator deque<T>::insert_aux(iterator position, Args&& ...ar
     return position;
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class FIter>
-void deque<T>::copy_insert(iterator position, FIter first, FIter last, size_type n)
+void deque<T, BufSize>::copy_insert(iterator position, FIter first, FIter last, size_type n)
 {
     const size_type elems_before = position - begin_;
     auto len = size();
@@ -828,9 +1387,9 @@ void deque<T>::copy_insert(iterator position, FIter first, FIter last, size_type
     }
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class IIter>
-void deque<T>::insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
+void deque<T, BufSize>::insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
 {
     if(last <= first) return;
     const size_type n = wstl::distance(first, last);
@@ -849,9 +1408,9 @@ void deque<T>::insert_dispatch(iterator position, IIter first, IIter last, input
     }
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class FIter>
-void deque<T>::insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag)
+void deque<T, BufSize>::insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag)
 {
     if(last <= first) return;
     const size_type n = wstl::distance(first, last);
@@ -891,26 +1450,187 @@ void deque<T>::insert_dispatch(iterator position, FIter first, FIter last, forwa
     }
 }
 
+/**
+ * @brief construct n elements from first at result, one whole buffer per
+ *        uninitialized_copy, so any forward iterator gets the pointer fast path
+ */
+template <class T, size_t BufSize>
+template <class FIter>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::segment_copy(FIter first, size_type n, iterator result)
+{
+    iterator cur = result;
+    try
+    {
+        while (n > 0)
+        {
+            const size_type len = wstl::min(n, static_cast<size_type>(cur.last - cur.cur));
+            auto next = first;
+            wstl::advance(next, len);
+            wstl::uninitialized_copy(first, next, cur.cur);
+            first = next;
+            cur += len;
+            n -= len;
+        }
+    }
+    catch(...)
+    {
+        wstl::destroy(result, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <class T, size_t BufSize>
+template <class IIter>
+void deque<T, BufSize>::append_aux(IIter first, IIter last, input_iterator_tag)
+{
+    for(; first != last; ++first) {
+        emplace_back(*first);
+    }
+}
+
+template <class T, size_t BufSize>
+template <class FIter>
+void deque<T, BufSize>::append_aux(FIter first, FIter last, forward_iterator_tag)
+{
+    const size_type n = wstl::distance(first, last);
+    if(0 == n) return;
+    require_capacity(n, false);
+    auto new_end = end_ + n;
+    try
+    {
+        segment_copy(first, n, end_);
+    }
+    catch(...)
+    {
+        if(new_end.node != end_.node) {
+            destroy_buffer(end_.node + 1, new_end.node);
+        }
+        throw;
+    }
+    end_ = new_end;
+}
+
+template <class T, size_t BufSize>
+template <class IIter>
+void deque<T, BufSize>::prepend_aux(IIter first, IIter last, input_iterator_tag)
+{
+    // the length is unknown until the end, stage the elements first
+    deque tmp(first, last);
+    prepend_aux(tmp.begin(), tmp.end(), forward_iterator_tag());
+}
+
+template <class T, size_t BufSize>
+template <class FIter>
+void deque<T, BufSize>::prepend_aux(FIter first, FIter last, forward_iterator_tag)
+{
+    const size_type n = wstl::distance(first, last);
+    if(0 == n) return;
+    require_capacity(n, true);
+    auto new_begin = begin_ - n;
+    try
+    {
+        segment_copy(first, n, new_begin);
+    }
+    catch(...)
+    {
+        if(new_begin.node != begin_.node) {
+            destroy_buffer(new_begin.node, begin_.node - 1);
+        }
+        throw;
+    }
+    begin_ = new_begin;
+}
+
+template <class T, size_t BufSize>
+void deque<T, BufSize>::default_init(iterator first, iterator last, std::false_type)
+{
+    iterator cur = first;
+    try
+    {
+        for(; cur != last; ++cur) {
+            ::new(static_cast<void*>(cur.cur)) value_type;
+        }
+    }
+    catch(...)
+    {
+        wstl::destroy(first, cur);
+        throw;
+    }
+}
+
 /** implementation of private member functions end */
 
 
 /****** implementation of public member functions start ********* */
 
-template <class T>
-void deque<T>::shrink_to_fit() noexcept
+/**
+ * @brief free the buffers outside [begin_, end_] and the spare buffers kept for
+ *        reuse, then move the node pointers into a map sized for the live range
+ */
+template <class T, size_t BufSize>
+void deque<T, BufSize>::shrink_to_fit() noexcept
 {
     for(auto cur = map_; cur < begin_.node; ++cur) {
-        data_allocator::deallocate(*cur, buffer_size);
+        data_allocator::deallocate(*cur, buffer_alloc);
         *cur = nullptr;
     }
     for(auto cur = end_.node + 1; cur < map_ + map_size_; ++cur) {
-        data_allocator::deallocate(*cur, buffer_size);
+        data_allocator::deallocate(*cur, buffer_alloc);
         *cur = nullptr;
     }
+    release_spare();
+    compact_map();
+}
+
+template <class T, size_t BufSize>
+deque_memory_usage deque<T, BufSize>::memory_usage() const noexcept
+{
+    deque_memory_usage usage;
+    usage.buffers = 0;
+    for(map_pointer cur = map_; cur < map_ + map_size_; ++cur) {
+        if(*cur != nullptr) {
+            ++usage.buffers;
+        }
+    }
+    usage.spare_buffers = spare_count_;
+    usage.map_slots = map_size_;
+    usage.live_bytes = size() * sizeof(value_type);
+    usage.reserved_bytes = (usage.buffers + usage.spare_buffers) * buffer_alloc * sizeof(value_type)
+                         + map_size_ * sizeof(pointer);
+    return usage;
+}
+
+/**
+ * @brief resize to n elements, new elements at the back are default-initialized,
+ *        so trivial types are left as they are for the caller to overwrite
+ */
+template <class T, size_t BufSize>
+void deque<T, BufSize>::resize_for_overwrite(size_type n)
+{
+    const size_type len = size();
+    if(n <= len) {
+        erase(begin_ + n, end_);
+        return;
+    }
+    require_capacity(n - len, false);
+    auto new_end = end_ + (n - len);
+    try
+    {
+        default_init(end_, new_end, std::is_trivially_default_constructible<value_type>());
+    }
+    catch(...)
+    {
+        if(new_end.node != end_.node) {
+            destroy_buffer(end_.node + 1, new_end.node);
+        }
+        throw;
+    }
+    end_ = new_end;
 }
 
-template <class T>
-void deque<T>::push_front(const value_type& value)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::push_front(const value_type& value)
 {
     if(begin_.cur != begin_.first) {
         data_allocator::construct(begin_.cur - 1, value);
@@ -932,8 +1652,8 @@ void deque<T>::push_front(const value_type& value)
     }
 }
 
-template <class T>
-void deque<T>::push_back(const value_type& value)
+template <class T, size_t BufSize>
+void deque<T, BufSize>::push_back(const value_type& value)
 {
     if(end_.cur != end_.last - 1) {
         data_allocator::construct(end_.cur, value);
@@ -946,8 +1666,8 @@ void deque<T>::push_back(const value_type& value)
     }
 }
 
-template <class T>
-void deque<T>::pop_back()
+template <class T, size_t BufSize>
+void deque<T, BufSize>::pop_back()
 {
     WSTL_DEBUG(!empty());
     if(end_.cur != end_.first) {
@@ -961,8 +1681,8 @@ void deque<T>::pop_back()
     }
 }
 
-template <class T>
-void deque<T>::pop_front()
+template <class T, size_t BufSize>
+void deque<T, BufSize>::pop_front()
 {
     WSTL_DEBUG(!empty());
     if(begin_.cur != begin_.last - 1) {
@@ -976,8 +1696,8 @@ void deque<T>::pop_front()
     }
 }
 
-template <class T>
-typename deque<T>::iterator deque<T>::erase(iterator position)
+template <class T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::erase(iterator position)
 {
     auto next = position;
     ++next;
@@ -993,8 +1713,8 @@ typename deque<T>::iterator deque<T>::erase(iterator position)
     return begin_ + elems_before;
 }
 
-template <class T>
-typename deque<T>::iterator deque<T>::erase(iterator first, iterator last)
+template <class T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::erase(iterator first, iterator last)
 {
     if(first == begin_ && last == end_) {
         clear();
@@ -1006,21 +1726,21 @@ typename deque<T>::iterator deque<T>::erase(iterator first, iterator last)
         if(elems_before < ((size() - len) / 2)) {
             wstl::copy_backward(begin_, first, last);
             auto new_begin = begin_ + len;
-            data_allocator::destroy(begin_.cur, new_begin.cur);
+            wstl::destroy(begin_, new_begin);
             begin_ = new_begin;
         }
         else {
             wstl::copy(last, end_, first);
             auto new_end = end_ - len;
-            data_allocator::destroy(new_end.cur, end_.cur);
+            wstl::destroy(new_end, end_);
             end_ = new_end;
         }
         return begin_ + elems_before;
     }
 }
 
-template <class T>
-void deque<T>::clear()
+template <class T, size_t BufSize>
+void deque<T, BufSize>::clear()
 {
     for(map_pointer cur = begin_.node + 1; cur < end_.node; ++cur) {
         data_allocator::destroy(*cur, *cur+buffer_size);
@@ -1032,13 +1752,13 @@ void deque<T>::clear()
     else {
         wstl::destroy(begin_.cur, end_.cur);
     }
-    shrink_to_fit();
     end_ = begin_;
+    shrink_to_fit();
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class ...Args>
-void deque<T>::emplace_front(Args&& ...args)
+void deque<T, BufSize>::emplace_front(Args&& ...args)
 {
     if(begin_.cur != begin_.first) {
         data_allocator::construct(begin_.cur - 1, wstl::forward<Args>(args)...);
@@ -1059,9 +1779,9 @@ void deque<T>::emplace_front(Args&& ...args)
     }
 }
 
-template <class T>
+template <class T, size_t BufSize>
 template <class ...Args>
-void deque<T>::emplace_back(Args&& ...args)
+void deque<T, BufSize>::emplace_back(Args&& ...args)
 {
     if(end_.cur != end_.last - 1) {
         data_allocator::construct(end_.cur, wstl::forward<Args>(args)...);
@@ -1074,8 +1794,8 @@ void deque<T>::emplace_back(Args&& ...args)
     }
 }
 
-template <class T>
-void deque<T>::swap(deque& rhs) noexcept
+template <class T, size_t BufSize>
+void deque<T, BufSize>::swap(deque& rhs) noexcept
 {
     if(this != &rhs)
     {
@@ -1083,23 +1803,25 @@ void deque<T>::swap(deque& rhs) noexcept
         wstl::swap(end_, rhs.end_);
         wstl::swap(map_, rhs.map_);
         wstl::swap(map_size_, rhs.map_size_);
+        wstl::swap(spare_, rhs.spare_);
+        wstl::swap(spare_count_, rhs.spare_count_);
     }
 }
 
-template <class T>
-void swap(deque<T>& lhs, deque<T>& rhs)
+template <class T, size_t BufSize>
+void swap(deque<T, BufSize>& lhs, deque<T, BufSize>& rhs)
 {
     lhs.swap(rhs);
 }
 
-template <class T>
-bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, size_t BufSize>
+bool operator==(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
 {
     return lhs.size() == rhs.size() && wstl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, size_t BufSize>
+bool operator<(const deque<T, BufSize>& lhs, const deque<T, BufSize>& rhs)
 {
     return wstl::lexicographical_compare(lhs.begin(), lhs.end(),
                 rhs.begin(), rhs.end());
@@ -2,7 +2,9 @@
 #define EXCEPDEF_HPP__
 
 #include <stdexcept>
+#include <system_error>
 #include <cassert>
+#include <cerrno>
 
 namespace wstl
 {
@@ -19,6 +21,10 @@ namespace wstl
 #define THROW_RUNTIME_ERROR_IF(expr, what)  \
     if((expr)) throw std::runtime_error(what)
 
+// for failed system calls, carries errno
+#define THROW_SYSTEM_ERROR_IF(expr, what)   \
+    if((expr)) throw std::system_error(errno, std::generic_category(), what)
+
 }
 
 #endif
\ No newline at end of file
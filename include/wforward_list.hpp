@@ -0,0 +1,738 @@
+#ifndef WFORWARD_LIST_HPP__
+#define WFORWARD_LIST_HPP__
+
+#include "witerator.hpp"
+#include "wmemory.hpp"
+#include "utils.hpp"
+#include "walgorithm.hpp"
+#include "functional.hpp"
+
+#include <initializer_list>
+#include <type_traits>
+
+namespace wstl
+{
+
+struct forward_list_node_base
+{
+    typedef forward_list_node_base*     base_ptr;
+
+    base_ptr next;
+};
+
+template <class T>
+struct forward_list_node : public forward_list_node_base
+{
+    T value;
+};
+
+template <class T, class Ref, class Ptr>
+struct forward_list_iterator : public wstl::iterator<wstl::forward_iterator_tag, T>
+{
+    typedef T                                           value_type;
+    typedef Ptr                                         pointer;
+    typedef Ref                                         reference;
+    typedef forward_list_node_base*                     base_ptr;
+    typedef forward_list_node<T>*                       node_ptr;
+    typedef forward_list_iterator<T, T&, T*>            iterator;
+    typedef forward_list_iterator                       self;
+
+    base_ptr node_;
+
+    forward_list_iterator() noexcept : node_(nullptr) {}
+    explicit forward_list_iterator(base_ptr p) noexcept : node_(p) {}
+
+    // iterator -> const_iterator, a template so the implicit copy operations stay
+    template <class R, class P, typename std::enable_if<
+        std::is_same<forward_list_iterator<T, R, P>, iterator>::value, int>::type = 0>
+    forward_list_iterator(const forward_list_iterator<T, R, P>& rhs) noexcept : node_(rhs.node_) {}
+
+    reference operator*() const {
+        return static_cast<node_ptr>(node_)->value;
+    }
+
+    pointer operator->() const {
+        return &(operator*());
+    }
+
+    self& operator++() {
+        WSTL_DEBUG(node_ != nullptr);
+        node_ = node_->next;
+        return *this;
+    }
+
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const self& rhs) const {
+        return node_ == rhs.node_;
+    }
+    bool operator!=(const self& rhs) const {
+        return node_ != rhs.node_;
+    }
+};
+
+/**
+ * @brief A singly linked list, a node is one pointer plus the value
+ * @note    1. no size counter is kept (like std::forward_list), use wstl::distance
+ *          2. every modifier works on the node after a position, before_begin()
+ *             is the position in front of the first element
+ *          3. nodes come from NodeAlloc<forward_list_node<T>>, pass
+ *             wstl::pool_allocator to serve them from a free list
+ */
+template <class T, template <class> class NodeAlloc = wstl::allocator>
+class forward_list
+{
+public:
+    typedef wstl::allocator<T>                              allocator_type;
+    typedef wstl::allocator<T>                              data_allocator;
+    typedef NodeAlloc<forward_list_node<T>>                 node_allocator;
+
+    typedef typename allocator_type::value_type             value_type;
+    typedef typename allocator_type::size_type              size_type;
+    typedef typename allocator_type::pointer                pointer;
+    typedef typename allocator_type::const_pointer          const_pointer;
+    typedef typename allocator_type::reference              reference;
+    typedef typename allocator_type::const_reference        const_reference;
+    typedef typename allocator_type::difference_type        difference_type;
+
+    typedef forward_list_iterator<T, T&, T*>                iterator;
+    typedef forward_list_iterator<T, const T&, const T*>    const_iterator;
+
+    typedef forward_list_node_base*                         base_ptr;
+    typedef forward_list_node<T>*                           node_ptr;
+
+private:
+    forward_list_node_base head_;       // before_begin, head_.next is the first node
+
+public:
+    forward_list() noexcept {
+        head_.next = nullptr;
+    }
+
+    explicit forward_list(size_type n) {
+        head_.next = nullptr;
+        fill_init(n, value_type());
+    }
+
+    forward_list(size_type n, const T& value) {
+        head_.next = nullptr;
+        fill_init(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    forward_list(Iter first, Iter last) {
+        head_.next = nullptr;
+        copy_init(first, last);
+    }
+
+    forward_list(std::initializer_list<T> ilist) {
+        head_.next = nullptr;
+        copy_init(ilist.begin(), ilist.end());
+    }
+
+    forward_list(const forward_list& rhs) {
+        head_.next = nullptr;
+        copy_init(rhs.cbegin(), rhs.cend());
+    }
+
+    forward_list(forward_list&& rhs) noexcept {
+        head_.next = rhs.head_.next;
+        rhs.head_.next = nullptr;
+    }
+
+    forward_list& operator=(const forward_list& rhs) {
+        if(this != &rhs) {
+            assign(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+
+    forward_list& operator=(forward_list&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            head_.next = rhs.head_.next;
+            rhs.head_.next = nullptr;
+        }
+        return *this;
+    }
+
+    forward_list& operator=(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~forward_list() {
+        clear();
+    }
+
+public:
+    // iterator related
+    iterator before_begin() noexcept {
+        return iterator(&head_);
+    }
+
+    const_iterator before_begin() const noexcept {
+        return const_iterator(const_cast<base_ptr>(&head_));
+    }
+
+    const_iterator cbefore_begin() const noexcept {
+        return before_begin();
+    }
+
+    iterator begin() noexcept {
+        return iterator(head_.next);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(head_.next);
+    }
+
+    iterator end() noexcept {
+        return iterator(nullptr);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(nullptr);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return nullptr == head_.next;
+    }
+
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(forward_list_node<T>);
+    }
+
+    // visit
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return *begin();
+    }
+
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return *begin();
+    }
+
+    // assign
+    void assign(size_type n, const value_type& value) {
+        fill_assign(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last) {
+        copy_assign(first, last);
+    }
+
+    void assign(std::initializer_list<T> ilist) {
+        copy_assign(ilist.begin(), ilist.end());
+    }
+
+    // modify
+    template <class ...Args>
+    void emplace_front(Args&& ...args) {
+        link_after(&head_, create_node(wstl::forward<Args>(args)...));
+    }
+
+    void push_front(const value_type& value) {
+        link_after(&head_, create_node(value));
+    }
+
+    void push_front(value_type&& value) {
+        link_after(&head_, create_node(wstl::move(value)));
+    }
+
+    void pop_front() {
+        WSTL_DEBUG(!empty());
+        erase_after(cbefore_begin());
+    }
+
+    template <class ...Args>
+    iterator emplace_after(const_iterator pos, Args&& ...args) {
+        return iterator(link_after(pos.node_, create_node(wstl::forward<Args>(args)...)));
+    }
+
+    iterator insert_after(const_iterator pos, const value_type& value) {
+        return emplace_after(pos, value);
+    }
+
+    iterator insert_after(const_iterator pos, value_type&& value) {
+        return emplace_after(pos, wstl::move(value));
+    }
+
+    iterator insert_after(const_iterator pos, size_type n, const value_type& value);
+
+    template <class Iter, typename std::enable_if<
+        wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert_after(const_iterator pos, Iter first, Iter last);
+
+    iterator insert_after(const_iterator pos, std::initializer_list<T> ilist) {
+        return insert_after(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase_after(const_iterator pos);
+    iterator erase_after(const_iterator first, const_iterator last);
+    void     clear() noexcept {
+        erase_after(cbefore_begin(), cend());
+    }
+
+    void resize(size_type new_size) {
+        resize(new_size, value_type());
+    }
+
+    void resize(size_type new_size, const value_type& value);
+
+    void swap(forward_list& rhs) noexcept {
+        wstl::swap(head_.next, rhs.head_.next);
+    }
+
+    // list operations
+    void splice_after(const_iterator pos, forward_list& x);
+    void splice_after(const_iterator pos, forward_list& x, const_iterator it);
+    void splice_after(const_iterator pos, forward_list& x, const_iterator first, const_iterator last);
+
+    template <class UnaryPredicate>
+    void remove_if(UnaryPredicate pred);
+
+    void remove(const value_type& value) {
+        const value_type copy(value);   // [value] may live in this list and be destroyed
+        remove_if([&](const value_type& v) {
+            return v == copy;
+        });
+    }
+
+    template <class BinaryPredicate>
+    void unique(BinaryPredicate pred);
+
+    void unique() {
+        unique(wstl::equal_to<T>());
+    }
+
+    void merge(forward_list& x) {
+        merge(x, wstl::less<T>());
+    }
+
+    template <class Compare>
+    void merge(forward_list& x, Compare comp);
+
+    void sort() {
+        sort(wstl::less<T>());
+    }
+
+    template <class Compare>
+    void sort(Compare comp);
+
+    void reverse() noexcept;
+
+private:
+    template <class ...Args>
+    node_ptr    create_node(Args&& ...args);
+    void        destroy_node(base_ptr p) noexcept;
+
+    base_ptr link_after(base_ptr pos, base_ptr node) noexcept {
+        node->next = pos->next;
+        pos->next = node;
+        return node;
+    }
+
+    void fill_init(size_type n, const value_type& value);
+    template <class Iter>
+    void copy_init(Iter first, Iter last);
+
+    void fill_assign(size_type n, const value_type& value);
+    template <class Iter>
+    void copy_assign(Iter first, Iter last);
+
+    template <class Compare>
+    static base_ptr merge_nodes(base_ptr a, base_ptr b, Compare& comp);
+};
+
+/*************** private ***************/
+
+template <class T, template <class> class NodeAlloc>
+template <class ...Args>
+typename forward_list<T, NodeAlloc>::node_ptr forward_list<T, NodeAlloc>::create_node(Args&& ...args)
+{
+    node_ptr p = node_allocator::allocate(1);
+    try
+    {
+        data_allocator::construct(wstl::address_of(p->value), wstl::forward<Args>(args)...);
+        p->next = nullptr;
+    }
+    catch(...)
+    {
+        node_allocator::deallocate(p, 1);
+        throw;
+    }
+    return p;
+}
+
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::destroy_node(base_ptr p) noexcept
+{
+    node_ptr n = static_cast<node_ptr>(p);
+    data_allocator::destroy(wstl::address_of(n->value));
+    node_allocator::deallocate(n, 1);
+}
+
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::fill_init(size_type n, const value_type& value)
+{
+    try
+    {
+        insert_after(cbefore_begin(), n, value);
+    }
+    catch(...)
+    {
+        clear();
+        throw;
+    }
+}
+
+template <class T, template <class> class NodeAlloc>
+template <class Iter>
+void forward_list<T, NodeAlloc>::copy_init(Iter first, Iter last)
+{
+    try
+    {
+        insert_after(cbefore_begin(), first, last);
+    }
+    catch(...)
+    {
+        clear();
+        throw;
+    }
+}
+
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::fill_assign(size_type n, const value_type& value)
+{
+    auto prev = before_begin();
+    auto i = begin();
+    auto e = end();
+    for(; i != e && n > 0; ++i, ++prev, --n) {
+        *i = value;
+    }
+    if(n > 0) {
+        insert_after(prev, n, value);
+    }
+    else {
+        erase_after(prev, e);
+    }
+}
+
+template <class T, template <class> class NodeAlloc>
+template <class Iter>
+void forward_list<T, NodeAlloc>::copy_assign(Iter first, Iter last)
+{
+    auto prev = before_begin();
+    auto i = begin();
+    auto e = end();
+    for(; i != e && first != last; ++i, ++prev, ++first) {
+        *i = *first;
+    }
+    if(first != last) {
+        insert_after(prev, first, last);
+    }
+    else {
+        erase_after(prev, e);
+    }
+}
+
+/**
+ * @brief merge two null terminated chains, equal elements of [a] stay in front
+ */
+template <class T, template <class> class NodeAlloc>
+template <class Compare>
+typename forward_list<T, NodeAlloc>::base_ptr
+forward_list<T, NodeAlloc>::merge_nodes(base_ptr a, base_ptr b, Compare& comp)
+{
+    forward_list_node_base head;
+    base_ptr tail = &head;
+    while (a != nullptr && b != nullptr)
+    {
+        if(comp(static_cast<node_ptr>(b)->value, static_cast<node_ptr>(a)->value)) {
+            tail->next = b;
+            b = b->next;
+        }
+        else {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = (a != nullptr) ? a : b;
+    return head.next;
+}
+
+/**************public **************/
+
+template <class T, template <class> class NodeAlloc>
+typename forward_list<T, NodeAlloc>::iterator
+forward_list<T, NodeAlloc>::insert_after(const_iterator pos, size_type n, const value_type& value)
+{
+    base_ptr cur = pos.node_;
+    for(; n > 0; --n) {
+        cur = link_after(cur, create_node(value));
+    }
+    return iterator(cur);
+}
+
+template <class T, template <class> class NodeAlloc>
+template <class Iter, typename std::enable_if<
+    wstl::is_input_iterator<Iter>::value, int>::type>
+typename forward_list<T, NodeAlloc>::iterator
+forward_list<T, NodeAlloc>::insert_after(const_iterator pos, Iter first, Iter last)
+{
+    base_ptr cur = pos.node_;
+    for(; first != last; ++first) {
+        cur = link_after(cur, create_node(*first));
+    }
+    return iterator(cur);
+}
+
+template <class T, template <class> class NodeAlloc>
+typename forward_list<T, NodeAlloc>::iterator forward_list<T, NodeAlloc>::erase_after(const_iterator pos)
+{
+    WSTL_DEBUG(pos.node_ != nullptr && pos.node_->next != nullptr);
+    base_ptr p = pos.node_;
+    base_ptr n = p->next;
+    p->next = n->next;
+    destroy_node(n);
+    return iterator(p->next);
+}
+
+template <class T, template <class> class NodeAlloc>
+typename forward_list<T, NodeAlloc>::iterator
+forward_list<T, NodeAlloc>::erase_after(const_iterator first, const_iterator last)
+{
+    base_ptr p = first.node_;
+    base_ptr cur = p->next;
+    while (cur != last.node_)
+    {
+        base_ptr next = cur->next;
+        destroy_node(cur);
+        cur = next;
+    }
+    p->next = last.node_;
+    return iterator(last.node_);
+}
+
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::resize(size_type new_size, const value_type& value)
+{
+    base_ptr prev = &head_;
+    for(; prev->next != nullptr && new_size > 0; prev = prev->next, --new_size) {
+        ;
+    }
+    if(new_size > 0) {
+        insert_after(const_iterator(prev), new_size, value);
+    }
+    else {
+        erase_after(const_iterator(prev), cend());
+    }
+}
+
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::splice_after(const_iterator pos, forward_list& x)
+{
+    WSTL_DEBUG(this != &x);
+    if(x.empty()) {
+        return;
+    }
+    base_ptr last = x.head_.next;
+    for(; last->next != nullptr; last = last->next) {
+        ;
+    }
+    last->next = pos.node_->next;
+    pos.node_->next = x.head_.next;
+    x.head_.next = nullptr;
+}
+
+/**
+ * @brief move the element after [it] to after [pos]
+ */
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::splice_after(const_iterator pos, forward_list&, const_iterator it)
+{
+    base_ptr n = it.node_->next;
+    if(pos.node_ == it.node_ || pos.node_ == n) {
+        return;
+    }
+    it.node_->next = n->next;
+    n->next = pos.node_->next;
+    pos.node_->next = n;
+}
+
+/**
+ * @brief move the elements of the open range (first, last) to after [pos]
+ */
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::splice_after(const_iterator pos, forward_list&,
+                                              const_iterator first, const_iterator last)
+{
+    base_ptr f = first.node_->next;
+    if(f == last.node_) {
+        return;
+    }
+    base_ptr l = f;
+    for(; l->next != last.node_; l = l->next) {
+        ;
+    }
+    first.node_->next = last.node_;
+    l->next = pos.node_->next;
+    pos.node_->next = f;
+}
+
+template <class T, template <class> class NodeAlloc>
+template <class UnaryPredicate>
+void forward_list<T, NodeAlloc>::remove_if(UnaryPredicate pred)
+{
+    base_ptr prev = &head_;
+    while (prev->next != nullptr)
+    {
+        if(pred(static_cast<node_ptr>(prev->next)->value)) {
+            erase_after(const_iterator(prev));
+        }
+        else {
+            prev = prev->next;
+        }
+    }
+}
+
+template <class T, template <class> class NodeAlloc>
+template <class BinaryPredicate>
+void forward_list<T, NodeAlloc>::unique(BinaryPredicate pred)
+{
+    base_ptr cur = head_.next;
+    if(nullptr == cur) {
+        return;
+    }
+    while (cur->next != nullptr)
+    {
+        if(pred(static_cast<node_ptr>(cur)->value, static_cast<node_ptr>(cur->next)->value)) {
+            erase_after(const_iterator(cur));
+        }
+        else {
+            cur = cur->next;
+        }
+    }
+}
+
+template <class T, template <class> class NodeAlloc>
+template <class Compare>
+void forward_list<T, NodeAlloc>::merge(forward_list& x, Compare comp)
+{
+    if(this == &x) {
+        return;
+    }
+    head_.next = merge_nodes(head_.next, x.head_.next, comp);
+    x.head_.next = nullptr;
+}
+
+/**
+ * @brief bottom-up merge sort, counter[i] holds a sorted run of 2^i nodes
+ */
+template <class T, template <class> class NodeAlloc>
+template <class Compare>
+void forward_list<T, NodeAlloc>::sort(Compare comp)
+{
+    if(nullptr == head_.next || nullptr == head_.next->next) {
+        return;
+    }
+
+    base_ptr counter[64] = {};
+    int fill = 0;
+    base_ptr cur = head_.next;
+    while (cur != nullptr)
+    {
+        base_ptr carry = cur;
+        cur = cur->next;
+        carry->next = nullptr;
+
+        int i = 0;
+        for(; i < fill && counter[i] != nullptr; ++i) {
+            carry = merge_nodes(counter[i], carry, comp);
+            counter[i] = nullptr;
+        }
+        counter[i] = carry;
+        if(i == fill) {
+            ++fill;
+        }
+    }
+
+    base_ptr result = nullptr;
+    for(int i = 0; i < fill; ++i) {
+        if(counter[i] != nullptr) {
+            result = merge_nodes(counter[i], result, comp);
+        }
+    }
+    head_.next = result;
+}
+
+template <class T, template <class> class NodeAlloc>
+void forward_list<T, NodeAlloc>::reverse() noexcept
+{
+    base_ptr prev = nullptr;
+    base_ptr cur = head_.next;
+    while (cur != nullptr)
+    {
+        base_ptr next = cur->next;
+        cur->next = prev;
+        prev = cur;
+        cur = next;
+    }
+    head_.next = prev;
+}
+
+template <class T, template <class> class NodeAlloc>
+bool operator==(const forward_list<T, NodeAlloc>& lhs, const forward_list<T, NodeAlloc>& rhs)
+{
+    auto f1 = lhs.cbegin();
+    auto f2 = rhs.cbegin();
+    auto l1 = lhs.cend();
+    auto l2 = rhs.cend();
+
+    for(; f1 != l1 && f2 != l2 && *f1 == *f2; ++f1, ++f2) {
+        ;
+    }
+
+    return f1 == l1 && f2 == l2;
+}
+
+template <class T, template <class> class NodeAlloc>
+bool operator!=(const forward_list<T, NodeAlloc>& lhs, const forward_list<T, NodeAlloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, template <class> class NodeAlloc>
+bool operator<(const forward_list<T, NodeAlloc>& lhs, const forward_list<T, NodeAlloc>& rhs)
+{
+    return wstl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <class T, template <class> class NodeAlloc>
+void swap(forward_list<T, NodeAlloc>& lhs, forward_list<T, NodeAlloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
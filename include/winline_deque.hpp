@@ -0,0 +1,307 @@
+#ifndef WINLINE_DEQUE_HPP__
+#define WINLINE_DEQUE_HPP__
+
+/**
+ * @file winline_deque.hpp
+ * @brief A double ended queue with its N slots inline, used as a ring
+ */
+
+#include "wcircular_buffer.hpp"
+
+#include <type_traits>
+
+namespace wstl
+{
+
+/**
+ * @brief A fixed-capacity ring deque that never allocates
+ * @note    1. the slots are a member array, push/pop at both ends only
+ *             construct or destroy in place
+ *          2. pushing into a full deque throws std::length_error, unlike an
+ *             overwriting circular_buffer nothing is dropped
+ *          3. iterators are circular_buffer's, as_spans() gives the (at most
+ *             two) contiguous runs in order
+ */
+template <class T, size_t N>
+class inline_deque
+{
+    static_assert(N > 0, "inline_deque needs a capacity");
+
+public:
+    typedef wstl::allocator<T>                          allocator_type;
+    typedef wstl::allocator<T>                          data_allocator;
+    typedef typename allocator_type::value_type         value_type;
+    typedef typename allocator_type::pointer            pointer;
+    typedef typename allocator_type::const_pointer      const_pointer;
+    typedef typename allocator_type::reference          reference;
+    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_type::size_type          size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef circular_buffer_iterator<T, T&, T*>             iterator;
+    typedef circular_buffer_iterator<T, const T&, const T*> const_iterator;
+    typedef wstl::reverse_iterator<iterator>                reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>          const_reverse_iterator;
+
+    typedef span<T>                                     span_type;
+    typedef span<const T>                               const_span_type;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_[N];
+    size_type head_;
+    size_type size_;
+
+public:
+    inline_deque() noexcept : head_(0), size_(0) {}
+
+    inline_deque(size_type n, const value_type& value) : head_(0), size_(0) {
+        THROW_LENGTH_ERROR_IF(n > N, "inline_deque<T, N>'s size too big");
+        wstl::uninitialized_fill_n(slots(), n, value);
+        size_ = n;
+    }
+
+    template <class Iter, typename std::enable_if<
+            wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    inline_deque(Iter first, Iter last) : head_(0), size_(0) {
+        try
+        {
+            for(; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+        catch(...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    inline_deque(std::initializer_list<value_type> _list)
+        : inline_deque(_list.begin(), _list.end()) {}
+
+    inline_deque(const inline_deque& rhs) : inline_deque(rhs.begin(), rhs.end()) {}
+
+    // moves the elements one by one, rhs keeps them in a moved-from state
+    inline_deque(inline_deque&& rhs) : head_(0), size_(0) {
+        auto spans = rhs.as_spans();
+        T* mid = wstl::uninitialized_move(spans.first.begin(), spans.first.end(), slots());
+        try
+        {
+            wstl::uninitialized_move(spans.second.begin(), spans.second.end(), mid);
+        }
+        catch(...)
+        {
+            data_allocator::destroy(slots(), mid);
+            throw;
+        }
+        size_ = rhs.size_;
+    }
+
+    inline_deque& operator=(const inline_deque& rhs) {
+        if(this != &rhs) {
+            clear();
+            for(const auto& v : rhs) {
+                emplace_back(v);
+            }
+        }
+        return *this;
+    }
+
+    inline_deque& operator=(inline_deque&& rhs) {
+        if(this != &rhs) {
+            clear();
+            for(auto& v : rhs) {
+                emplace_back(wstl::move(v));
+            }
+        }
+        return *this;
+    }
+
+    ~inline_deque() {
+        clear();
+    }
+
+public:
+    // iterator
+    iterator begin() noexcept {
+        return iterator(slots(), N, head_, 0);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(const_cast<T*>(slots()), N, head_, 0);
+    }
+    iterator end() noexcept {
+        return begin() + static_cast<difference_type>(size_);
+    }
+    const_iterator end() const noexcept {
+        return begin() + static_cast<difference_type>(size_);
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    bool full() const noexcept {
+        return N == size_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    static constexpr size_type capacity() noexcept {
+        return N;
+    }
+    static constexpr size_type max_size() noexcept {
+        return N;
+    }
+
+    // visit
+    reference operator[](size_type n) {
+        WSTL_DEBUG(n < size_);
+        return slots()[wrap(head_ + n)];
+    }
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return slots()[wrap(head_ + n)];
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "inline_deque<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "inline_deque<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return slots()[head_];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return slots()[head_];
+    }
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return (*this)[size_ - 1];
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return (*this)[size_ - 1];
+    }
+
+    std::pair<span_type, span_type> as_spans() noexcept {
+        const size_type first_len = wstl::min(size_, N - head_);
+        return std::pair<span_type, span_type>(span_type{slots() + head_, first_len},
+                                               span_type{slots(), size_ - first_len});
+    }
+    std::pair<const_span_type, const_span_type> as_spans() const noexcept {
+        const size_type first_len = wstl::min(size_, N - head_);
+        return std::pair<const_span_type, const_span_type>(
+                    const_span_type{slots() + head_, first_len},
+                    const_span_type{slots(), size_ - first_len});
+    }
+
+    // modify
+    template <class... Args>
+    reference emplace_back(Args&& ...args) {
+        THROW_LENGTH_ERROR_IF(full(), "inline_deque<T, N> is full");
+        T* p = slots() + wrap(head_ + size_);
+        data_allocator::construct(p, wstl::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    template <class... Args>
+    reference emplace_front(Args&& ...args) {
+        THROW_LENGTH_ERROR_IF(full(), "inline_deque<T, N> is full");
+        const size_type h = 0 == head_ ? N - 1 : head_ - 1;
+        data_allocator::construct(slots() + h, wstl::forward<Args>(args)...);
+        head_ = h;
+        ++size_;
+        return slots()[h];
+    }
+
+    void push_back(const value_type& value) {
+        emplace_back(value);
+    }
+    void push_back(value_type&& value) {
+        emplace_back(wstl::move(value));
+    }
+    void push_front(const value_type& value) {
+        emplace_front(value);
+    }
+    void push_front(value_type&& value) {
+        emplace_front(wstl::move(value));
+    }
+
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        --size_;
+        data_allocator::destroy(slots() + wrap(head_ + size_));
+    }
+
+    void pop_front() {
+        WSTL_DEBUG(!empty());
+        data_allocator::destroy(slots() + head_);
+        head_ = wrap(head_ + 1);
+        --size_;
+    }
+
+    void clear() noexcept {
+        auto spans = as_spans();
+        data_allocator::destroy(spans.first.begin(), spans.first.end());
+        data_allocator::destroy(spans.second.begin(), spans.second.end());
+        head_ = 0;
+        size_ = 0;
+    }
+
+    void swap(inline_deque& rhs) {
+        inline_deque tmp(wstl::move(rhs));
+        rhs = wstl::move(*this);
+        *this = wstl::move(tmp);
+    }
+
+private:
+    T* slots() noexcept {
+        return reinterpret_cast<T*>(storage_);
+    }
+    const T* slots() const noexcept {
+        return reinterpret_cast<const T*>(storage_);
+    }
+    static size_type wrap(size_type i) noexcept {
+        return i >= N ? i - N : i;
+    }
+};
+
+template <class T, size_t N>
+bool operator==(const inline_deque<T, N>& lhs, const inline_deque<T, N>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        wstl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N>
+bool operator!=(const inline_deque<T, N>& lhs, const inline_deque<T, N>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, size_t N>
+void swap(inline_deque<T, N>& lhs, inline_deque<T, N>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
@@ -0,0 +1,571 @@
+#ifndef WINTRUSIVE_LIST_HPP__
+#define WINTRUSIVE_LIST_HPP__
+
+#include "witerator.hpp"
+#include "utils.hpp"
+#include "walgorithm.hpp"
+#include "functional.hpp"
+
+#include <type_traits>
+
+namespace wstl
+{
+
+struct default_list_tag {};
+
+/**
+ * @brief the prev / next pair of list_node_base, embedded in the user's object
+ * @note    1. an unlinked hook has prev == next == nullptr
+ *          2. copying an object does not copy its links, the copy starts unlinked
+ *          3. one object may sit in several lists at once, one hook per Tag
+ */
+template <class Tag = default_list_tag>
+struct intrusive_list_hook
+{
+    typedef intrusive_list_hook*    hook_ptr;
+
+    hook_ptr prev;
+    hook_ptr next;
+
+    intrusive_list_hook() noexcept : prev(nullptr), next(nullptr) {}
+
+    intrusive_list_hook(const intrusive_list_hook&) noexcept : prev(nullptr), next(nullptr) {}
+
+    intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept {
+        return *this;
+    }
+
+    bool is_linked() const noexcept {
+        return next != nullptr;
+    }
+
+    /**
+     * @brief take the object out of whatever list holds it, O(1)
+     */
+    void unlink() noexcept {
+        if(is_linked()) {
+            prev->next = next;
+            next->prev = prev;
+            prev = next = nullptr;
+        }
+    }
+};
+
+/**
+ * @brief a hook that unlinks itself when the object is destroyed
+ */
+template <class Tag = default_list_tag>
+struct auto_unlink_hook : public intrusive_list_hook<Tag>
+{
+    ~auto_unlink_hook() {
+        this->unlink();
+    }
+};
+
+template <class T, class Tag, class Ref, class Ptr>
+struct intrusive_list_iterator : public wstl::iterator<wstl::bidirectional_iterator_tag, T>
+{
+    typedef T                                                   value_type;
+    typedef Ptr                                                 pointer;
+    typedef Ref                                                 reference;
+    typedef intrusive_list_hook<Tag>*                           hook_ptr;
+    typedef intrusive_list_iterator<T, Tag, T&, T*>             iterator;
+    typedef intrusive_list_iterator                             self;
+
+    hook_ptr node_;
+
+    intrusive_list_iterator() noexcept : node_(nullptr) {}
+    explicit intrusive_list_iterator(hook_ptr p) noexcept : node_(p) {}
+    // iterator -> const_iterator, a template so the implicit copy operations stay
+    template <class R, class P, typename std::enable_if<
+        std::is_same<intrusive_list_iterator<T, Tag, R, P>, iterator>::value, int>::type = 0>
+    intrusive_list_iterator(const intrusive_list_iterator<T, Tag, R, P>& rhs) noexcept : node_(rhs.node_) {}
+
+    reference operator*() const {
+        return *static_cast<Ptr>(node_);
+    }
+
+    pointer operator->() const {
+        return &(operator*());
+    }
+
+    self& operator++() {
+        WSTL_DEBUG(node_ != nullptr);
+        node_ = node_->next;
+        return *this;
+    }
+
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    self& operator--() {
+        WSTL_DEBUG(node_ != nullptr);
+        node_ = node_->prev;
+        return *this;
+    }
+
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    bool operator==(const self& rhs) const {
+        return node_ == rhs.node_;
+    }
+    bool operator!=(const self& rhs) const {
+        return node_ != rhs.node_;
+    }
+};
+
+/**
+ * @brief A doubly linked list over objects that embed an intrusive_list_hook<Tag>
+ * @note    1. the list never allocates, copies or destroys elements, it only links
+ *             them, so the caller keeps them alive while they are linked
+ *          2. T must derive from intrusive_list_hook<Tag> (or auto_unlink_hook<Tag>)
+ *          3. an element can unlink itself without the list, so size() counts
+ *             the nodes, O(n)
+ *          4. clear() and the destructor leave every element unlinked
+ */
+template <class T, class Tag = default_list_tag>
+class intrusive_list
+{
+public:
+    typedef T                                               value_type;
+    typedef T*                                              pointer;
+    typedef const T*                                        const_pointer;
+    typedef T&                                              reference;
+    typedef const T&                                        const_reference;
+    typedef size_t                                          size_type;
+    typedef ptrdiff_t                                       difference_type;
+
+    typedef intrusive_list_hook<Tag>                        hook_type;
+    typedef hook_type*                                      hook_ptr;
+
+    typedef intrusive_list_iterator<T, Tag, T&, T*>             iterator;
+    typedef intrusive_list_iterator<T, Tag, const T&, const T*> const_iterator;
+    typedef wstl::reverse_iterator<iterator>                    reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>              const_reverse_iterator;
+
+private:
+    hook_type   root_;      // sentinel, root_.next is the first element
+
+public:
+    intrusive_list() noexcept {
+        root_.prev = root_.next = &root_;
+    }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    intrusive_list(intrusive_list&& rhs) noexcept {
+        root_.prev = root_.next = &root_;
+        swap(rhs);
+    }
+
+    intrusive_list& operator=(intrusive_list&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    ~intrusive_list() {
+        clear();
+    }
+
+public:
+    // iterator related
+    iterator begin() noexcept {
+        return iterator(root_.next);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(root_.next);
+    }
+
+    iterator end() noexcept {
+        return iterator(&root_);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<hook_ptr>(&root_));
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /**
+     * @brief the iterator of an element that is linked in this list, O(1)
+     */
+    iterator iterator_to(reference value) noexcept {
+        return iterator(as_hook(&value));
+    }
+
+    const_iterator iterator_to(const_reference value) const noexcept {
+        return const_iterator(as_hook(const_cast<pointer>(&value)));
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return root_.next == &root_;
+    }
+
+    size_type size() const noexcept {
+        return static_cast<size_type>(wstl::distance(begin(), end()));
+    }
+
+    // visit
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return *begin();
+    }
+
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return *begin();
+    }
+
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return *(--end());
+    }
+
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return *(--end());
+    }
+
+    // push / pop
+    void push_front(reference value) {
+        link_before(root_.next, as_hook(&value));
+    }
+
+    void push_back(reference value) {
+        link_before(&root_, as_hook(&value));
+    }
+
+    void pop_front() {
+        WSTL_DEBUG(!empty());
+        root_.next->unlink();
+    }
+
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        root_.prev->unlink();
+    }
+
+    // insert / erase
+    iterator insert(const_iterator pos, reference value) {
+        hook_ptr h = as_hook(&value);
+        link_before(pos.node_, h);
+        return iterator(h);
+    }
+
+    iterator erase(const_iterator pos) {
+        WSTL_DEBUG(pos != cend());
+        hook_ptr next = pos.node_->next;
+        pos.node_->unlink();
+        return iterator(next);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last)
+        {
+            first = erase(first);
+        }
+        return iterator(last.node_);
+    }
+
+    void clear() noexcept;
+
+    /**
+     * @brief unlink every element and pass it to disposer, e.g. to return it to a pool
+     */
+    template <class Disposer>
+    void clear_and_dispose(Disposer disposer);
+
+    void swap(intrusive_list& rhs) noexcept;
+
+    // list operation
+    void splice(const_iterator pos, intrusive_list& other);
+    void splice(const_iterator pos, intrusive_list& other, const_iterator it);
+    void splice(const_iterator pos, intrusive_list& other, const_iterator first, const_iterator last);
+
+    template <class UnaryPredicate>
+    void remove_if(UnaryPredicate pred);
+
+    void remove(const value_type& value) {
+        remove_if([&](const value_type& v) {
+            return v == value;
+        });
+    }
+
+    template <class BinaryPredicate>
+    void unique(BinaryPredicate pred);
+
+    void unique() {
+        unique(wstl::equal_to<T>());
+    }
+
+    template <class Compare>
+    void merge(intrusive_list& other, Compare comp);
+
+    void merge(intrusive_list& other) {
+        merge(other, wstl::less<T>());
+    }
+
+    template <class Compare>
+    void sort(Compare comp);
+
+    void sort() {
+        sort(wstl::less<T>());
+    }
+
+    void reverse() noexcept;
+
+private:
+    static hook_ptr as_hook(pointer p) noexcept {
+        return static_cast<hook_ptr>(p);
+    }
+
+    static void link_before(hook_ptr pos, hook_ptr h) noexcept {
+        WSTL_DEBUG(!h->is_linked());
+        h->prev = pos->prev;
+        h->next = pos;
+        pos->prev->next = h;
+        pos->prev = h;
+    }
+
+    // move [first, last] in front of pos
+    static void transfer(hook_ptr pos, hook_ptr first, hook_ptr last) noexcept {
+        first->prev->next = last->next;
+        last->next->prev = first->prev;
+        first->prev = pos->prev;
+        last->next = pos;
+        pos->prev->next = first;
+        pos->prev = last;
+    }
+};
+
+/*************** public ***************/
+
+template <class T, class Tag>
+void intrusive_list<T, Tag>::clear() noexcept
+{
+    hook_ptr cur = root_.next;
+    while (cur != &root_)
+    {
+        hook_ptr next = cur->next;
+        cur->prev = cur->next = nullptr;
+        cur = next;
+    }
+    root_.prev = root_.next = &root_;
+}
+
+template <class T, class Tag>
+template <class Disposer>
+void intrusive_list<T, Tag>::clear_and_dispose(Disposer disposer)
+{
+    while (!empty())
+    {
+        hook_ptr h = root_.next;
+        h->unlink();
+        disposer(static_cast<pointer>(h));
+    }
+}
+
+template <class T, class Tag>
+void intrusive_list<T, Tag>::swap(intrusive_list& rhs) noexcept
+{
+    if(this == &rhs) {
+        return;
+    }
+    wstl::swap(root_.prev, rhs.root_.prev);
+    wstl::swap(root_.next, rhs.root_.next);
+    // the neighbours still point at the other sentinel
+    if(root_.next == &rhs.root_) {
+        root_.prev = root_.next = &root_;
+    }
+    else {
+        root_.next->prev = root_.prev->next = &root_;
+    }
+    if(rhs.root_.next == &root_) {
+        rhs.root_.prev = rhs.root_.next = &rhs.root_;
+    }
+    else {
+        rhs.root_.next->prev = rhs.root_.prev->next = &rhs.root_;
+    }
+}
+
+template <class T, class Tag>
+void intrusive_list<T, Tag>::splice(const_iterator pos, intrusive_list& other)
+{
+    WSTL_DEBUG(this != &other);
+    if(!other.empty()) {
+        transfer(pos.node_, other.root_.next, other.root_.prev);
+    }
+}
+
+template <class T, class Tag>
+void intrusive_list<T, Tag>::splice(const_iterator pos, intrusive_list&, const_iterator it)
+{
+    if(pos.node_ != it.node_ && pos.node_ != it.node_->next) {
+        transfer(pos.node_, it.node_, it.node_);
+    }
+}
+
+template <class T, class Tag>
+void intrusive_list<T, Tag>::splice(const_iterator pos, intrusive_list&,
+                                    const_iterator first, const_iterator last)
+{
+    if(first != last && pos != last) {
+        transfer(pos.node_, first.node_, last.node_->prev);
+    }
+}
+
+template <class T, class Tag>
+template <class UnaryPredicate>
+void intrusive_list<T, Tag>::remove_if(UnaryPredicate pred)
+{
+    auto f = begin();
+    auto l = end();
+    for(auto next = f; f != l; f = next) {
+        ++next;
+        if(pred(*f)) {
+            f.node_->unlink();
+        }
+    }
+}
+
+template <class T, class Tag>
+template <class BinaryPredicate>
+void intrusive_list<T, Tag>::unique(BinaryPredicate pred)
+{
+    if(empty()) {
+        return;
+    }
+    auto i = begin();
+    auto j = i;
+    for(++j; j != end(); j = i, ++j) {
+        if(pred(*i, *j)) {
+            j.node_->unlink();
+        }
+        else {
+            i = j;
+        }
+    }
+}
+
+template <class T, class Tag>
+template <class Compare>
+void intrusive_list<T, Tag>::merge(intrusive_list& other, Compare comp)
+{
+    if(this == &other) return;
+
+    auto f1 = begin();
+    auto l1 = end();
+    auto f2 = other.begin();
+    auto l2 = other.end();
+
+    while (f1 != l1 && f2 != l2)
+    {
+        if(comp(*f2, *f1)) {
+            // move the whole run of other that goes in front of f1
+            auto next = f2;
+            ++next;
+            for(; next != l2 && comp(*next, *f1); ++next) {
+                ;
+            }
+            hook_ptr f = f2.node_;
+            hook_ptr l = next.node_->prev;
+            f2 = next;
+            transfer(f1.node_, f, l);
+        }
+        ++f1;
+    }
+
+    if(f2 != l2) {
+        transfer(l1.node_, f2.node_, l2.node_->prev);
+    }
+}
+
+/**
+ * @brief stable merge sort without allocation: runs of 1, 2, 4 ... elements are
+ *        kept in counter[i] and merged when a run of the same length arrives
+ */
+template <class T, class Tag>
+template <class Compare>
+void intrusive_list<T, Tag>::sort(Compare comp)
+{
+    if(empty() || root_.next->next == &root_) {
+        return;
+    }
+
+    intrusive_list carry;
+    intrusive_list counter[64];
+    int fill = 0;
+    while (!empty())
+    {
+        carry.splice(carry.begin(), *this, begin());
+        int i = 0;
+        while (i < fill && !counter[i].empty())
+        {
+            counter[i].merge(carry, comp);
+            carry.swap(counter[i++]);
+        }
+        carry.swap(counter[i]);
+        if(i == fill) ++fill;
+    }
+
+    for(int i = 1; i < fill; ++i) {
+        counter[i].merge(counter[i - 1], comp);
+    }
+    swap(counter[fill - 1]);
+}
+
+template <class T, class Tag>
+void intrusive_list<T, Tag>::reverse() noexcept
+{
+    hook_ptr cur = &root_;
+    do
+    {
+        wstl::swap(cur->prev, cur->next);
+        cur = cur->prev;
+    } while (cur != &root_);
+}
+
+template <class T, class Tag>
+void swap(intrusive_list<T, Tag>& lhs, intrusive_list<T, Tag>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
@@ -259,6 +259,13 @@ template <class Iter>
 struct is_input_iterator : public has_iterator_cat_of<Iter, input_iterator_tag>
 {};
 
+/**
+ * @brief check if an iterator is a random access iterator
+ */
+template <class Iter>
+struct is_random_access_iterator : public has_iterator_cat_of<Iter, random_access_iterator_tag>
+{};
+
 template <class Iterator>
 typename iterator_traits<Iterator>::value_type*
 value_type(const Iterator&)
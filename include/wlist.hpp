@@ -7,6 +7,11 @@
 #include "walgorithm.hpp"
 #include "functional.hpp"
 
+// number of erased nodes a list keeps for reuse instead of freeing them
+#ifndef LIST_FREE_NODES
+#define LIST_FREE_NODES 64
+#endif
+
 namespace wstl
 {
 
@@ -183,6 +188,81 @@ struct list_const_iterator : public wstl::iterator<wstl::bidirectional_iterator_
     }
 };
 
+/**
+ * @brief owns one node taken out of a list by extract(), insert() puts it back
+ *        into any list<T> without allocating or copying the value
+ * @note a handle that still owns its node destroys it
+ */
+template <class T>
+class list_node_handle
+{
+public:
+    typedef T                                       value_type;
+    typedef typename node_traits<T>::node_ptr       node_ptr;
+    typedef wstl::allocator<T>                      data_allocator;
+    typedef wstl::allocator<list_node<T>>           node_allocator;
+
+    list_node_handle() noexcept : node_(nullptr) {}
+
+    list_node_handle(list_node_handle&& rhs) noexcept : node_(rhs.node_) {
+        rhs.node_ = nullptr;
+    }
+
+    list_node_handle& operator=(list_node_handle&& rhs) noexcept {
+        if(this != &rhs) {
+            reset();
+            node_ = rhs.node_;
+            rhs.node_ = nullptr;
+        }
+        return *this;
+    }
+
+    list_node_handle(const list_node_handle&) = delete;
+    list_node_handle& operator=(const list_node_handle&) = delete;
+
+    ~list_node_handle() {
+        reset();
+    }
+
+    bool empty() const noexcept {
+        return nullptr == node_;
+    }
+
+    explicit operator bool() const noexcept {
+        return nullptr != node_;
+    }
+
+    value_type& value() const {
+        WSTL_DEBUG(!empty());
+        return node_->value;
+    }
+
+    void swap(list_node_handle& rhs) noexcept {
+        wstl::swap(node_, rhs.node_);
+    }
+
+private:
+    template <class U> friend class list;
+
+    explicit list_node_handle(node_ptr p) noexcept : node_(p) {}
+
+    node_ptr release() noexcept {
+        node_ptr p = node_;
+        node_ = nullptr;
+        return p;
+    }
+
+    void reset() noexcept {
+        if(nullptr != node_) {
+            data_allocator::destroy(wstl::address_of(node_->value));
+            node_allocator::deallocate(node_);
+            node_ = nullptr;
+        }
+    }
+
+    node_ptr node_;
+};
+
 template <class T>
 class list
 {
@@ -207,12 +287,16 @@ public:
 
     typedef typename node_traits<T>::base_ptr       base_ptr;
     typedef typename node_traits<T>::node_ptr       node_ptr;
+    typedef list_node_handle<T>                     node_type;
 private:
     base_ptr    node_;
     size_type   size_;
+    base_ptr    free_ = nullptr;        // erased nodes kept for create_node(), chained by next
+    size_type   free_count_ = 0;
 public:
-    list() {
-        fill_init(0, value_type());
+    list() : size_(0) {
+        node_ = base_allocator::allocate(1);
+        node_->unlink();
     }
 
     explicit list(size_type n) {
@@ -262,6 +346,12 @@ public:
         return *this;
     }
 
+    ~list() {
+        clear();
+        release_free_nodes();
+        base_allocator::deallocate(node_);
+    }
+
 public:
     // iterator related
     iterator begin() noexcept {
@@ -345,8 +435,19 @@ public:
     void swap(list& rhs) noexcept {
         wstl::swap(node_, rhs.node_);
         wstl::swap(size_, rhs.size_);
+        wstl::swap(free_, rhs.free_);
+        wstl::swap(free_count_, rhs.free_count_);
     }
 
+    // free the nodes kept for reuse
+    void shrink_to_fit() noexcept {
+        release_free_nodes();
+    }
+
+    // node handles
+    node_type extract(const_iterator pos);
+    iterator  insert(const_iterator pos, node_type&& nh);
+
     // capacity
     bool empty() const noexcept {
         return node_->next == node_;
@@ -356,7 +457,7 @@ public:
         return static_cast<size_type>(-1);
     }
 
-    size_type size() {
+    size_type size() const noexcept {
         return size_;
     }
 
@@ -512,6 +613,7 @@ private:
     template <class ...Args>
     node_ptr    create_node(Args&& ...args);
     void        destroy_node(node_ptr p);
+    void        release_free_nodes() noexcept;
 
     // initialize
     void    fill_init(size_type n, const value_type& value);
@@ -542,11 +644,22 @@ private:
 };
 
 /*************** private ***************/
+/**
+ * @brief a node from the free list if there is one, else a new allocation
+ */
 template <class T>
 template <class ...Args>
 typename list<T>::node_ptr list<T>::create_node(Args&& ...args)
 {
-    node_ptr p = node_allocator::allocate(1);
+    node_ptr p = nullptr;
+    if(nullptr != free_) {
+        p = free_->as_node();
+        free_ = free_->next;
+        --free_count_;
+    }
+    else {
+        p = node_allocator::allocate(1);
+    }
     try
     {
         data_allocator::construct(wstl::address_of(p->value), wstl::forward<Args>(args)...);
@@ -561,11 +674,34 @@ typename list<T>::node_ptr list<T>::create_node(Args&& ...args)
     return p;
 }
 
+/**
+ * @brief destroy the value, up to LIST_FREE_NODES nodes are kept for reuse so
+ *        erase-then-insert patterns do not go back to the allocator
+ */
 template <class T>
 void list<T>::destroy_node(node_ptr p)
 {
     data_allocator::destroy(wstl::address_of(p->value));
-    node_allocator::deallocate(p);
+    if(free_count_ < LIST_FREE_NODES) {
+        p->next = free_;
+        free_ = p->as_base();
+        ++free_count_;
+    }
+    else {
+        node_allocator::deallocate(p);
+    }
+}
+
+template <class T>
+void list<T>::release_free_nodes() noexcept
+{
+    while (nullptr != free_)
+    {
+        base_ptr next = free_->next;
+        node_allocator::deallocate(free_->as_node());
+        free_ = next;
+    }
+    free_count_ = 0;
 }
 
 template <class T>
@@ -585,6 +721,7 @@ void list<T>::fill_init(size_type n, const value_type& value)
     catch(...)
     {
         clear();
+        release_free_nodes();
         base_allocator::deallocate(node_);
         node_ = nullptr;
         throw;
@@ -609,6 +746,7 @@ void list<T>::copy_init(Iter first, Iter last)
     catch(...) 
     {
         clear();
+        release_free_nodes();
         base_allocator::deallocate(node_);
         node_ = nullptr;
         throw;
@@ -724,7 +862,7 @@ template <class T>
 typename list<T>::iterator list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
 {
     if(pos == node_->next) {
-        link_nodes_at_front(link_node);
+        link_nodes_at_front(link_node, link_node);
     }
     else if(pos == node_) {
         link_nodes_at_back(link_node, link_node);
@@ -875,6 +1013,36 @@ typename list<T>::iterator list<T>::erase(const_iterator pos)
     return iterator(next);
 }
 
+/**
+ * @brief unlink the node at [pos] and hand it over, the value stays in place
+ */
+template <class T>
+typename list<T>::node_type list<T>::extract(const_iterator pos)
+{
+    WSTL_DEBUG(pos != cend());
+    auto n = pos.node_;
+    unlink_nodes(n, n);
+    --size_;
+    n->prev = n->next = nullptr;
+    return node_type(n->as_node());
+}
+
+/**
+ * @brief link the node owned by [nh] in front of [pos], an empty handle is a no-op
+ */
+template <class T>
+typename list<T>::iterator list<T>::insert(const_iterator pos, node_type&& nh)
+{
+    if(nh.empty()) {
+        return iterator(pos.node_);
+    }
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
+    base_ptr n = nh.release()->as_base();
+    link_nodes(pos.node_, n, n);
+    ++size_;
+    return iterator(n);
+}
+
 template <class T>
 void list<T>::clear()
 {
@@ -0,0 +1,428 @@
+#ifndef WLRU_CACHE_HPP__
+#define WLRU_CACHE_HPP__
+
+#include "wlist.hpp"
+#include "functional.hpp"
+
+#include <functional>
+
+// the index is rehashed once it is this many percent full
+#ifndef LRU_CACHE_MAX_LOAD_PERCENT
+#define LRU_CACHE_MAX_LOAD_PERCENT 75
+#endif
+
+namespace wstl
+{
+
+struct lru_cache_stats
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t insertions = 0;
+    size_t evictions = 0;
+};
+
+/**
+ * @brief A least recently used cache: a wstl::list in recency order plus an
+ *        open addressing index from key to list node
+ * @note    1. the list front is the most recently used entry, get() and put()
+ *             promote with list::splice, O(1) and no allocation
+ *          2. every entry has a cost (1 by default) and the cache keeps
+ *             total_cost() <= capacity(), so the capacity is an entry count or
+ *             a byte budget depending on what put() is given
+ *          3. the index is linear probing over node pointers with the mixed
+ *             hash stored next to them, erase shifts the cluster back instead
+ *             of leaving tombstones
+ *          4. an evicted node goes to the list's free-node cache, so a full
+ *             cache that keeps inserting reuses the node it just evicted
+ *          5. the eviction callback runs before the entry is destroyed and
+ *             must not call back into the cache
+ */
+template <class Key, class Value, class Hash = wstl::hash<Key>, class KeyEqual = wstl::equal_to<Key>>
+class lru_cache
+{
+public:
+    typedef Key                                         key_type;
+    typedef Value                                       mapped_type;
+    typedef size_t                                      size_type;
+    typedef Hash                                        hasher;
+    typedef KeyEqual                                    key_equal;
+    typedef std::function<void(const Key&, Value&)>     eviction_callback;
+
+    struct entry
+    {
+        Key         key;
+        Value       value;
+        size_type   cost;
+
+        template <class K, class V>
+        entry(K&& k, V&& v, size_type c)
+            : key(wstl::forward<K>(k)), value(wstl::forward<V>(v)), cost(c) {}
+    };
+
+    typedef wstl::list<entry>                           list_type;
+    typedef typename list_type::const_iterator          const_iterator;
+
+private:
+    typedef typename list_type::iterator                list_iterator;
+    typedef typename list_type::base_ptr                base_ptr;
+
+    struct index_slot
+    {
+        base_ptr    node;       // nullptr for an empty slot
+        size_t      hash;
+    };
+
+    typedef wstl::allocator<index_slot>                 index_allocator;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    list_type           list_;
+    index_slot*         table_;
+    size_type           table_size_;        // 0 or a power of two
+    unsigned            shift_;             // hash >> shift_ is the home slot
+    size_type           capacity_;
+    size_type           total_cost_;
+    hasher              hasher_;
+    key_equal           equal_;
+    eviction_callback   on_evict_;
+    lru_cache_stats     stats_;
+
+public:
+    explicit lru_cache(size_type capacity, const hasher& hash = hasher(),
+                       const key_equal& equal = key_equal())
+        : table_(nullptr), table_size_(0), shift_(0), capacity_(capacity),
+          total_cost_(0), hasher_(hash), equal_(equal) {}
+
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    // rhs is left an empty, usable cache, so its list gets a fresh sentinel
+    lru_cache(lru_cache&& rhs)
+        : list_(), table_(rhs.table_), table_size_(rhs.table_size_),
+          shift_(rhs.shift_), capacity_(rhs.capacity_), total_cost_(rhs.total_cost_),
+          hasher_(rhs.hasher_), equal_(rhs.equal_), on_evict_(wstl::move(rhs.on_evict_)),
+          stats_(rhs.stats_) {
+        list_.swap(rhs.list_);
+        rhs.table_ = nullptr;
+        rhs.table_size_ = 0;
+        rhs.total_cost_ = 0;
+    }
+
+    ~lru_cache() {
+        index_allocator::deallocate(table_, table_size_);
+    }
+
+public:
+    // iterate from the most to the least recently used entry
+    const_iterator begin() const noexcept {
+        return list_.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return list_.end();
+    }
+
+    bool empty() const noexcept {
+        return 0 == list_.size();
+    }
+
+    size_type size() const noexcept {
+        return list_.size();
+    }
+
+    size_type capacity() const noexcept {
+        return capacity_;
+    }
+
+    size_type total_cost() const noexcept {
+        return total_cost_;
+    }
+
+    const lru_cache_stats& stats() const noexcept {
+        return stats_;
+    }
+
+    void reset_stats() noexcept {
+        stats_ = lru_cache_stats();
+    }
+
+    void set_eviction_callback(eviction_callback cb) {
+        on_evict_ = wstl::move(cb);
+    }
+
+    /**
+     * @brief shrinking evicts the least recently used entries right away
+     */
+    void set_capacity(size_type capacity) {
+        capacity_ = capacity;
+        evict_to(capacity_);
+    }
+
+    // size the index for [n] entries up front
+    void reserve(size_type n) {
+        reserve_index(n);
+    }
+
+    /**
+     * @brief the value of [key] promoted to most recently used, or nullptr
+     */
+    Value* get(const Key& key);
+
+    /**
+     * @brief look without promoting and without touching the counters
+     */
+    const Value* peek(const Key& key) const;
+
+    bool contains(const Key& key) const {
+        return npos != find_slot(key, hash_of(key));
+    }
+
+    /**
+     * @brief insert or replace [key], evicting from the back until it fits
+     * @return false if [cost] alone exceeds the capacity, [key] is then dropped
+     */
+    template <class K, class V>
+    bool put(K&& key, V&& value, size_type cost = 1);
+
+    bool erase(const Key& key);
+    void clear() noexcept;
+
+private:
+    size_t hash_of(const Key& key) const {
+        // Fibonacci hashing, the home slot comes from the high bits
+        return static_cast<size_t>(hasher_(key)) * static_cast<size_t>(0x9E3779B97F4A7C15ull);
+    }
+
+    static entry& entry_of(base_ptr node) noexcept {
+        return node->as_node()->value;
+    }
+
+    size_type   find_slot(const Key& key, size_t h) const;
+    size_type   find_node(base_ptr node, size_t h) const noexcept;
+    void        index_insert(base_ptr node, size_t h) noexcept;
+    void        index_erase(size_type pos) noexcept;
+    void        reserve_index(size_type n);
+    void        rehash(size_type new_size);
+
+    void        promote(base_ptr node) {
+        list_.splice(list_.begin(), list_, list_iterator(node));
+    }
+
+    void        remove_node(base_ptr node, size_type pos);
+    void        evict_to(size_type limit);
+};
+
+template <class Key, class Value, class Hash, class KeyEqual>
+const typename lru_cache<Key, Value, Hash, KeyEqual>::size_type lru_cache<Key, Value, Hash, KeyEqual>::npos;
+
+/*************** private ***************/
+
+template <class Key, class Value, class Hash, class KeyEqual>
+typename lru_cache<Key, Value, Hash, KeyEqual>::size_type
+lru_cache<Key, Value, Hash, KeyEqual>::find_slot(const Key& key, size_t h) const
+{
+    if(0 == table_size_) {
+        return npos;
+    }
+    const size_type mask = table_size_ - 1;
+    for(size_type i = h >> shift_;; i = (i + 1) & mask) {
+        const index_slot& s = table_[i];
+        if(nullptr == s.node) {
+            return npos;
+        }
+        if(s.hash == h && equal_(entry_of(s.node).key, key)) {
+            return i;
+        }
+    }
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+typename lru_cache<Key, Value, Hash, KeyEqual>::size_type
+lru_cache<Key, Value, Hash, KeyEqual>::find_node(base_ptr node, size_t h) const noexcept
+{
+    const size_type mask = table_size_ - 1;
+    size_type i = h >> shift_;
+    while (table_[i].node != node)
+    {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void lru_cache<Key, Value, Hash, KeyEqual>::index_insert(base_ptr node, size_t h) noexcept
+{
+    const size_type mask = table_size_ - 1;
+    size_type i = h >> shift_;
+    while (nullptr != table_[i].node)
+    {
+        i = (i + 1) & mask;
+    }
+    table_[i].node = node;
+    table_[i].hash = h;
+}
+
+/**
+ * @brief backward shift deletion: pull later members of the cluster into the
+ *        hole as long as that does not move them in front of their home slot
+ */
+template <class Key, class Value, class Hash, class KeyEqual>
+void lru_cache<Key, Value, Hash, KeyEqual>::index_erase(size_type pos) noexcept
+{
+    const size_type mask = table_size_ - 1;
+    size_type hole = pos;
+    for(size_type j = (pos + 1) & mask; nullptr != table_[j].node; j = (j + 1) & mask) {
+        const size_type home = table_[j].hash >> shift_;
+        if(((j - home) & mask) >= ((j - hole) & mask)) {
+            table_[hole] = table_[j];
+            hole = j;
+        }
+    }
+    table_[hole].node = nullptr;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void lru_cache<Key, Value, Hash, KeyEqual>::reserve_index(size_type n)
+{
+    if(n * 100 <= table_size_ * LRU_CACHE_MAX_LOAD_PERCENT) {
+        return;
+    }
+    size_type new_size = table_size_ != 0 ? table_size_ : 8;
+    while (n * 100 > new_size * LRU_CACHE_MAX_LOAD_PERCENT)
+    {
+        new_size *= 2;
+    }
+    rehash(new_size);
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void lru_cache<Key, Value, Hash, KeyEqual>::rehash(size_type new_size)
+{
+    index_slot* old_table = table_;
+    const size_type old_size = table_size_;
+
+    table_ = index_allocator::allocate(new_size);
+    table_size_ = new_size;
+    unsigned bits = 0;
+    for(size_type s = new_size; s > 1; s >>= 1) {
+        ++bits;
+    }
+    shift_ = static_cast<unsigned>(sizeof(size_t) * 8) - bits;
+    for(size_type i = 0; i < new_size; ++i) {
+        table_[i].node = nullptr;
+    }
+
+    for(size_type i = 0; i < old_size; ++i) {
+        if(nullptr != old_table[i].node) {
+            index_insert(old_table[i].node, old_table[i].hash);
+        }
+    }
+    index_allocator::deallocate(old_table, old_size);
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void lru_cache<Key, Value, Hash, KeyEqual>::remove_node(base_ptr node, size_type pos)
+{
+    index_erase(pos);
+    total_cost_ -= entry_of(node).cost;
+    list_.erase(list_iterator(node));
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void lru_cache<Key, Value, Hash, KeyEqual>::evict_to(size_type limit)
+{
+    while (total_cost_ > limit && !empty())
+    {
+        base_ptr node = (--list_.end()).node_;
+        entry& e = entry_of(node);
+        const size_type pos = find_node(node, hash_of(e.key));
+        if(on_evict_) {
+            on_evict_(e.key, e.value);
+        }
+        ++stats_.evictions;
+        remove_node(node, pos);
+    }
+}
+
+/**************public **************/
+
+template <class Key, class Value, class Hash, class KeyEqual>
+Value* lru_cache<Key, Value, Hash, KeyEqual>::get(const Key& key)
+{
+    const size_type pos = find_slot(key, hash_of(key));
+    if(npos == pos) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    base_ptr node = table_[pos].node;
+    promote(node);
+    return &entry_of(node).value;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+const Value* lru_cache<Key, Value, Hash, KeyEqual>::peek(const Key& key) const
+{
+    const size_type pos = find_slot(key, hash_of(key));
+    return npos == pos ? nullptr : &entry_of(table_[pos].node).value;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+template <class K, class V>
+bool lru_cache<Key, Value, Hash, KeyEqual>::put(K&& key, V&& value, size_type cost)
+{
+    const size_t h = hash_of(key);
+    const size_type pos = find_slot(key, h);
+    if(cost > capacity_) {
+        if(npos != pos) {
+            remove_node(table_[pos].node, pos);
+        }
+        return false;
+    }
+
+    if(npos != pos) {
+        base_ptr node = table_[pos].node;
+        entry& e = entry_of(node);
+        e.value = wstl::forward<V>(value);
+        total_cost_ = total_cost_ - e.cost + cost;
+        e.cost = cost;
+        promote(node);
+        evict_to(capacity_);
+        return true;
+    }
+
+    // make room first, so the new entry takes the node just evicted
+    evict_to(capacity_ - cost);
+    reserve_index(size() + 1);
+    list_.emplace_front(wstl::forward<K>(key), wstl::forward<V>(value), cost);
+    index_insert(list_.begin().node_, h);
+    total_cost_ += cost;
+    ++stats_.insertions;
+    return true;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+bool lru_cache<Key, Value, Hash, KeyEqual>::erase(const Key& key)
+{
+    const size_type pos = find_slot(key, hash_of(key));
+    if(npos == pos) {
+        return false;
+    }
+    remove_node(table_[pos].node, pos);
+    return true;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+void lru_cache<Key, Value, Hash, KeyEqual>::clear() noexcept
+{
+    list_.clear();
+    for(size_type i = 0; i < table_size_; ++i) {
+        table_[i].node = nullptr;
+    }
+    total_cost_ = 0;
+}
+
+}   // wstl
+
+#endif
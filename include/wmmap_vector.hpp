@@ -0,0 +1,520 @@
+#ifndef WMMAP_VECTOR_HPP__
+#define WMMAP_VECTOR_HPP__
+
+/**
+ * @file wmmap_vector.hpp
+ * @brief A vector of trivially copyable elements whose storage is a mapped file
+ */
+
+#include "wvector.hpp"
+#include "wexcepdef.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wstl
+{
+
+enum class mmap_mode
+{
+    read_only,      // PROT_READ, the vector cannot grow and writes fault
+    read_write,     // opens or creates the file, keeps its contents
+    truncate        // opens or creates the file, drops its contents
+};
+
+enum class mmap_advice
+{
+    normal,
+    sequential,
+    random,
+    willneed,
+    dontneed,
+    hugepage
+};
+
+/**
+ * @brief A vector of T laid out as the raw bytes of a file, mapped MAP_SHARED
+ * @note    1. the file is the array itself, no header, so an existing table of
+ *             packed T maps in place and every process shares its page cache
+ *          2. while open the file is as long as the capacity, reserve() grows
+ *             it with ftruncate and moves the mapping with mremap; sync() and
+ *             close() trim it back to size() elements
+ *          3. nothing is flushed explicitly until sync(), the kernel writes
+ *             dirty pages back whenever it likes
+ *          4. the element count lives only in the file length: after a crash
+ *             the file holds what the last sync() or close() left, unless the
+ *             vector grew since, then it is capacity() long and the tail is
+ *             zero bytes, or not a multiple of sizeof(T) and open() throws
+ *          5. growing may move the mapping, which invalidates pointers,
+ *             iterators and spans like vector's reallocation
+ */
+template <class T>
+class mmap_vector
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mmap_vector<T> needs a trivially copyable T");
+
+public:
+    typedef T                                       value_type;
+    typedef T*                                      pointer;
+    typedef const T*                                const_pointer;
+    typedef T&                                      reference;
+    typedef const T&                                const_reference;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+
+    typedef T*                                      iterator;
+    typedef const T*                                const_iterator;
+    typedef wstl::reverse_iterator<iterator>        reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+private:
+    int         fd_;
+    T*          data_;
+    size_type   size_;
+    size_type   cap_;
+    size_type   mapped_;        // bytes mapped, the file length until sync() trims it
+    bool        writable_;
+
+public:
+    mmap_vector() noexcept
+        : fd_(-1), data_(nullptr), size_(0), cap_(0), mapped_(0), writable_(false) {}
+
+    explicit mmap_vector(const char* path, mmap_mode mode = mmap_mode::read_write)
+        : mmap_vector() {
+        open(path, mode);
+    }
+
+    mmap_vector(const mmap_vector&) = delete;
+    mmap_vector& operator=(const mmap_vector&) = delete;
+
+    mmap_vector(mmap_vector&& rhs) noexcept
+        : fd_(rhs.fd_), data_(rhs.data_), size_(rhs.size_), cap_(rhs.cap_),
+          mapped_(rhs.mapped_), writable_(rhs.writable_) {
+        rhs.release();
+    }
+
+    mmap_vector& operator=(mmap_vector&& rhs) {
+        if(this != &rhs) {
+            close();
+            fd_ = rhs.fd_;
+            data_ = rhs.data_;
+            size_ = rhs.size_;
+            cap_ = rhs.cap_;
+            mapped_ = rhs.mapped_;
+            writable_ = rhs.writable_;
+            rhs.release();
+        }
+        return *this;
+    }
+
+    ~mmap_vector() {
+        try
+        {
+            close();
+        }
+        catch(...)
+        {
+        }
+    }
+
+public:
+    // file
+    void open(const char* path, mmap_mode mode = mmap_mode::read_write);
+    void close();
+    bool is_open() const noexcept {
+        return fd_ >= 0;
+    }
+    bool writable() const noexcept {
+        return writable_;
+    }
+    void sync(bool async = false);
+    bool advise(mmap_advice advice) noexcept;
+
+    // iterator
+    iterator begin() noexcept {
+        return data_;
+    }
+    const_iterator begin() const noexcept {
+        return data_;
+    }
+    iterator end() noexcept {
+        return data_ + size_;
+    }
+    const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    size_type capacity() const noexcept {
+        return cap_;
+    }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(T);
+    }
+    void reserve(size_type n);
+    void shrink_to_fit();
+
+    // visit
+    reference operator[](size_type n) {
+        WSTL_DEBUG(n < size_);
+        return data_[n];
+    }
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return data_[n];
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "mmap_vector<T>::at() subscript out of range");
+        return data_[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "mmap_vector<T>::at() subscript out of range");
+        return data_[n];
+    }
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return data_[0];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return data_[0];
+    }
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return data_[size_ - 1];
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return data_[size_ - 1];
+    }
+    pointer data() noexcept {
+        return data_;
+    }
+    const_pointer data() const noexcept {
+        return data_;
+    }
+
+    // modify
+    void push_back(const value_type& value) {
+        if(size_ == cap_) {
+            // value may be an element, copy it before the mapping moves
+            const value_type copy = value;
+            reserve(get_new_cap(1));
+            data_[size_++] = copy;
+            return;
+        }
+        data_[size_++] = value;
+    }
+
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        --size_;
+    }
+
+    void append(const value_type* first, size_type n);
+
+    // new elements are zero bytes
+    void resize(size_type n);
+    void resize(size_type n, const value_type& value);
+
+    void clear() noexcept {
+        size_ = 0;
+    }
+
+    void swap(mmap_vector& rhs) noexcept {
+        wstl::swap(fd_, rhs.fd_);
+        wstl::swap(data_, rhs.data_);
+        wstl::swap(size_, rhs.size_);
+        wstl::swap(cap_, rhs.cap_);
+        wstl::swap(mapped_, rhs.mapped_);
+        wstl::swap(writable_, rhs.writable_);
+    }
+
+private:
+    static size_type page_round(size_type bytes) noexcept {
+        static const size_type page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) / page * page;
+    }
+
+    size_type get_new_cap(size_type add_size) const;
+    void remap(size_type bytes);
+    void release() noexcept;
+};
+
+/************* private ***************/
+
+template <class T>
+typename mmap_vector<T>::size_type mmap_vector<T>::get_new_cap(size_type add_size) const
+{
+    THROW_LENGTH_ERROR_IF(cap_ > max_size() - add_size, "mmap_vector<T>'s size too big");
+    return wstl::grow_capacity(cap_, add_size, max_size());
+}
+
+// resize the file to [bytes] and map all of it
+template <class T>
+void mmap_vector<T>::remap(size_type bytes)
+{
+    THROW_RUNTIME_ERROR_IF(!writable_, "mmap_vector<T> is read only");
+    // >= as well: after sync() the file can be shorter than the mapping
+    if(bytes >= mapped_) {
+        THROW_SYSTEM_ERROR_IF(::ftruncate(fd_, static_cast<off_t>(bytes)) != 0, "mmap_vector<T> ftruncate");
+    }
+
+    void* p = nullptr;
+    if(0 == bytes) {
+        if(data_) {
+            ::munmap(data_, mapped_);
+        }
+    }
+    else if(nullptr == data_) {
+        p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        THROW_SYSTEM_ERROR_IF(MAP_FAILED == p, "mmap_vector<T> mmap");
+    }
+    else {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        // the kernel moves the page table entries, no page is copied or faulted
+        p = ::mremap(data_, mapped_, bytes, MREMAP_MAYMOVE);
+        THROW_SYSTEM_ERROR_IF(MAP_FAILED == p, "mmap_vector<T> mremap");
+#else
+        p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        THROW_SYSTEM_ERROR_IF(MAP_FAILED == p, "mmap_vector<T> mmap");
+        ::munmap(data_, mapped_);
+#endif
+    }
+
+    if(bytes < mapped_) {
+        THROW_SYSTEM_ERROR_IF(::ftruncate(fd_, static_cast<off_t>(bytes)) != 0, "mmap_vector<T> ftruncate");
+    }
+    data_ = static_cast<T*>(p);
+    mapped_ = bytes;
+    cap_ = bytes / sizeof(T);
+}
+
+template <class T>
+void mmap_vector<T>::release() noexcept
+{
+    fd_ = -1;
+    data_ = nullptr;
+    size_ = 0;
+    cap_ = 0;
+    mapped_ = 0;
+    writable_ = false;
+}
+
+/************* public ***************/
+
+template <class T>
+void mmap_vector<T>::open(const char* path, mmap_mode mode)
+{
+    close();
+
+    int flags = O_RDONLY;
+    if(mode == mmap_mode::read_write) {
+        flags = O_RDWR | O_CREAT;
+    }
+    else if(mode == mmap_mode::truncate) {
+        flags = O_RDWR | O_CREAT | O_TRUNC;
+    }
+    const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+    THROW_SYSTEM_ERROR_IF(fd < 0, "mmap_vector<T> open");
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0) {
+        const int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "mmap_vector<T> fstat");
+    }
+    if(st.st_size % static_cast<off_t>(sizeof(T)) != 0) {
+        ::close(fd);
+        throw std::runtime_error("mmap_vector<T> file size is not a multiple of sizeof(T)");
+    }
+
+    const size_type bytes = static_cast<size_type>(st.st_size);
+    void* p = nullptr;
+    if(bytes > 0) {
+        const int prot = mode == mmap_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        p = ::mmap(nullptr, bytes, prot, MAP_SHARED, fd, 0);
+        if(MAP_FAILED == p) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "mmap_vector<T> mmap");
+        }
+    }
+
+    fd_ = fd;
+    data_ = static_cast<T*>(p);
+    size_ = bytes / sizeof(T);
+    cap_ = size_;
+    mapped_ = bytes;
+    writable_ = mode != mmap_mode::read_only;
+}
+
+// trims the file to size() elements, then unmaps and closes it
+template <class T>
+void mmap_vector<T>::close()
+{
+    if(!is_open()) {
+        return;
+    }
+    if(data_) {
+        ::munmap(data_, mapped_);
+    }
+    int rc = 0;
+    if(writable_ && mapped_ != size_ * sizeof(T)) {
+        rc = ::ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T)));
+    }
+    const int err = errno;
+    ::close(fd_);
+    release();
+    if(rc != 0) {
+        throw std::system_error(err, std::generic_category(), "mmap_vector<T> ftruncate");
+    }
+}
+
+/**
+ * @brief trim the file to size() elements and flush them, the capacity drops
+ *        to size() so the mapped pages past the end of the file stay untouched
+ *        until reserve() extends it again
+ * @note async only starts the write back, the new length is not fdatasync'ed
+ */
+template <class T>
+void mmap_vector<T>::sync(bool async)
+{
+    if(!is_open()) {
+        return;
+    }
+    if(writable_ && cap_ != size_) {
+        THROW_SYSTEM_ERROR_IF(::ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T))) != 0,
+                              "mmap_vector<T> ftruncate");
+        cap_ = size_;
+    }
+    if(data_ && size_ > 0) {
+        THROW_SYSTEM_ERROR_IF(::msync(data_, size_ * sizeof(T), async ? MS_ASYNC : MS_SYNC) != 0,
+                              "mmap_vector<T> msync");
+    }
+    if(writable_ && !async) {
+        THROW_SYSTEM_ERROR_IF(::fdatasync(fd_) != 0, "mmap_vector<T> fdatasync");
+    }
+}
+
+// a hint only, false when the kernel declines it or does not know it
+template <class T>
+bool mmap_vector<T>::advise(mmap_advice advice) noexcept
+{
+    if(nullptr == data_) {
+        return false;
+    }
+    int flag = MADV_NORMAL;
+    switch(advice) {
+    case mmap_advice::normal:       flag = MADV_NORMAL; break;
+    case mmap_advice::sequential:   flag = MADV_SEQUENTIAL; break;
+    case mmap_advice::random:       flag = MADV_RANDOM; break;
+    case mmap_advice::willneed:     flag = MADV_WILLNEED; break;
+    case mmap_advice::dontneed:     flag = MADV_DONTNEED; break;
+    case mmap_advice::hugepage:
+#ifdef MADV_HUGEPAGE
+        flag = MADV_HUGEPAGE;
+        break;
+#else
+        return false;
+#endif
+    }
+    return ::madvise(data_, mapped_, flag) == 0;
+}
+
+template <class T>
+void mmap_vector<T>::reserve(size_type n)
+{
+    if(n <= cap_) {
+        return;
+    }
+    THROW_LENGTH_ERROR_IF(n > max_size(), "mmap_vector<T>'s size too big");
+    remap(page_round(n * sizeof(T)));
+}
+
+template <class T>
+void mmap_vector<T>::shrink_to_fit()
+{
+    if(writable_ && page_round(size_ * sizeof(T)) < mapped_) {
+        remap(page_round(size_ * sizeof(T)));
+    }
+}
+
+template <class T>
+void mmap_vector<T>::append(const value_type* first, size_type n)
+{
+    if(n > cap_ - size_) {
+        // a source inside the vector moves with the mapping
+        const bool inside = data_ != nullptr && first >= data_ && first < data_ + size_;
+        const size_type offset = inside ? static_cast<size_type>(first - data_) : 0;
+        reserve(get_new_cap(n - (cap_ - size_)));
+        if(inside) {
+            first = data_ + offset;
+        }
+    }
+    if(n > 0) {
+        std::memcpy(data_ + size_, first, n * sizeof(T));
+    }
+    size_ += n;
+}
+
+template <class T>
+void mmap_vector<T>::resize(size_type n)
+{
+    if(n > size_) {
+        reserve(n);
+        // the slots past size() may still hold popped elements
+        std::memset(static_cast<void*>(data_ + size_), 0, (n - size_) * sizeof(T));
+    }
+    size_ = n;
+}
+
+template <class T>
+void mmap_vector<T>::resize(size_type n, const value_type& value)
+{
+    if(n > size_) {
+        const value_type copy = value;
+        reserve(n);
+        for(size_type i = size_; i < n; ++i) {
+            data_[i] = copy;
+        }
+    }
+    size_ = n;
+}
+
+/******************************************* */
+// overload operator
+
+template <class T>
+void swap(mmap_vector<T>& lhs, mmap_vector<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
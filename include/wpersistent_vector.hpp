@@ -0,0 +1,917 @@
+#ifndef WPERSISTENT_VECTOR_HPP__
+#define WPERSISTENT_VECTOR_HPP__
+
+/**
+ * @file wpersistent_vector.hpp
+ * @brief An immutable vector whose versions share structure, and its transient
+ *        (batch editing) form
+ */
+
+#include "witerator.hpp"
+#include "wallocator.hpp"
+#include "uninitialized.hpp"
+#include "wexcepdef.hpp"
+#include "utils.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+namespace wstl
+{
+
+#ifndef PERSISTENT_VECTOR_BITS
+#define PERSISTENT_VECTOR_BITS 5
+#endif
+
+template <class T>
+class transient_vector;
+
+/**
+ * @brief A vector value: copies are O(1), every update returns a new version
+ * @note    1. the elements live in a 32-way trie of leaves plus a tail leaf, so
+ *             push_back / set / pop_back copy one root-to-leaf path, O(log32 n),
+ *             and the new version shares every other node with the old one
+ *          2. nodes are reference counted atomically, versions may be read and
+ *             dropped from any thread; a single version is not written at all
+ *          3. transient() gives a transient_vector that edits nodes it created
+ *             in place, for batches of updates; persistent() turns it back
+ *          4. the trie holds only full leaves, the last 1..32 elements sit in
+ *             the tail, which is why push_back is usually a tail copy only
+ */
+template <class T>
+class persistent_vector
+{
+    friend class transient_vector<T>;
+
+public:
+    typedef T                                       value_type;
+    typedef const T*                                pointer;
+    typedef const T*                                const_pointer;
+    typedef const T&                                reference;
+    typedef const T&                                const_reference;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+
+    static const size_type bits = PERSISTENT_VECTOR_BITS;
+    static const size_type branch = size_type(1) << bits;
+    static const size_type mask = branch - 1;
+
+private:
+    struct node
+    {
+        std::atomic<size_t> refs;
+        uint64_t            edit;       // the transient that may write it, 0 for none
+        size_type           count;      // children or elements held
+
+        explicit node(uint64_t e) noexcept : refs(1), edit(e), count(0) {}
+    };
+
+    struct inner_node : public node
+    {
+        node* child[branch];
+
+        explicit inner_node(uint64_t e) noexcept : node(e) {}
+    };
+
+    struct leaf_node : public node
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[branch];
+
+        explicit leaf_node(uint64_t e) noexcept : node(e) {}
+
+        T* values() noexcept {
+            return reinterpret_cast<T*>(slots);
+        }
+    };
+
+    typedef wstl::allocator<T>              data_allocator;
+    typedef wstl::allocator<inner_node>     inner_allocator;
+    typedef wstl::allocator<leaf_node>      leaf_allocator;
+
+    size_type   size_;
+    size_type   shift_;     // level of root_, its children are leaves at bits
+    inner_node* root_;      // null while everything fits in the tail
+    leaf_node*  tail_;      // null when empty
+
+public:
+    class const_iterator : public wstl::iterator<wstl::random_access_iterator_tag, T, ptrdiff_t, const T*, const T&>
+    {
+    public:
+        typedef T                   value_type;
+        typedef const T*            pointer;
+        typedef const T&            reference;
+        typedef ptrdiff_t           difference_type;
+        typedef const_iterator      self;
+
+    private:
+        const persistent_vector*    vec_;
+        size_type                   index_;
+        mutable const T*            leaf_;      // the leaf holding index_, found lazily
+        mutable size_type           base_;
+
+    public:
+        const_iterator() noexcept : vec_(nullptr), index_(0), leaf_(nullptr), base_(0) {}
+        const_iterator(const persistent_vector* vec, size_type index) noexcept
+            : vec_(vec), index_(index), leaf_(nullptr), base_(0) {}
+
+        reference operator*() const {
+            if(nullptr == leaf_ || index_ - base_ >= branch) {
+                base_ = index_ & ~mask;
+                leaf_ = vec_->leaf_for(index_)->values();
+            }
+            return leaf_[index_ - base_];
+        }
+        pointer operator->() const {
+            return &**this;
+        }
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        self& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        self operator++(int) noexcept {
+            self tmp = *this;
+            ++index_;
+            return tmp;
+        }
+        self& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+        self operator--(int) noexcept {
+            self tmp = *this;
+            --index_;
+            return tmp;
+        }
+        self& operator+=(difference_type n) noexcept {
+            index_ = static_cast<size_type>(static_cast<difference_type>(index_) + n);
+            return *this;
+        }
+        self& operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+        self operator+(difference_type n) const noexcept {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self operator-(difference_type n) const noexcept {
+            self tmp = *this;
+            return tmp -= n;
+        }
+        difference_type operator-(const self& rhs) const noexcept {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        bool operator==(const self& rhs) const noexcept {
+            return index_ == rhs.index_;
+        }
+        bool operator!=(const self& rhs) const noexcept {
+            return index_ != rhs.index_;
+        }
+        bool operator<(const self& rhs) const noexcept {
+            return index_ < rhs.index_;
+        }
+        bool operator>(const self& rhs) const noexcept {
+            return rhs < *this;
+        }
+        bool operator<=(const self& rhs) const noexcept {
+            return !(rhs < *this);
+        }
+        bool operator>=(const self& rhs) const noexcept {
+            return !(*this < rhs);
+        }
+    };
+
+    typedef const_iterator                          iterator;
+    typedef wstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+    typedef const_reverse_iterator                  reverse_iterator;
+    typedef transient_vector<T>                     transient_type;
+
+public:
+    persistent_vector() noexcept : size_(0), shift_(bits), root_(nullptr), tail_(nullptr) {}
+
+    template <class IIter, typename std::enable_if<
+            wstl::is_input_iterator<IIter>::value, int>::type = 0>
+    persistent_vector(IIter first, IIter last);
+
+    persistent_vector(std::initializer_list<value_type> ilist)
+        : persistent_vector(ilist.begin(), ilist.end()) {}
+
+    persistent_vector(const persistent_vector& rhs) noexcept
+        : size_(rhs.size_), shift_(rhs.shift_), root_(rhs.root_), tail_(rhs.tail_) {
+        retain(root_);
+        retain(tail_);
+    }
+
+    persistent_vector(persistent_vector&& rhs) noexcept
+        : size_(rhs.size_), shift_(rhs.shift_), root_(rhs.root_), tail_(rhs.tail_) {
+        rhs.reset();
+    }
+
+    persistent_vector& operator=(const persistent_vector& rhs) noexcept {
+        persistent_vector tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    persistent_vector& operator=(persistent_vector&& rhs) noexcept {
+        persistent_vector tmp(wstl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    ~persistent_vector() {
+        release_all();
+    }
+
+public:
+    // iterator
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(T);
+    }
+
+    // visit
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return leaf_for(n)->values()[n & mask];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "persistent_vector<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return (*this)[0];
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return tail_->values()[tail_->count - 1];
+    }
+
+    // new versions, *this is left as it is
+    persistent_vector push_back(const value_type& value) const {
+        persistent_vector r(*this);
+        r.do_push_back(value, 0);
+        return r;
+    }
+    persistent_vector set(size_type n, const value_type& value) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "persistent_vector<T>::set() subscript out of range");
+        persistent_vector r(*this);
+        r.do_set(n, value, 0);
+        return r;
+    }
+    persistent_vector pop_back() const {
+        WSTL_DEBUG(!empty());
+        persistent_vector r(*this);
+        r.do_pop_back(0);
+        return r;
+    }
+
+    transient_type transient() const {
+        return transient_type(*this);
+    }
+
+    void swap(persistent_vector& rhs) noexcept {
+        wstl::swap(size_, rhs.size_);
+        wstl::swap(shift_, rhs.shift_);
+        wstl::swap(root_, rhs.root_);
+        wstl::swap(tail_, rhs.tail_);
+    }
+
+    // true when both are the same version or copies of it, an O(1) test
+    bool shares_with(const persistent_vector& rhs) const noexcept {
+        return size_ == rhs.size_ && root_ == rhs.root_ && tail_ == rhs.tail_;
+    }
+
+private:
+    size_type tail_offset() const noexcept {
+        return size_ <= branch ? 0 : ((size_ - 1) >> bits) << bits;
+    }
+    leaf_node* leaf_for(size_type n) const noexcept;
+
+    // nodes
+    static uint64_t next_edit() noexcept {
+        static std::atomic<uint64_t> edit(0);
+        return ++edit;
+    }
+    static bool editable(const node* n, uint64_t edit) noexcept {
+        return 0 != edit && n->edit == edit;
+    }
+    static void retain(node* n) noexcept {
+        if(n) {
+            n->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    static void release(node* n, size_type level) noexcept;
+    static inner_node* new_inner(uint64_t edit);
+    static leaf_node* new_leaf(uint64_t edit);
+    static inner_node* editable_inner(inner_node* n, uint64_t edit);
+    static leaf_node* editable_leaf(leaf_node* n, uint64_t edit);
+    static node* new_path(size_type level, leaf_node* leaf, uint64_t edit);
+    static void free_path(node* path, size_type level) noexcept;
+
+    // updates in place on this version, copying every node [edit] may not write
+    void do_push_back(const value_type& value, uint64_t edit);
+    void do_set(size_type n, const value_type& value, uint64_t edit);
+    void do_pop_back(uint64_t edit);
+    inner_node* push_tail(size_type level, inner_node* parent, leaf_node* leaf, uint64_t edit);
+    node* do_assoc(size_type level, node* n, size_type i, const value_type& value, uint64_t edit);
+    inner_node* pop_tail(size_type level, inner_node* n, uint64_t edit);
+
+    void release_all() noexcept {
+        release(root_, shift_);
+        release(tail_, 0);
+    }
+    void reset() noexcept {
+        size_ = 0;
+        shift_ = bits;
+        root_ = nullptr;
+        tail_ = nullptr;
+    }
+};
+
+/************* private ***************/
+
+template <class T>
+typename persistent_vector<T>::leaf_node* persistent_vector<T>::leaf_for(size_type n) const noexcept
+{
+    if(n >= tail_offset()) {
+        return tail_;
+    }
+    node* cur = root_;
+    for(size_type level = shift_; level > 0; level -= bits) {
+        cur = static_cast<inner_node*>(cur)->child[(n >> level) & mask];
+    }
+    return static_cast<leaf_node*>(cur);
+}
+
+// level 0 is a leaf, anything above is an inner node
+template <class T>
+void persistent_vector<T>::release(node* n, size_type level) noexcept
+{
+    if(nullptr == n || n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    if(0 == level) {
+        leaf_node* leaf = static_cast<leaf_node*>(n);
+        data_allocator::destroy(leaf->values(), leaf->values() + leaf->count);
+        leaf->~leaf_node();
+        leaf_allocator::deallocate(leaf);
+    }
+    else {
+        inner_node* in = static_cast<inner_node*>(n);
+        for(size_type i = 0; i < in->count; ++i) {
+            release(in->child[i], level - bits);
+        }
+        in->~inner_node();
+        inner_allocator::deallocate(in);
+    }
+}
+
+template <class T>
+typename persistent_vector<T>::inner_node* persistent_vector<T>::new_inner(uint64_t edit)
+{
+    return ::new (static_cast<void*>(inner_allocator::allocate(1))) inner_node(edit);
+}
+
+template <class T>
+typename persistent_vector<T>::leaf_node* persistent_vector<T>::new_leaf(uint64_t edit)
+{
+    return ::new (static_cast<void*>(leaf_allocator::allocate(1))) leaf_node(edit);
+}
+
+// n itself when [edit] may write it, otherwise a copy holding its own references
+template <class T>
+typename persistent_vector<T>::inner_node*
+persistent_vector<T>::editable_inner(inner_node* n, uint64_t edit)
+{
+    if(editable(n, edit)) {
+        return n;
+    }
+    inner_node* r = new_inner(edit);
+    for(size_type i = 0; i < n->count; ++i) {
+        r->child[i] = n->child[i];
+        retain(r->child[i]);
+    }
+    r->count = n->count;
+    return r;
+}
+
+template <class T>
+typename persistent_vector<T>::leaf_node*
+persistent_vector<T>::editable_leaf(leaf_node* n, uint64_t edit)
+{
+    if(editable(n, edit)) {
+        return n;
+    }
+    leaf_node* r = new_leaf(edit);
+    try
+    {
+        wstl::uninitialized_copy(n->values(), n->values() + n->count, r->values());
+    }
+    catch(...)
+    {
+        r->~leaf_node();
+        leaf_allocator::deallocate(r);
+        throw;
+    }
+    r->count = n->count;
+    return r;
+}
+
+// a chain of single-child inner nodes from [level] down to [leaf], the leaf is
+// still the caller's when this throws
+template <class T>
+typename persistent_vector<T>::node*
+persistent_vector<T>::new_path(size_type level, leaf_node* leaf, uint64_t edit)
+{
+    node* cur = leaf;
+    for(size_type l = bits; l <= level; l += bits) {
+        inner_node* r = nullptr;
+        try
+        {
+            r = new_inner(edit);
+        }
+        catch(...)
+        {
+            free_path(cur, l - bits);
+            throw;
+        }
+        r->child[0] = cur;
+        r->count = 1;
+        cur = r;
+    }
+    return cur;
+}
+
+// frees the inner nodes of a chain from new_path, not its leaf
+template <class T>
+void persistent_vector<T>::free_path(node* path, size_type level) noexcept
+{
+    for(; level > 0; level -= bits) {
+        inner_node* in = static_cast<inner_node*>(path);
+        path = in->child[0];
+        in->count = 0;
+        release(in, level);
+    }
+}
+
+template <class T>
+void persistent_vector<T>::do_push_back(const value_type& value, uint64_t edit)
+{
+    THROW_LENGTH_ERROR_IF(size_ == max_size(), "persistent_vector<T>'s size too big");
+    if(tail_ && tail_->count < branch) {
+        leaf_node* t = editable_leaf(tail_, edit);
+        try
+        {
+            data_allocator::construct(t->values() + t->count, value);
+        }
+        catch(...)
+        {
+            if(t != tail_) {
+                release(t, 0);
+            }
+            throw;
+        }
+        ++t->count;
+        if(t != tail_) {
+            release(tail_, 0);
+            tail_ = t;
+        }
+        ++size_;
+        return;
+    }
+
+    leaf_node* t = new_leaf(edit);
+    try
+    {
+        data_allocator::construct(t->values(), value);
+    }
+    catch(...)
+    {
+        release(t, 0);
+        throw;
+    }
+    t->count = 1;
+
+    // the full tail moves into the trie, its reference goes with it
+    if(tail_) {
+        try
+        {
+            if(nullptr == root_) {
+                root_ = new_inner(edit);
+                root_->child[0] = tail_;
+                root_->count = 1;
+                shift_ = bits;
+            }
+            else if((size_ >> bits) > (size_type(1) << shift_)) {
+                // the root is full, grow a level
+                node* path = new_path(shift_, tail_, edit);
+                inner_node* r = nullptr;
+                try
+                {
+                    r = new_inner(edit);
+                }
+                catch(...)
+                {
+                    free_path(path, shift_);
+                    throw;
+                }
+                r->child[0] = root_;
+                r->child[1] = path;
+                r->count = 2;
+                root_ = r;
+                shift_ += bits;
+            }
+            else {
+                inner_node* r = push_tail(shift_, root_, tail_, edit);
+                if(r != root_) {
+                    release(root_, shift_);
+                    root_ = r;
+                }
+            }
+        }
+        catch(...)
+        {
+            release(t, 0);
+            throw;
+        }
+    }
+    tail_ = t;
+    ++size_;
+}
+
+template <class T>
+typename persistent_vector<T>::inner_node*
+persistent_vector<T>::push_tail(size_type level, inner_node* parent, leaf_node* leaf, uint64_t edit)
+{
+    // size_ still counts the full tail, its last element is the one placed
+    const size_type sub = ((size_ - 1) >> level) & mask;
+    inner_node* r = editable_inner(parent, edit);
+    try
+    {
+        if(bits == level) {
+            r->child[sub] = leaf;
+        }
+        else if(sub < r->count) {
+            inner_node* child = static_cast<inner_node*>(r->child[sub]);
+            inner_node* c = push_tail(level - bits, child, leaf, edit);
+            if(c != child) {
+                release(child, level - bits);
+                r->child[sub] = c;
+            }
+        }
+        else {
+            r->child[sub] = new_path(level - bits, leaf, edit);
+        }
+    }
+    catch(...)
+    {
+        if(r != parent) {
+            release(r, level);
+        }
+        throw;
+    }
+    r->count = sub + 1;
+    return r;
+}
+
+template <class T>
+void persistent_vector<T>::do_set(size_type n, const value_type& value, uint64_t edit)
+{
+    if(n >= tail_offset()) {
+        leaf_node* t = editable_leaf(tail_, edit);
+        try
+        {
+            t->values()[n & mask] = value;
+        }
+        catch(...)
+        {
+            if(t != tail_) {
+                release(t, 0);
+            }
+            throw;
+        }
+        if(t != tail_) {
+            release(tail_, 0);
+            tail_ = t;
+        }
+        return;
+    }
+    node* r = do_assoc(shift_, root_, n, value, edit);
+    if(r != root_) {
+        release(root_, shift_);
+        root_ = static_cast<inner_node*>(r);
+    }
+}
+
+template <class T>
+typename persistent_vector<T>::node*
+persistent_vector<T>::do_assoc(size_type level, node* n, size_type i, const value_type& value, uint64_t edit)
+{
+    if(0 == level) {
+        leaf_node* leaf = static_cast<leaf_node*>(n);
+        leaf_node* r = editable_leaf(leaf, edit);
+        try
+        {
+            r->values()[i & mask] = value;
+        }
+        catch(...)
+        {
+            if(r != leaf) {
+                release(r, 0);
+            }
+            throw;
+        }
+        return r;
+    }
+
+    inner_node* in = static_cast<inner_node*>(n);
+    inner_node* r = editable_inner(in, edit);
+    const size_type sub = (i >> level) & mask;
+    try
+    {
+        node* child = r->child[sub];
+        node* c = do_assoc(level - bits, child, i, value, edit);
+        if(c != child) {
+            release(child, level - bits);
+            r->child[sub] = c;
+        }
+    }
+    catch(...)
+    {
+        if(r != in) {
+            release(r, level);
+        }
+        throw;
+    }
+    return r;
+}
+
+template <class T>
+void persistent_vector<T>::do_pop_back(uint64_t edit)
+{
+    if(1 == size_) {
+        release(tail_, 0);
+        reset();
+        return;
+    }
+    if(tail_->count > 1) {
+        leaf_node* t = editable_leaf(tail_, edit);
+        if(t != tail_) {
+            release(tail_, 0);
+            tail_ = t;
+        }
+        --t->count;
+        data_allocator::destroy(t->values() + t->count, t->values() + t->count + 1);
+        --size_;
+        return;
+    }
+
+    // the tail empties, the last leaf of the trie becomes the tail
+    leaf_node* t = leaf_for(size_ - 2);
+    retain(t);
+    inner_node* r = nullptr;
+    try
+    {
+        r = pop_tail(shift_, root_, edit);
+    }
+    catch(...)
+    {
+        release(t, 0);
+        throw;
+    }
+    if(r != root_) {
+        release(root_, shift_);
+    }
+    if(r && shift_ > bits && 1 == r->count) {
+        inner_node* only = static_cast<inner_node*>(r->child[0]);
+        retain(only);
+        release(r, shift_);
+        r = only;
+        shift_ -= bits;
+    }
+    root_ = r;
+    if(nullptr == root_) {
+        shift_ = bits;
+    }
+    release(tail_, 0);
+    tail_ = t;
+    --size_;
+}
+
+// the subtree without its last leaf, null when nothing is left
+template <class T>
+typename persistent_vector<T>::inner_node*
+persistent_vector<T>::pop_tail(size_type level, inner_node* n, uint64_t edit)
+{
+    const size_type sub = ((size_ - 2) >> level) & mask;
+    if(level > bits) {
+        inner_node* child = static_cast<inner_node*>(n->child[sub]);
+        inner_node* c = pop_tail(level - bits, child, edit);
+        if(nullptr == c && 0 == sub) {
+            return nullptr;
+        }
+        inner_node* r = nullptr;
+        try
+        {
+            r = editable_inner(n, edit);
+        }
+        catch(...)
+        {
+            if(c != child) {
+                release(c, level - bits);
+            }
+            throw;
+        }
+        if(c != child) {
+            release(child, level - bits);
+        }
+        if(c) {
+            r->child[sub] = c;
+            r->count = sub + 1;
+        }
+        else {
+            r->count = sub;
+        }
+        return r;
+    }
+    if(0 == sub) {
+        return nullptr;
+    }
+    inner_node* r = editable_inner(n, edit);
+    release(r->child[sub], 0);
+    r->count = sub;
+    return r;
+}
+
+/************* public ***************/
+
+template <class T>
+template <class IIter, typename std::enable_if<
+        wstl::is_input_iterator<IIter>::value, int>::type>
+persistent_vector<T>::persistent_vector(IIter first, IIter last)
+    : persistent_vector()
+{
+    transient_type t(*this);
+    for(; first != last; ++first) {
+        t.push_back(*first);
+    }
+    *this = t.persistent();
+}
+
+/******************************************* */
+
+/**
+ * @brief A persistent_vector being edited in place, for batches of updates
+ * @note    1. nodes it copies or creates carry its edit id and are written in
+ *             place by the following updates, a batch of n push_backs costs
+ *             about n element constructions instead of n path copies
+ *          2. persistent() hands the current contents out as a version and
+ *             starts a new edit id, so later updates copy again instead of
+ *             writing into that version
+ *          3. not safe for concurrent use, like any other container
+ */
+template <class T>
+class transient_vector
+{
+public:
+    typedef persistent_vector<T>                    persistent_type;
+    typedef typename persistent_type::value_type    value_type;
+    typedef typename persistent_type::size_type     size_type;
+    typedef typename persistent_type::const_reference const_reference;
+    typedef typename persistent_type::const_iterator  const_iterator;
+
+private:
+    persistent_type vec_;
+    uint64_t        edit_;
+
+public:
+    transient_vector() : vec_(), edit_(persistent_type::next_edit()) {}
+
+    explicit transient_vector(const persistent_type& vec)
+        : vec_(vec), edit_(persistent_type::next_edit()) {}
+
+    transient_vector(const transient_vector&) = delete;
+    transient_vector& operator=(const transient_vector&) = delete;
+
+    transient_vector(transient_vector&& rhs) noexcept
+        : vec_(wstl::move(rhs.vec_)), edit_(rhs.edit_) {
+        rhs.edit_ = persistent_type::next_edit();
+    }
+
+    // the current contents as a version, later edits copy before writing
+    persistent_type persistent() {
+        persistent_type r(vec_);
+        edit_ = persistent_type::next_edit();
+        return r;
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return vec_.empty();
+    }
+    size_type size() const noexcept {
+        return vec_.size();
+    }
+
+    // visit
+    const_reference operator[](size_type n) const {
+        return vec_[n];
+    }
+    const_reference at(size_type n) const {
+        return vec_.at(n);
+    }
+    const_reference front() const {
+        return vec_.front();
+    }
+    const_reference back() const {
+        return vec_.back();
+    }
+    const_iterator begin() const noexcept {
+        return vec_.begin();
+    }
+    const_iterator end() const noexcept {
+        return vec_.end();
+    }
+
+    // modify
+    void push_back(const value_type& value) {
+        vec_.do_push_back(value, edit_);
+    }
+    void set(size_type n, const value_type& value) {
+        THROW_OUT_OF_RANGE_IF(!(n < size()), "transient_vector<T>::set() subscript out of range");
+        vec_.do_set(n, value, edit_);
+    }
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        vec_.do_pop_back(edit_);
+    }
+};
+
+/******************************************* */
+// overload operator
+
+template <class T>
+bool operator==(const persistent_vector<T>& lhs, const persistent_vector<T>& rhs)
+{
+    if(lhs.shares_with(rhs)) {
+        return true;
+    }
+    if(lhs.size() != rhs.size()) {
+        return false;
+    }
+    for(auto l = lhs.begin(), r = rhs.begin(); l != lhs.end(); ++l, ++r) {
+        if(!(*l == *r)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T>
+bool operator!=(const persistent_vector<T>& lhs, const persistent_vector<T>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T>
+void swap(persistent_vector<T>& lhs, persistent_vector<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
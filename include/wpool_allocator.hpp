@@ -0,0 +1,375 @@
+#ifndef W_POOL_ALLOCATOR_HPP__
+#define W_POOL_ALLOCATOR_HPP__
+
+/**
+ * @file wpool_allocator.hpp
+ * @brief fixed size block allocator for node based containers
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include "utils.hpp"
+#include "wconstruct.hpp"
+
+// blocks carved from one chunk when the free list runs dry
+#ifndef POOL_ALLOCATOR_CHUNK_BLOCKS
+#define POOL_ALLOCATOR_CHUNK_BLOCKS 1024
+#endif
+
+namespace wstl
+{
+
+/**
+ * @brief drop-in for wstl::allocator<T> that serves single objects from a free list
+ * @note    1. allocate() / deallocate(p) hand out sizeof(T) blocks carved from
+ *             chunks of POOL_ALLOCATOR_CHUNK_BLOCKS, no per-node malloc header
+ *          2. arrays (n != 1) go to ::operator new, so pass n back to deallocate
+ *          3. each thread has its own pool; a chunk records its pool, so a
+ *             block freed by another thread goes back to the owner through a
+ *             lock-free stack that the owner drains when its free list runs dry
+ *          4. chunks are kept while the thread lives, when it exits the pool is
+ *             freed as soon as the last of its blocks comes back
+ *          5. chunks are aligned to their power of two size, which is how a
+ *             block finds its chunk without a per-node header
+ */
+template <class T>
+class pool_allocator
+{
+public:
+    typedef T               value_type;
+    typedef T*              pointer;
+    typedef const T*        const_pointer;
+    typedef T&              reference;
+    typedef const T&        const_reference;
+    typedef size_t          size_type;
+    typedef ptrdiff_t       difference_type;
+public:
+    static T* allocate();
+    static T* allocate(size_type n);
+
+    static void deallocate(T* ptr);
+    static void deallocate(T* ptr, size_type n);
+
+    static void construct(T* ptr);
+    static void construct(T* ptr, const T&value);
+    static void construct(T* ptr, T&& value);
+
+    template <class ...Args>
+    static void construct(T* ptr, Args&& ...args);
+
+    static void destroy(T* ptr);
+    static void destroy(T* first, T* last);
+
+    // chunks currently allocated for T by all threads
+    static size_t chunk_count() noexcept {
+        return chunks_live().load(std::memory_order_relaxed);
+    }
+
+private:
+    union block
+    {
+        block*                                                      next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type  storage;
+    };
+
+    struct pool_core;
+
+    struct chunk_link
+    {
+        pool_core*  owner;
+        void*       prev;
+    };
+
+    // a chunk starts with its owner and the link to the previous chunk, then the blocks
+    union chunk_header
+    {
+        chunk_link  link;
+        block       align;
+    };
+
+    struct pool_core
+    {
+        block*              free_list = nullptr;    // owner thread only
+        size_t              outstanding = 0;        // owner thread only, blocks not on free_list
+        void*               chunks = nullptr;
+        std::atomic<block*> remote_free{nullptr};   // blocks freed by other threads
+        std::atomic<long>   pending{0};             // blocks still out once the owner is gone
+    };
+
+    // destroys the calling thread's pool when the thread exits
+    struct owner_guard
+    {
+        ~owner_guard() {
+            pool_core* core = current_;
+            current_ = nullptr;
+            torn_down_ = true;
+            if(core) {
+                orphan(core);
+            }
+        }
+    };
+
+    static constexpr size_t pow2_at_least(size_t n, size_t p = 1) {
+        return p >= n ? p : pow2_at_least(n, p * 2);
+    }
+
+    static constexpr size_t chunk_bytes =
+        pow2_at_least(sizeof(chunk_header) + POOL_ALLOCATOR_CHUNK_BLOCKS * sizeof(block));
+    static constexpr size_t chunk_blocks = (chunk_bytes - sizeof(chunk_header)) / sizeof(block);
+
+    // both trivial, so they are still readable from destructors that run after owner_guard's
+    static thread_local pool_core*  current_;
+    static thread_local bool        torn_down_;
+
+    static std::atomic<size_t>& chunks_live() noexcept {
+        static std::atomic<size_t> count{0};
+        return count;
+    }
+
+    static block* orphan_tag() noexcept {
+        static block tag;
+        return &tag;
+    }
+
+    static chunk_header* chunk_of(void* p) noexcept {
+        return reinterpret_cast<chunk_header*>(reinterpret_cast<uintptr_t>(p) & ~(chunk_bytes - 1));
+    }
+
+    static pool_core* attach();
+    static void refill(pool_core* core);
+    static void reclaim(pool_core* core) noexcept;
+    static void free_remote(pool_core* core, block* b) noexcept;
+    static void orphan(pool_core* core) noexcept;
+    static void destroy_core(pool_core* core) noexcept;
+};
+
+template <class T>
+thread_local typename pool_allocator<T>::pool_core* pool_allocator<T>::current_ = nullptr;
+
+template <class T>
+thread_local bool pool_allocator<T>::torn_down_ = false;
+
+template <class T>
+constexpr size_t pool_allocator<T>::chunk_bytes;
+
+template <class T>
+constexpr size_t pool_allocator<T>::chunk_blocks;
+
+/*************** private ***************/
+
+// the calling thread's pool, created on first use
+template <class T>
+typename pool_allocator<T>::pool_core* pool_allocator<T>::attach()
+{
+    pool_core* core = new pool_core;
+    if(!torn_down_) {
+        static thread_local owner_guard guard;
+        (void)guard;
+        current_ = core;
+    }
+    return core;
+}
+
+template <class T>
+void pool_allocator<T>::refill(pool_core* core)
+{
+    void* raw = nullptr;
+    if(::posix_memalign(&raw, chunk_bytes, chunk_bytes) != 0) {
+        throw std::bad_alloc();
+    }
+    chunks_live().fetch_add(1, std::memory_order_relaxed);
+    chunk_header* header = static_cast<chunk_header*>(raw);
+    header->link.owner = core;
+    header->link.prev = core->chunks;
+    core->chunks = raw;
+
+    block* blocks = reinterpret_cast<block*>(header + 1);
+    for(size_t i = 0; i + 1 < chunk_blocks; ++i) {
+        blocks[i].next = blocks + i + 1;
+    }
+    blocks[chunk_blocks - 1].next = core->free_list;
+    core->free_list = blocks;
+}
+
+// move the blocks other threads freed onto the owner's free list
+template <class T>
+void pool_allocator<T>::reclaim(pool_core* core) noexcept
+{
+    block* head = core->remote_free.exchange(nullptr, std::memory_order_acquire);
+    if(nullptr == head) {
+        return;
+    }
+    block* tail = head;
+    --core->outstanding;
+    while (tail->next != nullptr)
+    {
+        tail = tail->next;
+        --core->outstanding;
+    }
+    tail->next = core->free_list;
+    core->free_list = head;
+}
+
+template <class T>
+void pool_allocator<T>::free_remote(pool_core* core, block* b) noexcept
+{
+    block* head = core->remote_free.load(std::memory_order_relaxed);
+    do
+    {
+        if(head == orphan_tag()) {
+            if(core->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                destroy_core(core);
+            }
+            return;
+        }
+        b->next = head;
+    } while (!core->remote_free.compare_exchange_weak(head, b, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+}
+
+/**
+ * @brief the owner is gone: close the remote stack, then whoever returns the
+ *        last outstanding block frees the pool
+ * @note pending only reaches zero once every block is back, the remote frees
+ *       that come before the owner's fetch_add leave it negative
+ */
+template <class T>
+void pool_allocator<T>::orphan(pool_core* core) noexcept
+{
+    block* head = core->remote_free.exchange(orphan_tag(), std::memory_order_acq_rel);
+    for(; head != nullptr; head = head->next) {
+        --core->outstanding;
+    }
+    const long out = static_cast<long>(core->outstanding);
+    if(core->pending.fetch_add(out, std::memory_order_acq_rel) + out == 0) {
+        destroy_core(core);
+    }
+}
+
+template <class T>
+void pool_allocator<T>::destroy_core(pool_core* core) noexcept
+{
+    void* chunk = core->chunks;
+    while (chunk != nullptr)
+    {
+        void* prev = static_cast<chunk_header*>(chunk)->link.prev;
+        ::free(chunk);
+        chunks_live().fetch_sub(1, std::memory_order_relaxed);
+        chunk = prev;
+    }
+    delete core;
+}
+
+/**************public **************/
+
+template <class T>
+T* pool_allocator<T>::allocate()
+{
+    pool_core* core = current_;
+    if(nullptr == core) {
+        core = attach();
+    }
+    if(nullptr == core->free_list) {
+        reclaim(core);
+        if(nullptr == core->free_list) {
+            try
+            {
+                refill(core);
+            }
+            catch(...)
+            {
+                if(core != current_) {
+                    delete core;
+                }
+                throw;
+            }
+        }
+    }
+    block* b = core->free_list;
+    core->free_list = b->next;
+    ++core->outstanding;
+    if(core != current_) {
+        // the thread is past its pool's teardown, the block is the pool's only user
+        orphan(core);
+    }
+    return reinterpret_cast<T*>(b);
+}
+
+template <class T>
+T* pool_allocator<T>::allocate(size_type n)
+{
+    if(0 == n) return nullptr;
+    if(1 == n) return allocate();
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr)
+{
+    if(nullptr == ptr) return;
+    block* b = reinterpret_cast<block*>(ptr);
+    pool_core* core = chunk_of(ptr)->link.owner;
+    if(core == current_) {
+        b->next = core->free_list;
+        core->free_list = b;
+        --core->outstanding;
+        return;
+    }
+    free_remote(core, b);
+}
+
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr, size_type n)
+{
+    if(nullptr == ptr) return;
+    if(1 == n) {
+        deallocate(ptr);
+        return;
+    }
+    ::operator delete(ptr);
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr)
+{
+    wstl::construct(ptr);
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr, const T&value)
+{
+    wstl::construct(ptr, value);
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr, T&& value)
+{
+    wstl::construct(ptr, wstl::move(value));
+}
+
+template <class T>
+template <class ...Args>
+void pool_allocator<T>::construct(T* ptr, Args&& ...args)
+{
+    wstl::construct(ptr, wstl::forward<Args>(args)...);
+}
+
+template <class T>
+void pool_allocator<T>::destroy(T* ptr)
+{
+    wstl::destroy(ptr);
+}
+
+template <class T>
+void pool_allocator<T>::destroy(T* first, T* last)
+{
+    wstl::destroy(first, last);
+}
+
+}   // wstl
+
+#endif
@@ -84,6 +84,11 @@ public:
         return c_.empty();
     }
 
+    // the underlying container, front() is its first element
+    const container_type& get_container() const noexcept {
+        return c_;
+    }
+
     // modify value of container
     template <class ...Args>
     void emplace(Args&& ...args) {
@@ -248,6 +253,11 @@ public:
         return c_.size();
     }
 
+    // the underlying container in heap order
+    const container_type& get_container() const noexcept {
+        return c_;
+    }
+
     // modify
     template <class... Args>
     void emplace(Args&& ...args)
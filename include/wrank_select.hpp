@@ -0,0 +1,283 @@
+#ifndef WRANK_SELECT_HPP__
+#define WRANK_SELECT_HPP__
+
+/**
+ * @file wrank_select.hpp
+ * @brief A static bitvector with constant time rank and sampled select
+ */
+
+#include "wvector.hpp"
+
+#include <cstdint>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace wstl
+{
+
+// one select sample every RANK_SELECT_SAMPLE ones (and zeros)
+#ifndef RANK_SELECT_SAMPLE
+#define RANK_SELECT_SAMPLE 512
+#endif
+
+/**
+ * @brief position of the r-th (0-based) set bit of w, r < popcount(w)
+ */
+inline size_t select_in_word(uint64_t w, size_t r) noexcept
+{
+#if defined(__BMI2__)
+    return bit_ctz(_pdep_u64(uint64_t(1) << r, w));
+#else
+    size_t base = 0;
+    size_t c = bit_popcount(w & 0xffffffffull);
+    if(r >= c) {
+        r -= c;
+        w >>= 32;
+        base = 32;
+    }
+    while (r >= (c = bit_popcount(w & 0xff)))
+    {
+        r -= c;
+        w >>= 8;
+        base += 8;
+    }
+    for(; r > 0; --r) {
+        w &= w - 1;
+    }
+    return base + bit_ctz(w);
+#endif
+}
+
+/**
+ * @brief rank9 over a bitvector that does not change after construction
+ * @note    1. every 512-bit block keeps two words: the number of ones before the
+ *             block, and seven 9-bit counts of ones before each of its words, so
+ *             rank is two loads and a popcount (25% extra space)
+ *          2. select jumps to the block of the sampled one (every
+ *             RANK_SELECT_SAMPLE ones) below the target, binary searches the
+ *             blocks up to the next sample, then the word, then the bit
+ *          3. select0 works the same way on the complemented counts, with its
+ *             own samples
+ *          4. the words are owned, bits at and past size() are cleared
+ */
+class rank_select
+{
+public:
+    typedef uint64_t    word_type;
+    typedef size_t      size_type;
+
+    static const size_type word_bits = 64;
+    static const size_type block_words = 8;
+    static const size_type block_bits = word_bits * block_words;
+
+private:
+    wstl::vector<word_type> words_;     // one zero word past the end
+    wstl::vector<word_type> counts_;    // per block: ones before, packed sub-counts
+    wstl::vector<size_type> samples1_;  // block of the (i * RANK_SELECT_SAMPLE)-th one
+    wstl::vector<size_type> samples0_;
+    size_type               size_;
+    size_type               ones_;
+
+public:
+    rank_select() : size_(0), ones_(0) {
+        build();
+    }
+
+    /**
+     * @param bits number of valid bits, at most 64 * words.size()
+     */
+    rank_select(wstl::vector<word_type> words, size_type bits)
+        : words_(wstl::move(words)), size_(bits), ones_(0) {
+        THROW_OUT_OF_RANGE_IF(bits > words_.size() * word_bits, "rank_select bits out of range");
+        build();
+    }
+
+    explicit rank_select(const wstl::vector<bool>& bits)
+        : words_(bits.data(), bits.data() + bits.word_count()), size_(bits.size()), ones_(0) {
+        build();
+    }
+
+public:
+    size_type size() const noexcept {
+        return size_;
+    }
+
+    size_type ones() const noexcept {
+        return ones_;
+    }
+
+    size_type zeros() const noexcept {
+        return size_ - ones_;
+    }
+
+    bool test(size_type pos) const noexcept {
+        WSTL_DEBUG(pos < size_);
+        return (words_.begin()[pos / word_bits] >> (pos % word_bits)) & 1;
+    }
+
+    /**
+     * @brief number of ones in [0, pos), pos <= size()
+     */
+    size_type rank1(size_type pos) const noexcept {
+        WSTL_DEBUG(pos <= size_);
+        const size_type w = pos / word_bits;
+        const size_type b = w / block_words;
+        const int64_t t = static_cast<int64_t>(w % block_words) - 1;
+        // t == -1 shifts by 63, where the packed word is always 0
+        const word_type rel = counts_.begin()[2 * b + 1] >> ((t + ((t >> 60) & 8)) * 9);
+        const word_type bits = words_.begin()[w] & ((word_type(1) << (pos % word_bits)) - 1);
+        return static_cast<size_type>(counts_.begin()[2 * b] + (rel & 0x1ff)) + bit_popcount(bits);
+    }
+
+    size_type rank0(size_type pos) const noexcept {
+        return pos - rank1(pos);
+    }
+
+    /**
+     * @brief position of the k-th (0-based) one, k < ones()
+     */
+    size_type select1(size_type k) const noexcept {
+        WSTL_DEBUG(k < ones_);
+        return select_impl<true>(k);
+    }
+
+    /**
+     * @brief position of the k-th (0-based) zero, k < zeros()
+     */
+    size_type select0(size_type k) const noexcept {
+        WSTL_DEBUG(k < zeros());
+        return select_impl<false>(k);
+    }
+
+    const word_type* data() const noexcept {
+        return words_.data();
+    }
+
+    // the index on top of the bits
+    size_type overhead_bytes() const noexcept {
+        return (counts_.size() + 1) * sizeof(word_type) +
+               (samples1_.size() + samples0_.size()) * sizeof(size_type);
+    }
+
+private:
+    size_type block_count() const noexcept {
+        return counts_.size() / 2;
+    }
+
+    // ones (or zeros) before block b
+    template <bool Bit>
+    size_type block_rank(size_type b) const noexcept {
+        const size_type r = static_cast<size_type>(counts_.begin()[2 * b]);
+        return Bit ? r : b * block_bits - r;
+    }
+
+    // ones (or zeros) before word i of block b, 0 < i < 8
+    template <bool Bit>
+    size_type sub_rank(size_type b, size_type i) const noexcept {
+        const size_type r = static_cast<size_type>((counts_.begin()[2 * b + 1] >> (9 * (i - 1))) & 0x1ff);
+        return Bit ? r : i * word_bits - r;
+    }
+
+    template <bool Bit>
+    size_type select_impl(size_type k) const noexcept;
+
+    template <bool Bit>
+    void build_samples(wstl::vector<size_type>& samples);
+
+    void build();
+};
+
+/*************** private ***************/
+
+template <bool Bit>
+rank_select::size_type rank_select::select_impl(size_type k) const noexcept
+{
+    const wstl::vector<size_type>& samples = Bit ? samples1_ : samples0_;
+    const size_type s = k / RANK_SELECT_SAMPLE;
+    size_type lo = samples.begin()[s];
+    size_type hi = s + 1 < samples.size() ? samples.begin()[s + 1] : block_count() - 1;
+
+    // last block in [lo, hi] with block_rank <= k
+    while (lo < hi)
+    {
+        const size_type mid = lo + (hi - lo + 1) / 2;
+        if(block_rank<Bit>(mid) <= k) {
+            lo = mid;
+        }
+        else {
+            hi = mid - 1;
+        }
+    }
+    k -= block_rank<Bit>(lo);
+
+    size_type i = 1;
+    while (i < block_words && sub_rank<Bit>(lo, i) <= k)
+    {
+        ++i;
+    }
+    --i;
+    if(i > 0) {
+        k -= sub_rank<Bit>(lo, i);
+    }
+
+    const size_type w = lo * block_words + i;
+    const word_type word = Bit ? words_.begin()[w] : ~words_.begin()[w];
+    return w * word_bits + select_in_word(word, k);
+}
+
+template <bool Bit>
+void rank_select::build_samples(wstl::vector<size_type>& samples)
+{
+    const size_type n = Bit ? ones_ : zeros();
+    const size_type nblocks = block_count();
+    size_type next = 0;
+    for(size_type b = 0; b < nblocks && next < n; ++b) {
+        const size_type end = b + 1 < nblocks ? block_rank<Bit>(b + 1) : n;
+        while (next < end && next < n)
+        {
+            samples.push_back(b);
+            next += RANK_SELECT_SAMPLE;
+        }
+    }
+}
+
+inline void rank_select::build()
+{
+    const size_type nwords = (size_ + word_bits - 1) / word_bits;
+    while (words_.size() > nwords)
+    {
+        words_.pop_back();
+    }
+    if(size_ % word_bits) {
+        words_[nwords - 1] &= ~word_type(0) >> (word_bits - size_ % word_bits);
+    }
+    // rank1(size()) may read the word at size() / 64
+    words_.push_back(0);
+
+    const size_type nblocks = nwords / block_words + 1;
+    counts_.reserve(2 * nblocks);
+    size_type total = 0;
+    for(size_type b = 0; b < nblocks; ++b) {
+        word_type rel = 0;
+        size_type c = 0;
+        for(size_type i = 0; i < block_words; ++i) {
+            if(i > 0) {
+                rel |= static_cast<word_type>(c) << (9 * (i - 1));
+            }
+            const size_type w = b * block_words + i;
+            c += w < nwords ? bit_popcount(words_[w]) : 0;
+        }
+        counts_.push_back(total);
+        counts_.push_back(rel);
+        total += c;
+    }
+    ones_ = total;
+    build_samples<true>(samples1_);
+    build_samples<false>(samples0_);
+}
+
+}   // wstl
+
+#endif
@@ -0,0 +1,542 @@
+#ifndef WSEGMENTED_VECTOR_HPP__
+#define WSEGMENTED_VECTOR_HPP__
+
+/**
+ * @file wsegmented_vector.hpp
+ * @brief An append-only random access sequence whose elements never move
+ */
+
+#include "witerator.hpp"
+#include "wmemory.hpp"
+#include "walgorithm.hpp"
+#include "wspan.hpp"
+
+#include <climits>
+#include <initializer_list>
+#include <type_traits>
+
+namespace wstl
+{
+
+// the first segment holds 1 << SEGMENTED_VECTOR_FIRST_SHIFT elements
+#ifndef SEGMENTED_VECTOR_FIRST_SHIFT
+#define SEGMENTED_VECTOR_FIRST_SHIFT 4
+#endif
+
+// index of the highest set bit, n must not be 0
+inline size_t segmented_vector_msb(size_t n) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * CHAR_BIT - 1 - static_cast<size_t>(__builtin_clzll(n));
+#else
+    size_t r = 0;
+    while (n >>= 1)
+    {
+        ++r;
+    }
+    return r;
+#endif
+}
+
+template <class T, class Ref, class Ptr, size_t Shift>
+struct segmented_vector_iterator : public wstl::iterator<wstl::random_access_iterator_tag, T>
+{
+    typedef T                                                   value_type;
+    typedef Ptr                                                 pointer;
+    typedef Ref                                                 reference;
+    typedef ptrdiff_t                                           difference_type;
+    typedef size_t                                              size_type;
+    typedef T* const*                                           map_pointer;
+    typedef segmented_vector_iterator<T, T&, T*, Shift>         iterator;
+    typedef segmented_vector_iterator                           self;
+
+    map_pointer map_;
+    size_type   seg_;
+    T*          cur_;
+    T*          first_;
+    T*          last_;
+
+    segmented_vector_iterator() noexcept
+        : map_(nullptr), seg_(0), cur_(nullptr), first_(nullptr), last_(nullptr) {}
+
+    segmented_vector_iterator(map_pointer map, size_type index) noexcept : map_(map) {
+        locate(index);
+    }
+
+    // iterator -> const_iterator, a template so the implicit copy operations stay
+    template <class R, class P, typename std::enable_if<
+        std::is_same<segmented_vector_iterator<T, R, P, Shift>, iterator>::value, int>::type = 0>
+    segmented_vector_iterator(const segmented_vector_iterator<T, R, P, Shift>& rhs) noexcept
+        : map_(rhs.map_), seg_(rhs.seg_), cur_(rhs.cur_), first_(rhs.first_), last_(rhs.last_) {}
+
+    // position in the whole sequence
+    size_type index() const noexcept {
+        return ((size_type(1) << Shift) << seg_) - (size_type(1) << Shift) +
+               static_cast<size_type>(cur_ - first_);
+    }
+
+    void locate(size_type index) noexcept {
+        const size_type u = index + (size_type(1) << Shift);
+        seg_ = segmented_vector_msb(u) - Shift;
+        first_ = map_[seg_];
+        // end() may sit at the start of a segment that is not allocated yet
+        last_ = first_ ? first_ + ((size_type(1) << Shift) << seg_) : nullptr;
+        cur_ = first_ ? first_ + (u - ((size_type(1) << Shift) << seg_)) : nullptr;
+    }
+
+    reference operator*() const {
+        return *cur_;
+    }
+    pointer operator->() const {
+        return cur_;
+    }
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    self& operator++() {
+        if(++cur_ == last_) {
+            ++seg_;
+            first_ = cur_ = map_[seg_];
+            last_ = first_ ? first_ + ((size_type(1) << Shift) << seg_) : nullptr;
+        }
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    self& operator--() {
+        if(cur_ == first_) {
+            --seg_;
+            first_ = map_[seg_];
+            last_ = cur_ = first_ + ((size_type(1) << Shift) << seg_);
+        }
+        --cur_;
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+    self& operator+=(difference_type n) {
+        const difference_type off = static_cast<difference_type>(cur_ - first_) + n;
+        if(off >= 0 && off < static_cast<difference_type>(last_ - first_)) {
+            cur_ = first_ + off;
+        }
+        else {
+            locate(static_cast<size_type>(static_cast<difference_type>(index()) + n));
+        }
+        return *this;
+    }
+    self& operator-=(difference_type n) {
+        return *this += -n;
+    }
+    self operator+(difference_type n) const {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self operator-(difference_type n) const {
+        self tmp = *this;
+        return tmp -= n;
+    }
+    difference_type operator-(const self& rhs) const {
+        return static_cast<difference_type>(index()) - static_cast<difference_type>(rhs.index());
+    }
+
+    bool operator==(const self& rhs) const {
+        return seg_ == rhs.seg_ && cur_ == rhs.cur_;
+    }
+    bool operator!=(const self& rhs) const {
+        return !(*this == rhs);
+    }
+    bool operator<(const self& rhs) const {
+        return seg_ < rhs.seg_ || (seg_ == rhs.seg_ && cur_ < rhs.cur_);
+    }
+    bool operator>(const self& rhs) const {
+        return rhs < *this;
+    }
+    bool operator<=(const self& rhs) const {
+        return !(rhs < *this);
+    }
+    bool operator>=(const self& rhs) const {
+        return !(*this < rhs);
+    }
+};
+
+/**
+ * @brief A random access sequence built from segments of doubling size
+ * @note    1. segment k holds B << k elements (B = 1 << Shift) and is never
+ *             reallocated, so growth copies nothing and pointers, references
+ *             and iterators to elements stay valid until the element is removed
+ *          2. element i lives in segment msb(i + B) - Shift, at offset
+ *             i + B - (B << k): indexing is one count-leading-zeros away
+ *          3. the map is a fixed array with a slot for every possible segment,
+ *             like deque's map without its reallocation
+ *          4. only the back grows and shrinks, the segments stay allocated
+ *             until shrink_to_fit()
+ */
+template <class T, size_t Shift = SEGMENTED_VECTOR_FIRST_SHIFT>
+class segmented_vector
+{
+public:
+    typedef wstl::allocator<T>                          allocator_type;
+    typedef wstl::allocator<T>                          data_allocator;
+    typedef typename allocator_type::value_type         value_type;
+    typedef typename allocator_type::pointer            pointer;
+    typedef typename allocator_type::const_pointer      const_pointer;
+    typedef typename allocator_type::reference          reference;
+    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_type::size_type          size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef segmented_vector_iterator<T, T&, T*, Shift>             iterator;
+    typedef segmented_vector_iterator<T, const T&, const T*, Shift> const_iterator;
+    typedef wstl::reverse_iterator<iterator>                        reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>                  const_reverse_iterator;
+    typedef span<T>                                                 span_type;
+    typedef span<const T>                                           const_span_type;
+
+    static const size_type first_segment_size = size_type(1) << Shift;
+    static const size_type max_segments = sizeof(size_type) * CHAR_BIT - Shift;
+
+    static_assert(Shift < sizeof(size_type) * CHAR_BIT - 1, "segmented_vector Shift too large");
+
+private:
+    T*          map_[max_segments + 1];     // one spare null slot, end() of a full segment points there
+    size_type   size_;
+    size_type   segments_;                  // allocated segments, a prefix of map_
+
+public:
+    segmented_vector() noexcept : map_(), size_(0), segments_(0) {}
+
+    explicit segmented_vector(size_type n) : segmented_vector(n, value_type()) {}
+
+    segmented_vector(size_type n, const value_type& value) : map_(), size_(0), segments_(0) {
+        try
+        {
+            resize(n, value);
+        }
+        catch(...)
+        {
+            clear();
+            release();
+            throw;
+        }
+    }
+
+    template <class Iter, typename std::enable_if<
+            wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    segmented_vector(Iter first, Iter last) : map_(), size_(0), segments_(0) {
+        try
+        {
+            for(; first != last; ++first) {
+                push_back(*first);
+            }
+        }
+        catch(...)
+        {
+            clear();
+            release();
+            throw;
+        }
+    }
+
+    segmented_vector(std::initializer_list<value_type> _list)
+        : segmented_vector(_list.begin(), _list.end()) {}
+
+    segmented_vector(const segmented_vector& rhs) : segmented_vector(rhs.begin(), rhs.end()) {}
+
+    segmented_vector(segmented_vector&& rhs) noexcept : size_(rhs.size_), segments_(rhs.segments_) {
+        for(size_type k = 0; k <= max_segments; ++k) {
+            map_[k] = rhs.map_[k];
+            rhs.map_[k] = nullptr;
+        }
+        rhs.size_ = 0;
+        rhs.segments_ = 0;
+    }
+
+    segmented_vector& operator=(const segmented_vector& rhs) {
+        if(this != &rhs) {
+            segmented_vector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    segmented_vector& operator=(segmented_vector&& rhs) noexcept {
+        segmented_vector tmp(wstl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    ~segmented_vector() {
+        clear();
+        release();
+    }
+
+public:
+    // iterator
+    iterator begin() noexcept {
+        return iterator(map_, 0);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(map_, 0);
+    }
+    iterator end() noexcept {
+        return iterator(map_, size_);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(map_, size_);
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(T);
+    }
+    size_type capacity() const noexcept {
+        return segment_begin(segments_);
+    }
+    void reserve(size_type n);
+    void shrink_to_fit() noexcept;
+
+    // visit
+    reference operator[](size_type n) {
+        WSTL_DEBUG(n < size_);
+        return *address(n);
+    }
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return *address(n);
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "segmented_vector<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "segmented_vector<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return *map_[0];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return *map_[0];
+    }
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return *address(size_ - 1);
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return *address(size_ - 1);
+    }
+
+    // the used part of every segment, for loops that want plain arrays
+    size_type segment_count() const noexcept {
+        return 0 == size_ ? 0 : segment_of(size_ - 1) + 1;
+    }
+    span_type segment(size_type k) noexcept {
+        WSTL_DEBUG(k < segment_count());
+        return span_type{map_[k], segment_used(k)};
+    }
+    const_span_type segment(size_type k) const noexcept {
+        WSTL_DEBUG(k < segment_count());
+        return const_span_type{map_[k], segment_used(k)};
+    }
+
+    // modify
+    template <class ...Args>
+    reference emplace_back(Args&& ...args);
+
+    void push_back(const value_type& value) {
+        emplace_back(value);
+    }
+    void push_back(value_type&& value) {
+        emplace_back(wstl::move(value));
+    }
+
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        --size_;
+        data_allocator::destroy(address(size_));
+    }
+
+    void resize(size_type n) {
+        resize(n, value_type());
+    }
+    void resize(size_type n, const value_type& value);
+
+    void clear() noexcept {
+        while (size_ > 0)
+        {
+            pop_back();
+        }
+    }
+
+    void swap(segmented_vector& rhs) noexcept {
+        for(size_type k = 0; k <= max_segments; ++k) {
+            wstl::swap(map_[k], rhs.map_[k]);
+        }
+        wstl::swap(size_, rhs.size_);
+        wstl::swap(segments_, rhs.segments_);
+    }
+
+private:
+    static size_type segment_of(size_type n) noexcept {
+        return segmented_vector_msb(n + first_segment_size) - Shift;
+    }
+    // index of the first element of segment k
+    static size_type segment_begin(size_type k) noexcept {
+        return (first_segment_size << k) - first_segment_size;
+    }
+    size_type segment_used(size_type k) const noexcept {
+        const size_type end = segment_begin(k + 1);
+        return (size_ < end ? size_ : end) - segment_begin(k);
+    }
+    T* address(size_type n) const noexcept {
+        const size_type u = n + first_segment_size;
+        const size_type k = segmented_vector_msb(u) - Shift;
+        return map_[k] + (u - (first_segment_size << k));
+    }
+
+    void add_segment();
+    void release() noexcept;
+};
+
+template <class T, size_t Shift>
+const typename segmented_vector<T, Shift>::size_type segmented_vector<T, Shift>::first_segment_size;
+
+template <class T, size_t Shift>
+const typename segmented_vector<T, Shift>::size_type segmented_vector<T, Shift>::max_segments;
+
+/*************** private ***************/
+
+template <class T, size_t Shift>
+void segmented_vector<T, Shift>::add_segment()
+{
+    THROW_LENGTH_ERROR_IF(segments_ >= max_segments || segment_begin(segments_) >= max_size(),
+                          "segmented_vector<T>'s size too big");
+    map_[segments_] = data_allocator::allocate(first_segment_size << segments_);
+    ++segments_;
+}
+
+// frees the segments, the elements must be destroyed already
+template <class T, size_t Shift>
+void segmented_vector<T, Shift>::release() noexcept
+{
+    while (segments_ > 0)
+    {
+        --segments_;
+        data_allocator::deallocate(map_[segments_], first_segment_size << segments_);
+        map_[segments_] = nullptr;
+    }
+}
+
+/**************public **************/
+
+template <class T, size_t Shift>
+template <class ...Args>
+typename segmented_vector<T, Shift>::reference segmented_vector<T, Shift>::emplace_back(Args&& ...args)
+{
+    if(size_ == capacity()) {
+        add_segment();
+    }
+    T* p = address(size_);
+    data_allocator::construct(p, wstl::forward<Args>(args)...);
+    ++size_;
+    return *p;
+}
+
+/**
+ * @brief allocate segments up to [n] elements, nothing moves
+ */
+template <class T, size_t Shift>
+void segmented_vector<T, Shift>::reserve(size_type n)
+{
+    THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in segmented_vector<T>::reserve(n)");
+    while (capacity() < n)
+    {
+        add_segment();
+    }
+}
+
+/**
+ * @brief free the segments past the one that holds back()
+ */
+template <class T, size_t Shift>
+void segmented_vector<T, Shift>::shrink_to_fit() noexcept
+{
+    const size_type keep = segment_count();
+    while (segments_ > keep)
+    {
+        --segments_;
+        data_allocator::deallocate(map_[segments_], first_segment_size << segments_);
+        map_[segments_] = nullptr;
+    }
+}
+
+template <class T, size_t Shift>
+void segmented_vector<T, Shift>::resize(size_type n, const value_type& value)
+{
+    while (size_ > n)
+    {
+        pop_back();
+    }
+    reserve(n);
+    while (size_ < n)
+    {
+        emplace_back(value);
+    }
+}
+
+template <class T, size_t Shift>
+bool operator==(const segmented_vector<T, Shift>& lhs, const segmented_vector<T, Shift>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        wstl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t Shift>
+bool operator!=(const segmented_vector<T, Shift>& lhs, const segmented_vector<T, Shift>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, size_t Shift>
+void swap(segmented_vector<T, Shift>& lhs, segmented_vector<T, Shift>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
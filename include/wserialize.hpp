@@ -0,0 +1,355 @@
+#ifndef WSERIALIZE_HPP__
+#define WSERIALIZE_HPP__
+
+/**
+ * @file wserialize.hpp
+ * @brief Binary snapshots of wstl containers over std::ostream / std::istream
+ * @note    1. a container is a uint64_t element count followed by its elements,
+ *             all in native byte order, for reading back on the same platform
+ *          2. elements that are bitwise serializable (trivially copyable unless
+ *             specialized) go out as one write per contiguous run: one for a
+ *             vector, one per buffer for a deque
+ *          3. reads size the container with resize_for_overwrite() and fill the
+ *             storage with one read per run, no element is constructed first
+ *          4. the count comes from the input, so reads grow the container
+ *             SERIALIZE_READ_CHUNK bytes at a time and a bogus count fails on
+ *             the short read before it commits much memory; when the stream
+ *             can seek and holds all the bytes, a vector is reserved at once
+ *          5. a short read, a count past max_size() or a failed write throws
+ *             std::runtime_error, the container being read is then valid but
+ *             unspecified
+ */
+
+#include "wvector.hpp"
+#include "wdeque.hpp"
+#include "wlist.hpp"
+#include "wqueue.hpp"
+#include "wstack.hpp"
+#include "wexcepdef.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// bytes a read commits to the container before the input has to back them
+#ifndef SERIALIZE_READ_CHUNK
+#define SERIALIZE_READ_CHUNK (1 << 20)
+#endif
+
+namespace wstl
+{
+
+// specialize to false_type for trivially copyable types that own pointers
+template <class T>
+struct is_bitwise_serializable : public std::is_trivially_copyable<T> {};
+
+inline void serialize_write(std::ostream& os, const void* p, size_t bytes)
+{
+    os.write(static_cast<const char*>(p), static_cast<std::streamsize>(bytes));
+    THROW_RUNTIME_ERROR_IF(!os, "serialize: write failed");
+}
+
+inline void serialize_read(std::istream& is, void* p, size_t bytes)
+{
+    is.read(static_cast<char*>(p), static_cast<std::streamsize>(bytes));
+    THROW_RUNTIME_ERROR_IF(static_cast<size_t>(is.gcount()) != bytes, "deserialize: unexpected end of input");
+}
+
+inline void serialize_size(std::ostream& os, size_t n)
+{
+    const uint64_t len = n;
+    serialize_write(os, &len, sizeof(len));
+}
+
+inline size_t deserialize_size(std::istream& is, size_t max_size)
+{
+    uint64_t len = 0;
+    serialize_read(is, &len, sizeof(len));
+    THROW_RUNTIME_ERROR_IF(len > max_size, "deserialize: element count too big");
+    return static_cast<size_t>(len);
+}
+
+// elements read per step when the input is not known to hold them all
+template <class T>
+constexpr size_t deserialize_step() noexcept
+{
+    return SERIALIZE_READ_CHUNK / sizeof(T) > 0 ? SERIALIZE_READ_CHUNK / sizeof(T) : 1;
+}
+
+// true when the stream can seek and has at least n * elem_bytes bytes left
+inline bool deserialize_holds(std::istream& is, size_t n, size_t elem_bytes)
+{
+    std::streambuf* sb = is.rdbuf();
+    if(nullptr == sb) {
+        return false;
+    }
+    const std::streamoff cur = sb->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+    if(cur < 0) {
+        return false;
+    }
+    const std::streamoff end = sb->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+    sb->pubseekoff(cur, std::ios_base::beg, std::ios_base::in);
+    return end >= cur && n <= static_cast<uint64_t>(end - cur) / elem_bytes;
+}
+
+// declared up front so that nested containers find each other
+
+template <class T, typename std::enable_if<is_bitwise_serializable<T>::value, int>::type = 0>
+void serialize(std::ostream& os, const T& value);
+template <class T, typename std::enable_if<is_bitwise_serializable<T>::value, int>::type = 0>
+void deserialize(std::istream& is, T& value);
+
+inline void serialize(std::ostream& os, const std::string& s);
+inline void deserialize(std::istream& is, std::string& s);
+
+template <class T>
+void serialize(std::ostream& os, const vector<T>& v);
+template <class T>
+void deserialize(std::istream& is, vector<T>& v);
+
+inline void serialize(std::ostream& os, const vector<bool>& v);
+inline void deserialize(std::istream& is, vector<bool>& v);
+
+template <class T, size_t BufSize>
+void serialize(std::ostream& os, const deque<T, BufSize>& d);
+template <class T, size_t BufSize>
+void deserialize(std::istream& is, deque<T, BufSize>& d);
+
+template <class T>
+void serialize(std::ostream& os, const list<T>& l);
+template <class T>
+void deserialize(std::istream& is, list<T>& l);
+
+template <class T, class Container>
+void serialize(std::ostream& os, const queue<T, Container>& q);
+template <class T, class Container>
+void deserialize(std::istream& is, queue<T, Container>& q);
+
+template <class T, class Container>
+void serialize(std::ostream& os, const stack<T, Container>& s);
+template <class T, class Container>
+void deserialize(std::istream& is, stack<T, Container>& s);
+
+template <class T, class Container, class Compare>
+void serialize(std::ostream& os, const priority_queue<T, Container, Compare>& q);
+template <class T, class Container, class Compare>
+void deserialize(std::istream& is, priority_queue<T, Container, Compare>& q);
+
+/******************************************* */
+// contiguous runs
+
+template <class T>
+void serialize_run(std::ostream& os, const T* first, size_t n, std::true_type)
+{
+    serialize_write(os, first, n * sizeof(T));
+}
+
+template <class T>
+void serialize_run(std::ostream& os, const T* first, size_t n, std::false_type)
+{
+    for(size_t i = 0; i < n; ++i) {
+        serialize(os, first[i]);
+    }
+}
+
+template <class T>
+void deserialize_run(std::istream& is, T* first, size_t n, std::true_type)
+{
+    serialize_read(is, first, n * sizeof(T));
+}
+
+template <class T>
+void deserialize_run(std::istream& is, T* first, size_t n, std::false_type)
+{
+    for(size_t i = 0; i < n; ++i) {
+        deserialize(is, first[i]);
+    }
+}
+
+/******************************************* */
+// elements
+
+template <class T, typename std::enable_if<is_bitwise_serializable<T>::value, int>::type>
+void serialize(std::ostream& os, const T& value)
+{
+    serialize_write(os, &value, sizeof(T));
+}
+
+template <class T, typename std::enable_if<is_bitwise_serializable<T>::value, int>::type>
+void deserialize(std::istream& is, T& value)
+{
+    serialize_read(is, &value, sizeof(T));
+}
+
+inline void serialize(std::ostream& os, const std::string& s)
+{
+    serialize_size(os, s.size());
+    serialize_write(os, s.data(), s.size());
+}
+
+inline void deserialize(std::istream& is, std::string& s)
+{
+    const size_t n = deserialize_size(is, s.max_size());
+    s.clear();
+    if(deserialize_holds(is, n, 1)) {
+        s.reserve(n);
+    }
+    for(size_t done = 0; done < n; ) {
+        const size_t m = wstl::min(deserialize_step<char>(), n - done);
+        s.resize(done + m);
+        serialize_read(is, &s[done], m);
+        done += m;
+    }
+}
+
+/******************************************* */
+// containers
+
+template <class T>
+void serialize(std::ostream& os, const vector<T>& v)
+{
+    serialize_size(os, v.size());
+    serialize_run(os, v.data(), v.size(), is_bitwise_serializable<T>());
+}
+
+template <class T>
+void deserialize(std::istream& is, vector<T>& v)
+{
+    const size_t n = deserialize_size(is, v.max_size());
+    v.clear();
+    if(is_bitwise_serializable<T>::value && deserialize_holds(is, n, sizeof(T))) {
+        v.reserve(n);
+    }
+    for(size_t done = 0; done < n; ) {
+        const size_t m = wstl::min(deserialize_step<T>(), n - done);
+        v.resize_for_overwrite(done + m);
+        deserialize_run(is, v.data() + done, m, is_bitwise_serializable<T>());
+        done += m;
+    }
+}
+
+// the bit count, then the packed words
+inline void serialize(std::ostream& os, const vector<bool>& v)
+{
+    serialize_size(os, v.size());
+    serialize_write(os, v.data(), v.word_count() * sizeof(bit_word));
+}
+
+inline void deserialize(std::istream& is, vector<bool>& v)
+{
+    const size_t n = deserialize_size(is, v.max_size());
+    v.clear();
+    // whole words per step, so each step starts on a word boundary
+    const size_t step = deserialize_step<bit_word>() * bit_word_bits;
+    for(size_t done = 0; done < n; ) {
+        const size_t m = wstl::min(step, n - done);
+        v.resize(done + m);
+        const size_t first_word = done / bit_word_bits;
+        serialize_read(is, v.data() + first_word, (v.word_count() - first_word) * sizeof(bit_word));
+        done += m;
+    }
+    // keep the bits past size() zero even for a damaged input
+    if(n % bit_word_bits != 0) {
+        v.data()[v.word_count() - 1] &= (bit_word(1) << (n % bit_word_bits)) - 1;
+    }
+}
+
+// one run per deque buffer
+template <class T, size_t BufSize>
+void serialize(std::ostream& os, const deque<T, BufSize>& d)
+{
+    serialize_size(os, d.size());
+    for(span<const T> chunk : d.segments()) {
+        serialize_run(os, chunk.data(), chunk.size(), is_bitwise_serializable<T>());
+    }
+}
+
+template <class T, size_t BufSize>
+void deserialize(std::istream& is, deque<T, BufSize>& d)
+{
+    const size_t n = deserialize_size(is, d.max_size());
+    d.clear();
+    for(size_t done = 0; done < n; ) {
+        const size_t m = wstl::min(deserialize_step<T>(), n - done);
+        d.resize_for_overwrite(done + m);
+        for(span<T> chunk : segmented_span<T, BufSize>(d.begin() + done, d.end())) {
+            deserialize_run(is, chunk.data(), chunk.size(), is_bitwise_serializable<T>());
+        }
+        done += m;
+    }
+}
+
+template <class T>
+void serialize(std::ostream& os, const list<T>& l)
+{
+    serialize_size(os, l.size());
+    for(const T& value : l) {
+        serialize(os, value);
+    }
+}
+
+template <class T>
+void deserialize(std::istream& is, list<T>& l)
+{
+    const size_t n = deserialize_size(is, l.max_size());
+    l.clear();
+    for(size_t i = 0; i < n; ++i) {
+        l.emplace_back();
+        deserialize(is, l.back());
+    }
+}
+
+/******************************************* */
+// adapters, written as their container
+
+template <class T, class Container>
+void serialize(std::ostream& os, const queue<T, Container>& q)
+{
+    serialize(os, q.get_container());
+}
+
+template <class T, class Container>
+void deserialize(std::istream& is, queue<T, Container>& q)
+{
+    Container c;
+    deserialize(is, c);
+    queue<T, Container> tmp(wstl::move(c));
+    q.swap(tmp);
+}
+
+template <class T, class Container>
+void serialize(std::ostream& os, const stack<T, Container>& s)
+{
+    serialize(os, s.get_container());
+}
+
+template <class T, class Container>
+void deserialize(std::istream& is, stack<T, Container>& s)
+{
+    Container c;
+    deserialize(is, c);
+    stack<T, Container> tmp(wstl::move(c));
+    s.swap(tmp);
+}
+
+template <class T, class Container, class Compare>
+void serialize(std::ostream& os, const priority_queue<T, Container, Compare>& q)
+{
+    serialize(os, q.get_container());
+}
+
+// the comparator is not stored, the queue comes back with a default Compare
+template <class T, class Container, class Compare>
+void deserialize(std::istream& is, priority_queue<T, Container, Compare>& q)
+{
+    Container c;
+    deserialize(is, c);
+    priority_queue<T, Container, Compare> tmp(wstl::move(c));
+    q.swap(tmp);
+}
+
+}   // wstl
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef WSLOT_MAP_HPP__
+#define WSLOT_MAP_HPP__
+
+#include "wvector.hpp"
+#include "functional.hpp"
+
+#include <cstdint>
+
+namespace wstl
+{
+
+/**
+ * @brief a handle into a slot_map, stays valid (or detectably stale) across erases
+ */
+struct slot_map_key
+{
+    uint32_t index;         // slot in the indirection table
+    uint32_t generation;    // bumped every time the slot is released
+};
+
+inline bool operator==(const slot_map_key& lhs, const slot_map_key& rhs) noexcept
+{
+    return lhs.index == rhs.index && lhs.generation == rhs.generation;
+}
+
+inline bool operator!=(const slot_map_key& lhs, const slot_map_key& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template <>
+struct hash<slot_map_key>
+{
+    size_t operator()(const slot_map_key& k) const noexcept {
+        return static_cast<size_t>((static_cast<unsigned long long>(k.generation) << 32) | k.index);
+    }
+};
+
+/**
+ * @brief Objects stored densely in a wstl::vector, addressed by generational keys
+ * @note    1. insert / erase / find are O(1): a key names a slot, the slot holds
+ *             the dense position and the generation the key must match
+ *          2. erase moves the last object into the hole (swap-and-pop), so the
+ *             values stay contiguous and a scan never skips holes, but iterators
+ *             and pointers are invalidated by erase and insert, keys are not
+ *          3. a key of an erased object never finds the object that later
+ *             reuses its slot, the generation differs
+ *          4. a slot whose generation would wrap is retired instead of reused
+ */
+template <class T>
+class slot_map
+{
+public:
+    typedef wstl::vector<T>                             value_container;
+    typedef typename value_container::value_type        value_type;
+    typedef typename value_container::size_type         size_type;
+    typedef typename value_container::reference         reference;
+    typedef typename value_container::const_reference   const_reference;
+    typedef typename value_container::pointer           pointer;
+    typedef typename value_container::const_pointer     const_pointer;
+    typedef typename value_container::iterator          iterator;
+    typedef typename value_container::const_iterator    const_iterator;
+    typedef slot_map_key                                key_type;
+
+private:
+    struct slot
+    {
+        uint32_t index;         // dense position while live, next free slot while free
+        uint32_t generation;
+    };
+
+    static const uint32_t npos = static_cast<uint32_t>(-1);
+
+    value_container         values_;
+    wstl::vector<uint32_t>  owners_;        // dense position -> slot
+    wstl::vector<slot>      slots_;
+    uint32_t                free_head_;
+
+public:
+    slot_map() noexcept : free_head_(npos) {}
+
+public:
+    // iterate over the values in dense order
+    iterator begin() noexcept {
+        return values_.begin();
+    }
+
+    const_iterator begin() const noexcept {
+        return values_.begin();
+    }
+
+    iterator end() noexcept {
+        return values_.end();
+    }
+
+    const_iterator end() const noexcept {
+        return values_.end();
+    }
+
+    bool empty() const noexcept {
+        return values_.empty();
+    }
+
+    size_type size() const noexcept {
+        return values_.size();
+    }
+
+    size_type capacity() const noexcept {
+        return values_.capacity();
+    }
+
+    void reserve(size_type n) {
+        values_.reserve(n);
+        owners_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    pointer data() noexcept {
+        return values_.data();
+    }
+
+    const_pointer data() const noexcept {
+        return values_.data();
+    }
+
+    // visit
+    // a free slot already carries the generation of its next key, so the slot
+    // must also be live: its dense position has to point back at it
+    bool contains(key_type key) const noexcept {
+        if(key.index >= slots_.size()) {
+            return false;
+        }
+        const slot& sl = slots_.begin()[key.index];
+        return sl.generation == key.generation && sl.index < owners_.size() &&
+               owners_.begin()[sl.index] == key.index;
+    }
+
+    pointer find(key_type key) noexcept {
+        return contains(key) ? values_.data() + slots_.begin()[key.index].index : nullptr;
+    }
+
+    const_pointer find(key_type key) const noexcept {
+        return contains(key) ? values_.data() + slots_.begin()[key.index].index : nullptr;
+    }
+
+    reference operator[](key_type key) {
+        WSTL_DEBUG(contains(key));
+        return values_[slots_[key.index].index];
+    }
+
+    const_reference operator[](key_type key) const {
+        WSTL_DEBUG(contains(key));
+        return values_.begin()[slots_.begin()[key.index].index];
+    }
+
+    reference at(key_type key) {
+        THROW_OUT_OF_RANGE_IF(!contains(key), "slot_map<T>::at() stale or invalid key");
+        return (*this)[key];
+    }
+
+    const_reference at(key_type key) const {
+        THROW_OUT_OF_RANGE_IF(!contains(key), "slot_map<T>::at() stale or invalid key");
+        return (*this)[key];
+    }
+
+    /**
+     * @brief the key of the object at dense position [pos], for scans that erase
+     */
+    key_type key_of(const_iterator pos) const noexcept {
+        const uint32_t s = owners_.begin()[pos - values_.begin()];
+        return key_type{s, slots_.begin()[s].generation};
+    }
+
+    // modify
+    template <class ...Args>
+    key_type emplace(Args&& ...args);
+
+    key_type insert(const value_type& value) {
+        return emplace(value);
+    }
+
+    key_type insert(value_type&& value) {
+        return emplace(wstl::move(value));
+    }
+
+    bool erase(key_type key);
+
+    /**
+     * @return the same position, which now holds the object moved from the back
+     */
+    iterator erase(const_iterator pos) {
+        const size_type n = static_cast<size_type>(pos - values_.begin());
+        release(owners_[n]);
+        return values_.begin() + n;
+    }
+
+    void clear() noexcept;
+
+    void swap(slot_map& rhs) noexcept {
+        values_.swap(rhs.values_);
+        owners_.swap(rhs.owners_);
+        slots_.swap(rhs.slots_);
+        wstl::swap(free_head_, rhs.free_head_);
+    }
+
+private:
+    void release(uint32_t s);
+};
+
+template <class T>
+const uint32_t slot_map<T>::npos;
+
+/*************** private ***************/
+
+/**
+ * @brief swap-and-pop the object of slot [s] and put [s] on the free list
+ */
+template <class T>
+void slot_map<T>::release(uint32_t s)
+{
+    slot& sl = slots_[s];
+    const uint32_t pos = sl.index;
+    const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+    if(pos != last) {
+        values_[pos] = wstl::move(values_[last]);
+        owners_[pos] = owners_[last];
+        slots_[owners_[pos]].index = pos;
+    }
+    values_.pop_back();
+    owners_.pop_back();
+
+    if(++sl.generation != 0) {
+        sl.index = free_head_;
+        free_head_ = s;
+    }
+}
+
+/**************public **************/
+
+template <class T>
+template <class ...Args>
+typename slot_map<T>::key_type slot_map<T>::emplace(Args&& ...args)
+{
+    THROW_LENGTH_ERROR_IF(values_.size() >= npos, "slot_map<T>'s size too big");
+
+    const uint32_t pos = static_cast<uint32_t>(values_.size());
+    values_.emplace_back(wstl::forward<Args>(args)...);
+
+    uint32_t s = free_head_;
+    const bool new_slot = npos == s;
+    try
+    {
+        if(new_slot) {
+            s = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(slot{pos, 1});
+        }
+        owners_.push_back(s);
+    }
+    catch(...)
+    {
+        // a slot pushed here is on no free list yet, take it back
+        if(new_slot && slots_.size() > s) {
+            slots_.pop_back();
+        }
+        values_.pop_back();
+        throw;
+    }
+
+    slot& sl = slots_[s];
+    if(s == free_head_) {
+        free_head_ = sl.index;
+    }
+    sl.index = pos;
+    return key_type{s, sl.generation};
+}
+
+template <class T>
+bool slot_map<T>::erase(key_type key)
+{
+    if(!contains(key)) {
+        return false;
+    }
+    release(key.index);
+    return true;
+}
+
+/**
+ * @brief every live key goes stale, the slots are kept for reuse
+ */
+template <class T>
+void slot_map<T>::clear() noexcept
+{
+    for(size_type i = 0; i < owners_.size(); ++i) {
+        const uint32_t s = owners_[i];
+        slot& sl = slots_[s];
+        if(++sl.generation != 0) {
+            sl.index = free_head_;
+            free_head_ = s;
+        }
+    }
+    values_.clear();
+    owners_.clear();
+}
+
+template <class T>
+void swap(slot_map<T>& lhs, slot_map<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
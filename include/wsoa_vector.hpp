@@ -0,0 +1,475 @@
+#ifndef WSOA_VECTOR_HPP__
+#define WSOA_VECTOR_HPP__
+
+/**
+ * @file wsoa_vector.hpp
+ * @brief A struct-of-arrays sequence, one contiguous column per field
+ */
+
+#include "wvector.hpp"
+#include "wspan.hpp"
+
+#include <tuple>
+
+namespace wstl
+{
+
+// every column starts on a multiple of this many bytes
+#ifndef SOA_VECTOR_ALIGN
+#define SOA_VECTOR_ALIGN 64
+#endif
+
+template <size_t... I>
+struct index_sequence {};
+
+template <size_t N, size_t... I>
+struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct make_index_sequence_impl<0, I...>
+{
+    typedef index_sequence<I...> type;
+};
+
+template <size_t N>
+using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+/**
+ * @brief A sequence of rows (Ts...) stored as one array per column
+ * @note    1. all the columns share a single allocation, each one aligned to
+ *             SOA_VECTOR_ALIGN, and grow together with the policy of vector
+ *          2. column<I>() is the contiguous run of field I, the loop that reads
+ *             two fields only brings those two into the cache
+ *          3. operator[] returns a row proxy, a std::tuple of references into
+ *             the columns, so row = tuple assigns every field
+ *          4. growing moves every column, iterators into a column and row
+ *             proxies do not survive it
+ */
+template <class... Ts>
+class soa_vector
+{
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+public:
+    typedef size_t                          size_type;
+    typedef std::tuple<Ts...>               value_type;
+    typedef std::tuple<Ts&...>              reference;
+    typedef std::tuple<const Ts&...>        const_reference;
+
+    template <size_t I>
+    using column_type = typename std::tuple_element<I, value_type>::type;
+    template <size_t I>
+    using span_type = span<column_type<I>>;
+    template <size_t I>
+    using const_span_type = span<const column_type<I>>;
+
+    static const size_t column_count = sizeof...(Ts);
+
+private:
+    typedef make_index_sequence<sizeof...(Ts)>  columns;
+    typedef wstl::allocator<char>               data_allocator;
+
+    char*               raw_;       // the allocation, columns start at aligned offsets in it
+    std::tuple<Ts*...>  cols_;
+    size_type           size_;
+    size_type           cap_;
+
+public:
+    soa_vector() noexcept : raw_(nullptr), cols_(), size_(0), cap_(0) {}
+
+    soa_vector(const soa_vector& rhs) : raw_(nullptr), cols_(), size_(0), cap_(0) {
+        reserve(rhs.size_);
+        for(size_type i = 0; i < rhs.size_; ++i) {
+            push_back(value_type(rhs[i]));
+        }
+    }
+
+    soa_vector(soa_vector&& rhs) noexcept
+        : raw_(rhs.raw_), cols_(rhs.cols_), size_(rhs.size_), cap_(rhs.cap_) {
+        rhs.raw_ = nullptr;
+        rhs.cols_ = std::tuple<Ts*...>();
+        rhs.size_ = 0;
+        rhs.cap_ = 0;
+    }
+
+    soa_vector& operator=(const soa_vector& rhs) {
+        if(this != &rhs) {
+            soa_vector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    soa_vector& operator=(soa_vector&& rhs) noexcept {
+        soa_vector tmp(wstl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    ~soa_vector() {
+        clear();
+        release();
+    }
+
+public:
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    size_type capacity() const noexcept {
+        return cap_;
+    }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / 2 / row_bytes();
+    }
+    void reserve(size_type n);
+    void shrink_to_fit();
+
+    // columns
+    template <size_t I>
+    column_type<I>* data() noexcept {
+        return std::get<I>(cols_);
+    }
+    template <size_t I>
+    const column_type<I>* data() const noexcept {
+        return std::get<I>(cols_);
+    }
+    template <size_t I>
+    span_type<I> column() noexcept {
+        return span_type<I>{std::get<I>(cols_), size_};
+    }
+    template <size_t I>
+    const_span_type<I> column() const noexcept {
+        return const_span_type<I>{std::get<I>(cols_), size_};
+    }
+
+    // visit
+    template <size_t I>
+    column_type<I>& get(size_type n) {
+        WSTL_DEBUG(n < size_);
+        return std::get<I>(cols_)[n];
+    }
+    template <size_t I>
+    const column_type<I>& get(size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return std::get<I>(cols_)[n];
+    }
+    reference operator[](size_type n) {
+        WSTL_DEBUG(n < size_);
+        return row(n, columns());
+    }
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return row(n, columns());
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "soa_vector::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "soa_vector::at() subscript out of range");
+        return (*this)[n];
+    }
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return (*this)[0];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return (*this)[0];
+    }
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return (*this)[size_ - 1];
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return (*this)[size_ - 1];
+    }
+
+    // modify
+    void push_back(const value_type& value) {
+        if(size_ == cap_) {
+            reallocate(get_new_cap(1));
+        }
+        construct_at_end<0>(value);
+        ++size_;
+    }
+    void push_back(value_type&& value) {
+        if(size_ == cap_) {
+            reallocate(get_new_cap(1));
+        }
+        construct_at_end<0>(wstl::move(value));
+        ++size_;
+    }
+
+    // one argument per column
+    template <class... Args>
+    void emplace_back(Args&& ...args) {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "soa_vector::emplace_back() takes one argument per column");
+        if(size_ == cap_) {
+            // the arguments may refer to rows, build the row before the columns move
+            value_type row(wstl::forward<Args>(args)...);
+            reallocate(get_new_cap(1));
+            construct_at_end<0>(wstl::move(row));
+            ++size_;
+            return;
+        }
+        construct_at_end<0>(std::forward_as_tuple(wstl::forward<Args>(args)...));
+        ++size_;
+    }
+
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        --size_;
+        destroy_rows(size_, size_ + 1, columns());
+    }
+
+    // shifts the rows after [pos] down, column by column
+    void erase(size_type pos) {
+        WSTL_DEBUG(pos < size_);
+        shift_down(pos, columns());
+        pop_back();
+    }
+
+    void resize(size_type n);
+
+    void clear() noexcept {
+        destroy_rows(0, size_, columns());
+        size_ = 0;
+    }
+
+    void swap(soa_vector& rhs) noexcept {
+        wstl::swap(raw_, rhs.raw_);
+        std::swap(cols_, rhs.cols_);
+        wstl::swap(size_, rhs.size_);
+        wstl::swap(cap_, rhs.cap_);
+    }
+
+private:
+    static size_type row_bytes() noexcept {
+        const size_type sizes[] = {sizeof(Ts)...};
+        size_type n = 0;
+        for(size_type s : sizes) {
+            n += s;
+        }
+        return n;
+    }
+
+    // offsets[i] is where column i starts, offsets[N] is the size of the block
+    static void layout(size_type cap, size_type (&offsets)[sizeof...(Ts) + 1]) noexcept {
+        const size_type sizes[] = {sizeof(Ts)...};
+        offsets[0] = 0;
+        for(size_type i = 0; i < sizeof...(Ts); ++i) {
+            const size_type end = offsets[i] + cap * sizes[i];
+            offsets[i + 1] = (end + SOA_VECTOR_ALIGN - 1) / SOA_VECTOR_ALIGN * SOA_VECTOR_ALIGN;
+        }
+    }
+
+    size_type get_new_cap(size_type add_size) const {
+        THROW_LENGTH_ERROR_IF(cap_ > max_size() - add_size, "soa_vector's size too big");
+        return wstl::grow_capacity(cap_, add_size, max_size());
+    }
+
+    template <size_t... I>
+    reference row(size_type n, index_sequence<I...>) {
+        return reference(std::get<I>(cols_)[n]...);
+    }
+    template <size_t... I>
+    const_reference row(size_type n, index_sequence<I...>) const {
+        return const_reference(std::get<I>(cols_)[n]...);
+    }
+
+    // construct field I.. of the row at size_, undoing the fields before on a throw
+    template <size_t I, class Tuple>
+    typename std::enable_if<(I < sizeof...(Ts))>::type construct_at_end(Tuple&& t) {
+        column_type<I>* p = std::get<I>(cols_) + size_;
+        ::new (static_cast<void*>(p)) column_type<I>(std::get<I>(wstl::forward<Tuple>(t)));
+        try
+        {
+            construct_at_end<I + 1>(wstl::forward<Tuple>(t));
+        }
+        catch(...)
+        {
+            wstl::destroy(p);
+            throw;
+        }
+    }
+    template <size_t I, class Tuple>
+    typename std::enable_if<(I == sizeof...(Ts))>::type construct_at_end(Tuple&&) {}
+
+    template <size_t... I>
+    void destroy_rows(size_type first, size_type last, index_sequence<I...>) noexcept {
+        typedef int swallow[];
+        (void)swallow{0, (wstl::destroy(std::get<I>(cols_) + first, std::get<I>(cols_) + last), 0)...};
+    }
+
+    template <size_t... I>
+    void shift_down(size_type pos, index_sequence<I...>) {
+        typedef int swallow[];
+        (void)swallow{0, (wstl::move(std::get<I>(cols_) + pos + 1, std::get<I>(cols_) + size_,
+                                     std::get<I>(cols_) + pos), 0)...};
+    }
+
+    // like move_if_noexcept: a column whose move may throw is copied instead
+    template <size_t I>
+    using copies_column = std::integral_constant<bool,
+        !std::is_nothrow_move_constructible<column_type<I>>::value &&
+        std::is_copy_constructible<column_type<I>>::value>;
+
+    // (copies, copy pass): each column is relocated in exactly one of the two passes
+    template <size_t I>
+    void relocate_column(std::tuple<Ts*...>& to, bool* built, std::true_type, std::true_type) {
+        wstl::uninitialized_copy(std::get<I>(cols_), std::get<I>(cols_) + size_, std::get<I>(to));
+        built[I] = true;
+    }
+
+    template <size_t I>
+    void relocate_column(std::tuple<Ts*...>& to, bool* built, std::false_type, std::false_type) {
+        wstl::uninitialized_move(std::get<I>(cols_), std::get<I>(cols_) + size_, std::get<I>(to));
+        built[I] = true;
+    }
+
+    template <size_t I, class Copies, class Pass>
+    void relocate_column(std::tuple<Ts*...>&, bool*, Copies, Pass) noexcept {}
+
+    template <size_t... I>
+    void destroy_built(std::tuple<Ts*...>& to, const bool* built, index_sequence<I...>) noexcept {
+        typedef int swallow[];
+        (void)swallow{0, (built[I] ? wstl::destroy(std::get<I>(to), std::get<I>(to) + size_) : void(), 0)...};
+    }
+
+    /**
+     * @brief the copied columns go first, so when one of them throws no column
+     *        of *this has been moved from yet
+     */
+    template <size_t... I>
+    void move_columns(std::tuple<Ts*...>& to, index_sequence<I...>) {
+        bool built[sizeof...(Ts)] = {};
+        typedef int swallow[];
+        try
+        {
+            (void)swallow{0, (relocate_column<I>(to, built, copies_column<I>(), std::true_type()), 0)...};
+            (void)swallow{0, (relocate_column<I>(to, built, copies_column<I>(), std::false_type()), 0)...};
+        }
+        catch(...)
+        {
+            destroy_built(to, built, columns());
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    static void place_columns(char* base, size_type cap, std::tuple<Ts*...>& cols, index_sequence<I...>) noexcept {
+        size_type offsets[sizeof...(Ts) + 1];
+        layout(cap, offsets);
+        typedef int swallow[];
+        (void)swallow{0, (std::get<I>(cols) = reinterpret_cast<Ts*>(base + offsets[I]), 0)...};
+    }
+
+    static size_type alloc_bytes(size_type cap) noexcept {
+        size_type offsets[sizeof...(Ts) + 1];
+        layout(cap, offsets);
+        return offsets[sizeof...(Ts)] + SOA_VECTOR_ALIGN - 1;
+    }
+
+    void reallocate(size_type new_cap);
+    void release() noexcept;
+};
+
+template <class... Ts>
+const size_t soa_vector<Ts...>::column_count;
+
+/*************** private ***************/
+
+/**
+ * @brief move every column into a new block with room for [new_cap] rows
+ */
+template <class... Ts>
+void soa_vector<Ts...>::reallocate(size_type new_cap)
+{
+    char* raw = data_allocator::allocate(alloc_bytes(new_cap));
+    const size_t misalign = reinterpret_cast<size_t>(raw) % SOA_VECTOR_ALIGN;
+    char* base = raw + (misalign ? SOA_VECTOR_ALIGN - misalign : 0);
+
+    std::tuple<Ts*...> cols;
+    place_columns(base, new_cap, cols, columns());
+    try
+    {
+        move_columns(cols, columns());
+    }
+    catch(...)
+    {
+        data_allocator::deallocate(raw, alloc_bytes(new_cap));
+        throw;
+    }
+
+    destroy_rows(0, size_, columns());
+    release();
+    raw_ = raw;
+    cols_ = cols;
+    cap_ = new_cap;
+}
+
+template <class... Ts>
+void soa_vector<Ts...>::release() noexcept
+{
+    if(raw_) {
+        data_allocator::deallocate(raw_, alloc_bytes(cap_));
+        raw_ = nullptr;
+    }
+}
+
+/**************public **************/
+
+template <class... Ts>
+void soa_vector<Ts...>::reserve(size_type n)
+{
+    if(n > cap_) {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in soa_vector::reserve(n)");
+        reallocate(n);
+    }
+}
+
+template <class... Ts>
+void soa_vector<Ts...>::shrink_to_fit()
+{
+    if(size_ < cap_) {
+        if(0 == size_) {
+            release();
+            cols_ = std::tuple<Ts*...>();
+            cap_ = 0;
+        }
+        else {
+            reallocate(size_);
+        }
+    }
+}
+
+template <class... Ts>
+void soa_vector<Ts...>::resize(size_type n)
+{
+    if(n < size_) {
+        destroy_rows(n, size_, columns());
+        size_ = n;
+        return;
+    }
+    reserve(n);
+    while (size_ < n)
+    {
+        push_back(value_type());
+    }
+}
+
+template <class... Ts>
+void swap(soa_vector<Ts...>& lhs, soa_vector<Ts...>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
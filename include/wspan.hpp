@@ -0,0 +1,326 @@
+#ifndef WSPAN_HPP__
+#define WSPAN_HPP__
+
+/**
+ * @file wspan.hpp
+ * @brief Non-owning views: span over contiguous elements, segmented_span over
+ *        the buffers of a deque
+ */
+
+#include "witerator.hpp"
+#include "wexcepdef.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace wstl
+{
+
+static const size_t dynamic_extent = static_cast<size_t>(-1);
+
+template <class T, class Ref, class Ptr, size_t BufSize>
+struct deque_iterator;
+
+template <class T, size_t BufSize>
+struct deque_buf_size;
+
+template <class T, size_t Extent>
+struct span_storage
+{
+    T* ptr;
+
+    span_storage(T* p, size_t n) noexcept : ptr(p) {
+        WSTL_DEBUG(n == Extent);
+        (void)n;
+    }
+    static constexpr size_t size() noexcept {
+        return Extent;
+    }
+};
+
+template <class T>
+struct span_storage<T, dynamic_extent>
+{
+    T*      ptr;
+    size_t  len;
+
+    span_storage(T* p, size_t n) noexcept : ptr(p), len(n) {}
+    size_t size() const noexcept {
+        return len;
+    }
+};
+
+// From* converts to To* by adding const at most, no derived-to-base slicing
+template <class From, class To>
+struct span_convertible : public std::is_convertible<From(*)[], To(*)[]> {};
+
+template <class C, class T, class = void>
+struct span_compatible_container : public std::false_type {};
+
+template <class C, class T>
+struct span_compatible_container<C, T,
+    decltype((void)std::declval<C&>().data(), (void)std::declval<C&>().size())>
+    : public span_convertible<typename std::remove_pointer<
+                decltype(std::declval<C&>().data())>::type, T> {};
+
+/**
+ * @brief A view of a contiguous run of T, the storage belongs to someone else
+ * @note    1. Extent == dynamic_extent keeps the length, otherwise the length
+ *             is the type and only the pointer is stored
+ *          2. any container with data() and size() over T converts, such as
+ *             vector, static_vector, and the runs of circular_buffer
+ *          3. the view dangles when the container reallocates
+ */
+template <class T, size_t Extent = dynamic_extent>
+class span
+{
+public:
+    typedef T                                       element_type;
+    typedef typename std::remove_cv<T>::type        value_type;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+    typedef T*                                      pointer;
+    typedef const T*                                const_pointer;
+    typedef T&                                      reference;
+    typedef const T&                                const_reference;
+    typedef T*                                      iterator;
+    typedef wstl::reverse_iterator<iterator>        reverse_iterator;
+
+    static const size_type extent = Extent;
+
+private:
+    span_storage<T, Extent> storage_;
+
+public:
+    template <size_t E = Extent, typename std::enable_if<
+        E == dynamic_extent || E == 0, int>::type = 0>
+    span() noexcept : storage_(nullptr, 0) {}
+
+    span(pointer p, size_type n) noexcept : storage_(p, n) {}
+
+    // a template so that span(p, 0) picks the length overload
+    template <class P, typename std::enable_if<std::is_same<P, pointer>::value, int>::type = 0>
+    span(pointer first, P last) noexcept : storage_(first, static_cast<size_type>(last - first)) {}
+
+    template <size_t N, typename std::enable_if<
+        Extent == dynamic_extent || Extent == N, int>::type = 0>
+    span(element_type (&arr)[N]) noexcept : storage_(arr, N) {}
+
+    template <class C, typename std::enable_if<
+        span_compatible_container<C, T>::value && Extent == dynamic_extent, int>::type = 0>
+    span(C& c) noexcept : storage_(c.data(), c.size()) {}
+
+    template <class C, typename std::enable_if<
+        span_compatible_container<const C, T>::value && Extent == dynamic_extent, int>::type = 0>
+    span(const C& c) noexcept : storage_(c.data(), c.size()) {}
+
+    // span<int> -> span<const int>, fixed -> dynamic
+    template <class U, size_t E, typename std::enable_if<
+        span_convertible<U, T>::value && (Extent == dynamic_extent || Extent == E), int>::type = 0>
+    span(const span<U, E>& rhs) noexcept : storage_(rhs.data(), rhs.size()) {}
+
+public:
+    // iterator
+    iterator begin() const noexcept {
+        return storage_.ptr;
+    }
+    iterator end() const noexcept {
+        return storage_.ptr + size();
+    }
+    reverse_iterator rbegin() const noexcept {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() const noexcept {
+        return reverse_iterator(begin());
+    }
+
+    // capacity
+    size_type size() const noexcept {
+        return storage_.size();
+    }
+    size_type size_bytes() const noexcept {
+        return size() * sizeof(T);
+    }
+    bool empty() const noexcept {
+        return 0 == size();
+    }
+
+    // visit
+    reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size());
+        return storage_.ptr[n];
+    }
+    reference front() const {
+        WSTL_DEBUG(!empty());
+        return storage_.ptr[0];
+    }
+    reference back() const {
+        WSTL_DEBUG(!empty());
+        return storage_.ptr[size() - 1];
+    }
+    pointer data() const noexcept {
+        return storage_.ptr;
+    }
+
+    // subviews
+    template <size_t Count>
+    span<T, Count> first() const {
+        WSTL_DEBUG(Count <= size());
+        return span<T, Count>(storage_.ptr, Count);
+    }
+    template <size_t Count>
+    span<T, Count> last() const {
+        WSTL_DEBUG(Count <= size());
+        return span<T, Count>(storage_.ptr + size() - Count, Count);
+    }
+    span<T> first(size_type n) const {
+        WSTL_DEBUG(n <= size());
+        return span<T>(storage_.ptr, n);
+    }
+    span<T> last(size_type n) const {
+        WSTL_DEBUG(n <= size());
+        return span<T>(storage_.ptr + size() - n, n);
+    }
+    // [offset, offset + n), n == dynamic_extent runs to the end
+    span<T> subspan(size_type offset, size_type n = dynamic_extent) const {
+        WSTL_DEBUG(offset <= size() && (n == dynamic_extent || n <= size() - offset));
+        return span<T>(storage_.ptr + offset, n == dynamic_extent ? size() - offset : n);
+    }
+};
+
+template <class T, size_t Extent>
+const typename span<T, Extent>::size_type span<T, Extent>::extent;
+
+template <class T, size_t Extent>
+span<const unsigned char> as_bytes(span<T, Extent> s) noexcept
+{
+    return span<const unsigned char>(reinterpret_cast<const unsigned char*>(s.data()), s.size_bytes());
+}
+
+template <class T, size_t Extent, typename std::enable_if<!std::is_const<T>::value, int>::type = 0>
+span<unsigned char> as_writable_bytes(span<T, Extent> s) noexcept
+{
+    return span<unsigned char>(reinterpret_cast<unsigned char*>(s.data()), s.size_bytes());
+}
+
+template <class T>
+span<T> make_span(T* p, size_t n) noexcept
+{
+    return span<T>(p, n);
+}
+
+template <class C>
+auto make_span(C& c) noexcept -> span<typename std::remove_pointer<decltype(c.data())>::type>
+{
+    return span<typename std::remove_pointer<decltype(c.data())>::type>(c.data(), c.size());
+}
+
+/**
+ * @brief A view of [first, last) of a deque as the contiguous runs of its buffers
+ * @note    1. iterating yields one span<T> per buffer touched, the first and the
+ *             last trimmed to the range, so a loop over a chunk is a plain array
+ *             loop
+ *          2. the view dangles when the deque adds or drops buffers
+ */
+template <class T, size_t BufSize = 0>
+class segmented_span
+{
+public:
+    typedef typename std::remove_const<T>::type     value_type;
+    typedef size_t                                  size_type;
+    typedef span<T>                                 chunk_type;
+
+private:
+    typedef value_type* const*                      map_pointer;
+
+    map_pointer first_node_;
+    T*          first_cur_;
+    map_pointer last_node_;
+    T*          last_cur_;
+
+    static size_type buffer_size() noexcept {
+        return deque_buf_size<value_type, BufSize>::value;
+    }
+
+    // one past the last buffer touched, a range ending at the start of a
+    // buffer does not touch that buffer
+    map_pointer end_node() const noexcept {
+        if(first_cur_ == last_cur_) {
+            return first_node_;
+        }
+        return last_cur_ == *last_node_ ? last_node_ : last_node_ + 1;
+    }
+
+public:
+    class iterator : public wstl::iterator<wstl::forward_iterator_tag, chunk_type, ptrdiff_t, void, chunk_type>
+    {
+    private:
+        const segmented_span*   owner_;
+        map_pointer             node_;
+
+    public:
+        iterator() noexcept : owner_(nullptr), node_(nullptr) {}
+        iterator(const segmented_span* owner, map_pointer node) noexcept : owner_(owner), node_(node) {}
+
+        chunk_type operator*() const noexcept {
+            T* first = node_ == owner_->first_node_ ? owner_->first_cur_ : *node_;
+            T* last = node_ == owner_->last_node_ ? owner_->last_cur_ : *node_ + buffer_size();
+            return chunk_type(first, last);
+        }
+
+        iterator& operator++() noexcept {
+            ++node_;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            iterator tmp = *this;
+            ++node_;
+            return tmp;
+        }
+
+        bool operator==(const iterator& rhs) const noexcept {
+            return node_ == rhs.node_;
+        }
+        bool operator!=(const iterator& rhs) const noexcept {
+            return node_ != rhs.node_;
+        }
+    };
+
+public:
+    segmented_span() noexcept
+        : first_node_(nullptr), first_cur_(nullptr), last_node_(nullptr), last_cur_(nullptr) {}
+
+    template <class Ref, class Ptr, typename std::enable_if<
+        std::is_const<T>::value || std::is_same<Ref, value_type&>::value, int>::type = 0>
+    segmented_span(const deque_iterator<value_type, Ref, Ptr, BufSize>& first,
+                   const deque_iterator<value_type, Ref, Ptr, BufSize>& last) noexcept
+        : first_node_(first.node), first_cur_(first.cur), last_node_(last.node), last_cur_(last.cur) {}
+
+    // chunks
+    iterator begin() const noexcept {
+        return iterator(this, first_node_);
+    }
+    iterator end() const noexcept {
+        return iterator(this, end_node());
+    }
+
+    size_type chunk_count() const noexcept {
+        return static_cast<size_type>(end_node() - first_node_);
+    }
+
+    // elements
+    size_type size() const noexcept {
+        if(nullptr == first_node_) {
+            return 0;
+        }
+        return buffer_size() * static_cast<size_type>(last_node_ - first_node_) +
+               static_cast<size_type>(last_cur_ - *last_node_) - static_cast<size_type>(first_cur_ - *first_node_);
+    }
+    bool empty() const noexcept {
+        return first_cur_ == last_cur_;
+    }
+};
+
+}   // wstl
+
+#endif
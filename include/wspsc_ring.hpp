@@ -0,0 +1,278 @@
+#ifndef WSPSC_RING_HPP__
+#define WSPSC_RING_HPP__
+
+#include "wmemory.hpp"
+#include "walgorithm.hpp"
+#include "uninitialized.hpp"
+
+#include <atomic>
+
+namespace wstl
+{
+
+#ifndef WSTL_CACHE_LINE_SIZE
+#define WSTL_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @brief A bounded ring buffer for exactly one producer thread and one consumer thread
+ * @note    1. the capacity is rounded up to a power of two, a slot is [index & mask_]
+ *          2. head_ / tail_ run freely and only wrap at size_type overflow
+ *          3. each side keeps a cached copy of the other side's index, so the
+ *             shared cache line is only read again when the ring looks full / empty
+ *          4. push() / emplace() / push_n() may only be called by the producer,
+ *             front() / pop() / pop_n() may only be called by the consumer
+ */
+template <class T>
+class spsc_ring
+{
+public:
+    typedef wstl::allocator<T>                          allocator_type;
+    typedef wstl::allocator<T>                          data_allocator;
+
+    typedef typename allocator_type::value_type         value_type;
+    typedef typename allocator_type::pointer            pointer;
+    typedef typename allocator_type::reference          reference;
+    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_type::size_type          size_type;
+
+private:
+    // written by the consumer
+    alignas(WSTL_CACHE_LINE_SIZE) std::atomic<size_type>    head_;
+    size_type                                               cached_tail_;
+
+    // written by the producer
+    alignas(WSTL_CACHE_LINE_SIZE) std::atomic<size_type>    tail_;
+    size_type                                               cached_head_;
+
+    // read only after construction
+    alignas(WSTL_CACHE_LINE_SIZE) pointer                   buffer_;
+    size_type                                               mask_;
+
+public:
+    explicit spsc_ring(size_type n)
+        : head_(0), cached_tail_(0), tail_(0), cached_head_(0)
+    {
+        const size_type cap = round_up_capacity(n);
+        buffer_ = data_allocator::allocate(cap);
+        mask_ = cap - 1;
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    ~spsc_ring() {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        for(size_type i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+            data_allocator::destroy(buffer_ + (i & mask_));
+        }
+        data_allocator::deallocate(buffer_, mask_ + 1);
+    }
+
+public:
+    // capacity
+    size_type capacity() const noexcept {
+        return mask_ + 1;
+    }
+
+    /**
+     * @brief size() and empty() are only exact when called by one of the two
+     *        owning threads, from any other thread they are a snapshot
+     */
+    size_type size() const noexcept {
+        const size_type head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    // producer
+    template <class ...Args>
+    bool emplace(Args&& ...args);
+
+    bool push(const value_type& value) {
+        return emplace(value);
+    }
+
+    bool push(value_type&& value) {
+        return emplace(wstl::move(value));
+    }
+
+    template <class FIter>
+    size_type push_n(FIter first, size_type n);
+
+    // consumer
+    reference front() {
+        WSTL_DEBUG(readable() != 0);
+        return buffer_[head_.load(std::memory_order_relaxed) & mask_];
+    }
+
+    void pop();
+
+    bool try_pop(value_type& value);
+
+    template <class OIter>
+    size_type pop_n(OIter result, size_type n);
+
+private:
+    static size_type round_up_capacity(size_type n);
+
+    size_type writable();
+    size_type readable();
+};
+
+/************* private ***************/
+
+template <class T>
+typename spsc_ring<T>::size_type spsc_ring<T>::round_up_capacity(size_type n)
+{
+    THROW_LENGTH_ERROR_IF(n > (static_cast<size_type>(-1) >> 1) / sizeof(T),
+                          "spsc_ring<T>'s capacity too big");
+    size_type cap = 2;
+    while (cap < n)
+    {
+        cap <<= 1;
+    }
+    return cap;
+}
+
+template <class T>
+typename spsc_ring<T>::size_type spsc_ring<T>::writable()
+{
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    if(tail - cached_head_ == capacity()) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    return capacity() - (tail - cached_head_);
+}
+
+template <class T>
+typename spsc_ring<T>::size_type spsc_ring<T>::readable()
+{
+    const size_type head = head_.load(std::memory_order_relaxed);
+    if(cached_tail_ == head) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    return cached_tail_ - head;
+}
+
+/************* public ***************/
+
+template <class T>
+template <class ...Args>
+bool spsc_ring<T>::emplace(Args&& ...args)
+{
+    if(0 == writable()) {
+        return false;
+    }
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    data_allocator::construct(buffer_ + (tail & mask_), wstl::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief copy up to n elements from first, the whole batch becomes visible to
+ *        the consumer with a single release store
+ * @return the number of elements actually pushed
+ */
+template <class T>
+template <class FIter>
+typename spsc_ring<T>::size_type spsc_ring<T>::push_n(FIter first, size_type n)
+{
+    size_type free = writable();
+    if(free < n) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        free = writable();
+    }
+    n = wstl::min(n, free);
+    if(0 == n) {
+        return 0;
+    }
+
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    const size_type slot = tail & mask_;
+    const size_type first_run = wstl::min(n, capacity() - slot);
+    auto mid = first;
+    wstl::advance(mid, first_run);
+    wstl::uninitialized_copy(first, mid, buffer_ + slot);
+    if(first_run < n) {
+        auto last = mid;
+        wstl::advance(last, n - first_run);
+        try
+        {
+            wstl::uninitialized_copy(mid, last, buffer_);
+        }
+        catch(...)
+        {
+            // nothing is published, the first run goes too
+            data_allocator::destroy(buffer_ + slot, buffer_ + slot + first_run);
+            throw;
+        }
+    }
+
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+}
+
+template <class T>
+void spsc_ring<T>::pop()
+{
+    WSTL_DEBUG(readable() != 0);
+    const size_type head = head_.load(std::memory_order_relaxed);
+    data_allocator::destroy(buffer_ + (head & mask_));
+    head_.store(head + 1, std::memory_order_release);
+}
+
+template <class T>
+bool spsc_ring<T>::try_pop(value_type& value)
+{
+    if(0 == readable()) {
+        return false;
+    }
+    const size_type head = head_.load(std::memory_order_relaxed);
+    pointer p = buffer_ + (head & mask_);
+    value = wstl::move(*p);
+    data_allocator::destroy(p);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief move up to n elements into result, the slots are handed back to the
+ *        producer with a single release store
+ * @return the number of elements actually popped
+ */
+template <class T>
+template <class OIter>
+typename spsc_ring<T>::size_type spsc_ring<T>::pop_n(OIter result, size_type n)
+{
+    size_type avail = readable();
+    if(avail < n) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        avail = readable();
+    }
+    n = wstl::min(n, avail);
+    if(0 == n) {
+        return 0;
+    }
+
+    const size_type head = head_.load(std::memory_order_relaxed);
+    const size_type slot = head & mask_;
+    const size_type first_run = wstl::min(n, capacity() - slot);
+    result = wstl::move(buffer_ + slot, buffer_ + slot + first_run, result);
+    data_allocator::destroy(buffer_ + slot, buffer_ + slot + first_run);
+    if(first_run < n) {
+        wstl::move(buffer_, buffer_ + (n - first_run), result);
+        data_allocator::destroy(buffer_, buffer_ + (n - first_run));
+    }
+
+    head_.store(head + n, std::memory_order_release);
+    return n;
+}
+
+}   // wstl
+
+#endif
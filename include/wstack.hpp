@@ -77,6 +77,11 @@ public:
         return c_.size();
     }
 
+    // the underlying container, top() is its last element
+    const container_type& get_container() const noexcept {
+        return c_;
+    }
+
     template <class... Args>
     void emplace(Args&& ...args) {
         return c_.emplace_back(wstl::forward<Args>(args)...);
@@ -0,0 +1,452 @@
+#ifndef WSTATIC_VECTOR_HPP__
+#define WSTATIC_VECTOR_HPP__
+
+/**
+ * @file wstatic_vector.hpp
+ * @brief A vector with its storage inline, the capacity fixed at N
+ */
+
+#include "walgorithm.hpp"
+#include "utils.hpp"
+#include "uninitialized.hpp"
+#include "wmemory.hpp"
+#include "witerator.hpp"
+
+#include <initializer_list>
+#include <type_traits>
+
+namespace wstl
+{
+
+/**
+ * @brief vector<T> whose N slots live inside the object
+ * @note    1. never allocates: construction, growth and copies only construct
+ *             elements in the inline slots
+ *          2. growing past N throws std::length_error, the counted operations
+ *             (assign(n), insert(n), reserve) check before touching the contents
+ *          3. move construction moves the elements one by one, unlike vector
+ *             it is O(n) and leaves rhs with its (moved-from) elements
+ */
+template <class T, size_t N>
+class static_vector
+{
+    static_assert(N > 0, "static_vector needs a capacity");
+
+public:
+    typedef wstl::allocator<T>                          allocator_type;
+    typedef wstl::allocator<T>                          data_allocator;
+    typedef typename allocator_type::value_type         value_type;
+    typedef typename allocator_type::pointer            pointer;
+    typedef typename allocator_type::const_pointer      const_pointer;
+    typedef typename allocator_type::reference          reference;
+    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_type::size_type          size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef value_type*                                 iterator;
+    typedef const value_type*                           const_iterator;
+    typedef wstl::reverse_iterator<iterator>            reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>      const_reverse_iterator;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_[N];
+    size_type size_;
+
+public:
+    static_vector() noexcept : size_(0) {}
+
+    explicit static_vector(size_type n) : size_(0) {
+        resize(n);
+    }
+
+    static_vector(size_type n, const value_type& value) : size_(0) {
+        assign(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+            wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    static_vector(Iter first, Iter last) : size_(0) {
+        assign(first, last);
+    }
+
+    static_vector(std::initializer_list<value_type> _list) : size_(0) {
+        assign(_list.begin(), _list.end());
+    }
+
+    static_vector(const static_vector& rhs) : size_(0) {
+        wstl::uninitialized_copy(rhs.begin(), rhs.end(), begin());
+        size_ = rhs.size_;
+    }
+
+    static_vector(static_vector&& rhs) : size_(0) {
+        wstl::uninitialized_move(rhs.begin(), rhs.end(), begin());
+        size_ = rhs.size_;
+    }
+
+    static_vector& operator=(const static_vector& rhs) {
+        if(this != &rhs) {
+            assign(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+
+    static_vector& operator=(static_vector&& rhs);
+
+    static_vector& operator=(std::initializer_list<value_type> _list) {
+        assign(_list.begin(), _list.end());
+        return *this;
+    }
+
+    ~static_vector() {
+        clear();
+    }
+
+public:
+    // iterator
+    iterator begin() noexcept {
+        return reinterpret_cast<T*>(storage_);
+    }
+    const_iterator begin() const noexcept {
+        return reinterpret_cast<const T*>(storage_);
+    }
+    iterator end() noexcept {
+        return begin() + size_;
+    }
+    const_iterator end() const noexcept {
+        return begin() + size_;
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+    bool full() const noexcept {
+        return N == size_;
+    }
+    size_type size() const noexcept {
+        return size_;
+    }
+    static constexpr size_type max_size() noexcept {
+        return N;
+    }
+    static constexpr size_type capacity() noexcept {
+        return N;
+    }
+    void reserve(size_type n) {
+        THROW_LENGTH_ERROR_IF(n > N, "n can not larger than capacity() in static_vector<T, N>::reserve(n)");
+    }
+    void shrink_to_fit() noexcept {}
+
+    // visit
+    reference operator[](size_type n) {
+        WSTL_DEBUG(n < size_);
+        return begin()[n];
+    }
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size_);
+        return begin()[n];
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "static_vector<T, N>::at() subscript out of range");
+        return begin()[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size_), "static_vector<T, N>::at() subscript out of range");
+        return begin()[n];
+    }
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return *begin();
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return *begin();
+    }
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    pointer data() noexcept {
+        return begin();
+    }
+    const_pointer data() const noexcept {
+        return begin();
+    }
+
+    // modify
+    void assign(size_type n, const value_type& value);
+
+    template <class Iter, typename std::enable_if<
+            wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last) {
+        clear();
+        for(; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    void assign(std::initializer_list<value_type> _list) {
+        assign(_list.begin(), _list.end());
+    }
+
+    template <class... Args>
+    reference emplace_back(Args&& ...args) {
+        THROW_LENGTH_ERROR_IF(full(), "static_vector<T, N> is full");
+        data_allocator::construct(end(), wstl::forward<Args>(args)...);
+        ++size_;
+        return back();
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&& ...args);
+
+    void push_back(const value_type& value) {
+        emplace_back(value);
+    }
+    void push_back(value_type&& value) {
+        emplace_back(wstl::move(value));
+    }
+
+    void pop_back() {
+        WSTL_DEBUG(!empty());
+        --size_;
+        data_allocator::destroy(end());
+    }
+
+    iterator insert(const_iterator pos, const value_type& value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value) {
+        return emplace(pos, wstl::move(value));
+    }
+    iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+    // all or nothing: on overflow or a throwing copy the vector is left as it was
+    template <class Iter, typename std::enable_if<
+            wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last) {
+        check_room(first, last, iterator_category(first));
+        const size_type off = static_cast<size_type>(pos - begin());
+        const size_type old_size = size_;
+        try
+        {
+            for(; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+        catch(...)
+        {
+            data_allocator::destroy(begin() + old_size, end());
+            size_ = old_size;
+            throw;
+        }
+        rotate_tail(off, old_size);
+        return begin() + off;
+    }
+
+    iterator erase(const_iterator pos) {
+        WSTL_DEBUG(pos >= begin() && pos < end());
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator first, const_iterator last);
+
+    void resize(size_type n) {
+        resize(n, value_type());
+    }
+    void resize(size_type n, const value_type& value);
+
+    void clear() noexcept {
+        data_allocator::destroy(begin(), end());
+        size_ = 0;
+    }
+
+    void swap(static_vector& rhs);
+
+private:
+    void rotate_tail(size_type off, size_type mid);
+
+    template <class Iter>
+    void check_room(Iter, Iter, wstl::input_iterator_tag) const noexcept {}
+
+    template <class Iter>
+    void check_room(Iter first, Iter last, wstl::forward_iterator_tag) const {
+        THROW_LENGTH_ERROR_IF(static_cast<size_type>(wstl::distance(first, last)) > N - size_,
+                              "static_vector<T, N>'s size too big");
+    }
+};
+
+/*************** private ***************/
+
+/**
+ * @brief rotate [off, size) so the elements appended at [mid, size) come first,
+ *        by three reversals
+ */
+template <class T, size_t N>
+void static_vector<T, N>::rotate_tail(size_type off, size_type mid)
+{
+    T* const p = begin();
+    for(size_type i = off, j = mid; i + 1 < j; ++i, --j) {
+        wstl::swap(p[i], p[j - 1]);
+    }
+    for(size_type i = mid, j = size_; i + 1 < j; ++i, --j) {
+        wstl::swap(p[i], p[j - 1]);
+    }
+    for(size_type i = off, j = size_; i + 1 < j; ++i, --j) {
+        wstl::swap(p[i], p[j - 1]);
+    }
+}
+
+/**************public **************/
+
+template <class T, size_t N>
+static_vector<T, N>& static_vector<T, N>::operator=(static_vector&& rhs)
+{
+    if(this != &rhs) {
+        clear();
+        wstl::uninitialized_move(rhs.begin(), rhs.end(), begin());
+        size_ = rhs.size_;
+    }
+    return *this;
+}
+
+template <class T, size_t N>
+void static_vector<T, N>::assign(size_type n, const value_type& value)
+{
+    THROW_LENGTH_ERROR_IF(n > N, "static_vector<T, N>'s size too big");
+    clear();
+    wstl::uninitialized_fill_n(begin(), n, value);
+    size_ = n;
+}
+
+template <class T, size_t N>
+template <class... Args>
+typename static_vector<T, N>::iterator static_vector<T, N>::emplace(const_iterator pos, Args&& ...args)
+{
+    WSTL_DEBUG(pos >= begin() && pos <= end());
+    const size_type off = static_cast<size_type>(pos - begin());
+    emplace_back(wstl::forward<Args>(args)...);
+    rotate_tail(off, size_ - 1);
+    return begin() + off;
+}
+
+template <class T, size_t N>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+    WSTL_DEBUG(pos >= begin() && pos <= end());
+    THROW_LENGTH_ERROR_IF(n > N - size_, "static_vector<T, N>'s size too big");
+    const size_type off = static_cast<size_type>(pos - begin());
+    wstl::uninitialized_fill_n(end(), n, value);
+    size_ += n;
+    rotate_tail(off, size_ - n);
+    return begin() + off;
+}
+
+template <class T, size_t N>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::erase(const_iterator first, const_iterator last)
+{
+    WSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+    iterator f = begin() + (first - begin());
+    iterator new_end = wstl::move(f + (last - first), end(), f);
+    data_allocator::destroy(new_end, end());
+    size_ = static_cast<size_type>(new_end - begin());
+    return f;
+}
+
+template <class T, size_t N>
+void static_vector<T, N>::resize(size_type n, const value_type& value)
+{
+    if(n < size_) {
+        data_allocator::destroy(begin() + n, end());
+        size_ = n;
+    }
+    else {
+        insert(end(), n - size_, value);
+    }
+}
+
+template <class T, size_t N>
+void static_vector<T, N>::swap(static_vector& rhs)
+{
+    static_vector& small = size_ < rhs.size_ ? *this : rhs;
+    static_vector& large = size_ < rhs.size_ ? rhs : *this;
+    for(size_type i = 0; i < small.size_; ++i) {
+        wstl::swap(small[i], large[i]);
+    }
+    wstl::uninitialized_move(large.begin() + small.size_, large.end(), small.end());
+    data_allocator::destroy(large.begin() + small.size_, large.end());
+    wstl::swap(size_, rhs.size_);
+}
+
+/******************************************* */
+// overload operator
+
+template <class T, size_t N>
+bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        wstl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N>
+bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return wstl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N>
+bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, size_t N>
+bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <class T, size_t N>
+bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <class T, size_t N>
+bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+template <class T, size_t N>
+void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
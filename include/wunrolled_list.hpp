@@ -0,0 +1,1095 @@
+#ifndef WUNROLLED_LIST_HPP__
+#define WUNROLLED_LIST_HPP__
+
+#include "witerator.hpp"
+#include "wmemory.hpp"
+#include "utils.hpp"
+#include "walgorithm.hpp"
+#include "functional.hpp"
+#include "uninitialized.hpp"
+
+#include <initializer_list>
+#include <type_traits>
+
+namespace wstl
+{
+
+/**
+ * @brief elements per node, K != 0 is used as is, otherwise a node holds about 512 bytes
+ */
+template <class T, size_t K = 0>
+struct unrolled_list_node_size
+{
+    static constexpr size_t value = K != 0 ? K : (sizeof(T) < 64 ? 512 / sizeof(T) : 8);
+};
+
+struct unrolled_list_node_base
+{
+    typedef unrolled_list_node_base*    base_ptr;
+
+    base_ptr    prev;
+    base_ptr    next;
+    size_t      count;      // live elements, always packed in [0, count)
+};
+
+/**
+ * @brief the link part followed by room for the elements
+ * @note the elements are addressed from a base_ptr, the sentinel of the list is a
+ *       bare unrolled_list_node_base and is never dereferenced as a node
+ */
+template <class T, size_t K = 0>
+struct unrolled_list_node : public unrolled_list_node_base
+{
+    typedef unrolled_list_node_base*    base_ptr;
+
+    static constexpr size_t data_offset =
+        (sizeof(unrolled_list_node_base) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data[unrolled_list_node_size<T, K>::value];
+
+    static T* slot(base_ptr p, size_t i) noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(p) + data_offset) + i;
+    }
+};
+
+template <class T, class Ref, class Ptr, size_t K = 0>
+struct unrolled_list_iterator : public wstl::iterator<wstl::bidirectional_iterator_tag, T>
+{
+    typedef T                                                   value_type;
+    typedef Ptr                                                 pointer;
+    typedef Ref                                                 reference;
+    typedef unrolled_list_node_base*                            base_ptr;
+    typedef unrolled_list_iterator<T, T&, T*, K>                iterator;
+    typedef unrolled_list_iterator                              self;
+
+    base_ptr    node_;
+    size_t      index_;
+
+    unrolled_list_iterator() noexcept : node_(nullptr), index_(0) {}
+    unrolled_list_iterator(base_ptr n, size_t i) noexcept : node_(n), index_(i) {}
+
+    // iterator -> const_iterator, a template so the implicit copy operations stay
+    template <class R, class P, typename std::enable_if<
+        std::is_same<unrolled_list_iterator<T, R, P, K>, iterator>::value, int>::type = 0>
+    unrolled_list_iterator(const unrolled_list_iterator<T, R, P, K>& rhs) noexcept
+        : node_(rhs.node_), index_(rhs.index_) {}
+
+    reference operator*() const {
+        return *unrolled_list_node<T, K>::slot(node_, index_);
+    }
+
+    pointer operator->() const {
+        return &(operator*());
+    }
+
+    self& operator++() {
+        WSTL_DEBUG(node_ != nullptr && index_ < node_->count);
+        if(++index_ == node_->count) {
+            node_ = node_->next;
+            index_ = 0;
+        }
+        return *this;
+    }
+
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    self& operator--() {
+        WSTL_DEBUG(node_ != nullptr);
+        if(0 == index_) {
+            node_ = node_->prev;
+            index_ = node_->count;
+        }
+        --index_;
+        return *this;
+    }
+
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    bool operator==(const self& rhs) const {
+        return node_ == rhs.node_ && index_ == rhs.index_;
+    }
+    bool operator!=(const self& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+/**
+ * @brief A doubly linked list of nodes that each hold up to K elements
+ * @note    1. elements of a node are contiguous, so a traversal touches one node
+ *             (a few cache lines) per K elements instead of one per element
+ *          2. iterators are "stable-ish": insert and erase only invalidate the
+ *             iterators into the node they touch (and the node it is split into
+ *             or merged with), other nodes are never moved
+ *          3. inserting into a full node splits it in half, erasing from a node
+ *             that falls below half merges its successor when both fit
+ *          4. splice relinks whole nodes in O(1), a position inside a node is
+ *             split into a node boundary first (O(K))
+ *          5. remove_if / unique compact the elements, merge moves them into
+ *             freshly packed nodes and frees the drained ones as it goes
+ */
+template <class T, size_t K = 0>
+class unrolled_list
+{
+public:
+    typedef wstl::allocator<T>                          allocator_type;
+    typedef wstl::allocator<T>                          data_allocator;
+    typedef unrolled_list_node<T, K>                    node_type;
+    typedef wstl::allocator<node_type>                  node_allocator;
+
+    typedef typename allocator_type::value_type         value_type;
+    typedef typename allocator_type::size_type          size_type;
+    typedef typename allocator_type::pointer            pointer;
+    typedef typename allocator_type::const_pointer      const_pointer;
+    typedef typename allocator_type::reference          reference;
+    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_type::difference_type    difference_type;
+
+    typedef unrolled_list_iterator<T, T&, T*, K>                iterator;
+    typedef unrolled_list_iterator<T, const T&, const T*, K>    const_iterator;
+    typedef wstl::reverse_iterator<iterator>                    reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>              const_reverse_iterator;
+
+    typedef unrolled_list_node_base*                    base_ptr;
+    typedef node_type*                                  node_ptr;
+
+    static const size_type node_capacity = unrolled_list_node_size<T, K>::value;
+
+private:
+    unrolled_list_node_base root_;      // sentinel, count == 0
+    size_type               size_;
+
+public:
+    unrolled_list() noexcept {
+        init();
+    }
+
+    explicit unrolled_list(size_type n) {
+        init();
+        fill_init(n, value_type());
+    }
+
+    unrolled_list(size_type n, const T& value) {
+        init();
+        fill_init(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    unrolled_list(Iter first, Iter last) {
+        init();
+        copy_init(first, last);
+    }
+
+    unrolled_list(std::initializer_list<T> ilist) {
+        init();
+        copy_init(ilist.begin(), ilist.end());
+    }
+
+    unrolled_list(const unrolled_list& rhs) {
+        init();
+        copy_init(rhs.cbegin(), rhs.cend());
+    }
+
+    unrolled_list(unrolled_list&& rhs) noexcept {
+        init();
+        swap(rhs);
+    }
+
+    unrolled_list& operator=(const unrolled_list& rhs) {
+        if(this != &rhs) {
+            assign(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+
+    unrolled_list& operator=(unrolled_list&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    unrolled_list& operator=(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~unrolled_list() {
+        clear();
+    }
+
+public:
+    // iterator related
+    iterator begin() noexcept {
+        return iterator(root_.next, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(root_.next, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(&root_, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<base_ptr>(&root_), 0);
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return 0 == size_;
+    }
+
+    size_type size() const noexcept {
+        return size_;
+    }
+
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1);
+    }
+
+    // visit
+    reference front() {
+        WSTL_DEBUG(!empty());
+        return *slot(root_.next, 0);
+    }
+
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return *slot(root_.next, 0);
+    }
+
+    reference back() {
+        WSTL_DEBUG(!empty());
+        return *slot(root_.prev, root_.prev->count - 1);
+    }
+
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return *slot(root_.prev, root_.prev->count - 1);
+    }
+
+    // assign
+    void assign(size_type n, const value_type& value) {
+        fill_assign(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last) {
+        copy_assign(first, last);
+    }
+
+    void assign(std::initializer_list<T> ilist) {
+        copy_assign(ilist.begin(), ilist.end());
+    }
+
+    // modify
+    template <class ...Args>
+    iterator emplace(const_iterator pos, Args&& ...args);
+
+    template <class ...Args>
+    void emplace_front(Args&& ...args) {
+        emplace(cbegin(), wstl::forward<Args>(args)...);
+    }
+
+    template <class ...Args>
+    void emplace_back(Args&& ...args) {
+        emplace(cend(), wstl::forward<Args>(args)...);
+    }
+
+    void push_front(const value_type& value) {
+        emplace(cbegin(), value);
+    }
+
+    void push_front(value_type&& value) {
+        emplace(cbegin(), wstl::move(value));
+    }
+
+    void push_back(const value_type& value) {
+        emplace(cend(), value);
+    }
+
+    void push_back(value_type&& value) {
+        emplace(cend(), wstl::move(value));
+    }
+
+    void pop_front() {
+        WSTL_DEBUG(!empty());
+        erase(cbegin());
+    }
+
+    void pop_back();
+
+    iterator insert(const_iterator pos, const value_type& value) {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, value_type&& value) {
+        return emplace(pos, wstl::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const value_type& value) {
+        return fill_insert(pos, n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        wstl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last) {
+        return copy_insert(pos, first, last);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+        return copy_insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    void     clear() noexcept;
+
+    void resize(size_type new_size) {
+        resize(new_size, value_type());
+    }
+
+    void resize(size_type new_size, const value_type& value);
+
+    void swap(unrolled_list& rhs) noexcept;
+
+    // list operations, [x] must be another list
+    void splice(const_iterator pos, unrolled_list& x);
+    void splice(const_iterator pos, unrolled_list& x, const_iterator it);
+    void splice(const_iterator pos, unrolled_list& x, const_iterator first, const_iterator last);
+
+    template <class UnaryPredicate>
+    void remove_if(UnaryPredicate pred);
+
+    void remove(const value_type& value) {
+        const value_type v(value);      // [value] may live in this list and be overwritten
+        remove_if([&](const value_type& e) {
+            return e == v;
+        });
+    }
+
+    template <class BinaryPredicate>
+    void unique(BinaryPredicate pred);
+
+    void unique() {
+        unique(wstl::equal_to<T>());
+    }
+
+    void merge(unrolled_list& x) {
+        merge(x, wstl::less<T>());
+    }
+
+    template <class Compare>
+    void merge(unrolled_list& x, Compare comp);
+
+    void reverse() noexcept;
+
+private:
+    static T* slot(base_ptr p, size_type i) noexcept {
+        return node_type::slot(p, i);
+    }
+
+    void init() noexcept {
+        root_.prev = root_.next = &root_;
+        root_.count = 0;
+        size_ = 0;
+    }
+
+    iterator make_iter(base_ptr n, size_type i) noexcept {
+        return (n == &root_ || i < n->count) ? iterator(n, i) : iterator(n->next, 0);
+    }
+
+    base_ptr    create_node(base_ptr pos);
+    void        destroy_node(base_ptr p) noexcept;
+    base_ptr    split_node(base_ptr n, size_type i);
+    void        try_merge(base_ptr n);
+    base_ptr    prepare_append(const_iterator pos);
+
+    template <class ...Args>
+    iterator    emplace_in_node(base_ptr n, size_type i, Args&& ...args);
+
+    void fill_init(size_type n, const value_type& value);
+    template <class Iter>
+    void copy_init(Iter first, Iter last);
+
+    void fill_assign(size_type n, const value_type& value);
+    template <class Iter>
+    void copy_assign(Iter first, Iter last);
+
+    iterator fill_insert(const_iterator pos, size_type n, const value_type& value);
+    template <class Iter>
+    iterator copy_insert(const_iterator pos, Iter first, Iter last);
+};
+
+template <class T, size_t K>
+const typename unrolled_list<T, K>::size_type unrolled_list<T, K>::node_capacity;
+
+/*************** private ***************/
+
+/**
+ * @brief allocate an empty node and link it in front of [pos]
+ * @note an empty node must not stay in the list, the caller fills it or destroys it
+ */
+template <class T, size_t K>
+typename unrolled_list<T, K>::base_ptr unrolled_list<T, K>::create_node(base_ptr pos)
+{
+    base_ptr p = node_allocator::allocate(1);
+    p->count = 0;
+    p->prev = pos->prev;
+    p->next = pos;
+    pos->prev->next = p;
+    pos->prev = p;
+    return p;
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::destroy_node(base_ptr p) noexcept
+{
+    p->prev->next = p->next;
+    p->next->prev = p->prev;
+    data_allocator::destroy(slot(p, 0), slot(p, p->count));
+    node_allocator::deallocate(static_cast<node_ptr>(p));
+}
+
+/**
+ * @brief move [i, count) of node [n] into a new node right after it
+ * @return the new node
+ */
+template <class T, size_t K>
+typename unrolled_list<T, K>::base_ptr unrolled_list<T, K>::split_node(base_ptr n, size_type i)
+{
+    WSTL_DEBUG(i < n->count);
+    base_ptr r = create_node(n->next);
+    T* p = slot(n, 0);
+    wstl::uninitialized_move(p + i, p + n->count, slot(r, 0));
+    data_allocator::destroy(p + i, p + n->count);
+    r->count = n->count - i;
+    n->count = i;
+    return r;
+}
+
+/**
+ * @brief fold the successor into [n] when [n] is under half full and both fit
+ */
+template <class T, size_t K>
+void unrolled_list<T, K>::try_merge(base_ptr n)
+{
+    base_ptr nx = n->next;
+    if(n == &root_ || nx == &root_ || n->count >= node_capacity / 2 ||
+        n->count + nx->count > node_capacity) {
+        return;
+    }
+    wstl::uninitialized_move(slot(nx, 0), slot(nx, nx->count), slot(n, n->count));
+    n->count += nx->count;
+    destroy_node(nx);
+}
+
+/**
+ * @brief turn [pos] into a node boundary and return the node new elements are
+ *        appended to: the node before [pos] if it has room, else a new one
+ */
+template <class T, size_t K>
+typename unrolled_list<T, K>::base_ptr unrolled_list<T, K>::prepare_append(const_iterator pos)
+{
+    base_ptr n = pos.node_;
+    if(pos.index_ > 0) {
+        n = split_node(n, pos.index_);
+    }
+    base_ptr prev = n->prev;
+    if(prev != &root_ && prev->count < node_capacity) {
+        return prev;
+    }
+    return create_node(n);
+}
+
+/**
+ * @brief construct at slot [i] of a node that has room, shifting [i, count) right
+ */
+template <class T, size_t K>
+template <class ...Args>
+typename unrolled_list<T, K>::iterator
+unrolled_list<T, K>::emplace_in_node(base_ptr n, size_type i, Args&& ...args)
+{
+    WSTL_DEBUG(n->count < node_capacity && i <= n->count);
+    T* p = slot(n, 0);
+    try
+    {
+        if(i == n->count) {
+            data_allocator::construct(p + i, wstl::forward<Args>(args)...);
+        }
+        else {
+            value_type tmp(wstl::forward<Args>(args)...);
+            data_allocator::construct(p + n->count, wstl::move(p[n->count - 1]));
+            wstl::move_backward(p + i, p + n->count - 1, p + n->count);
+            p[i] = wstl::move(tmp);
+        }
+    }
+    catch(...)
+    {
+        if(0 == n->count) destroy_node(n);
+        throw;
+    }
+    ++n->count;
+    ++size_;
+    return iterator(n, i);
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::fill_init(size_type n, const value_type& value)
+{
+    try
+    {
+        fill_insert(cend(), n, value);
+    }
+    catch(...)
+    {
+        clear();
+        throw;
+    }
+}
+
+template <class T, size_t K>
+template <class Iter>
+void unrolled_list<T, K>::copy_init(Iter first, Iter last)
+{
+    try
+    {
+        copy_insert(cend(), first, last);
+    }
+    catch(...)
+    {
+        clear();
+        throw;
+    }
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::fill_assign(size_type n, const value_type& value)
+{
+    auto i = begin();
+    auto e = end();
+    for(; i != e && n > 0; ++i, --n) {
+        *i = value;
+    }
+    if(n > 0) {
+        fill_insert(e, n, value);
+    }
+    else {
+        erase(i, e);
+    }
+}
+
+template <class T, size_t K>
+template <class Iter>
+void unrolled_list<T, K>::copy_assign(Iter first, Iter last)
+{
+    auto i = begin();
+    auto e = end();
+    for(; i != e && first != last; ++i, ++first) {
+        *i = *first;
+    }
+    if(first != last) {
+        copy_insert(e, first, last);
+    }
+    else {
+        erase(i, e);
+    }
+}
+
+template <class T, size_t K>
+typename unrolled_list<T, K>::iterator
+unrolled_list<T, K>::fill_insert(const_iterator pos, size_type n, const value_type& value)
+{
+    if(0 == n) {
+        return iterator(pos.node_, pos.index_);
+    }
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - n, "unrolled_list<T>'s size too big");
+
+    base_ptr cur = prepare_append(pos);
+    iterator result(cur, cur->count);
+    try
+    {
+        for(; n > 0; --n) {
+            if(cur->count == node_capacity) {
+                cur = create_node(cur->next);
+            }
+            data_allocator::construct(slot(cur, cur->count), value);
+            ++cur->count;
+            ++size_;
+        }
+    }
+    catch(...)
+    {
+        if(0 == cur->count) destroy_node(cur);
+        throw;
+    }
+    return result;
+}
+
+template <class T, size_t K>
+template <class Iter>
+typename unrolled_list<T, K>::iterator
+unrolled_list<T, K>::copy_insert(const_iterator pos, Iter first, Iter last)
+{
+    if(first == last) {
+        return iterator(pos.node_, pos.index_);
+    }
+
+    base_ptr cur = prepare_append(pos);
+    iterator result(cur, cur->count);
+    try
+    {
+        for(; first != last; ++first) {
+            if(cur->count == node_capacity) {
+                cur = create_node(cur->next);
+            }
+            data_allocator::construct(slot(cur, cur->count), *first);
+            ++cur->count;
+            ++size_;
+        }
+    }
+    catch(...)
+    {
+        if(0 == cur->count) destroy_node(cur);
+        throw;
+    }
+    return result;
+}
+
+/**************public **************/
+
+/**
+ * @brief insert in front of [pos]
+ * @note    1. at a node boundary the previous node is used when it has room,
+ *             so push_back never shifts anything
+ *          2. a full node gets a new node in front of it (at its start) or is
+ *             split in half (in its middle)
+ */
+template <class T, size_t K>
+template <class ...Args>
+typename unrolled_list<T, K>::iterator
+unrolled_list<T, K>::emplace(const_iterator pos, Args&& ...args)
+{
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+
+    base_ptr n = pos.node_;
+    size_type i = pos.index_;
+    if(0 == i && n->prev != &root_ && n->prev->count < node_capacity) {
+        return emplace_in_node(n->prev, n->prev->count, wstl::forward<Args>(args)...);
+    }
+    if(n == &root_ || (0 == i && n->count == node_capacity)) {
+        return emplace_in_node(create_node(n), 0, wstl::forward<Args>(args)...);
+    }
+    if(n->count == node_capacity) {
+        // build the value before the split, [args] may refer to an element of [n]
+        value_type tmp(wstl::forward<Args>(args)...);
+        const size_type half = node_capacity / 2;
+        base_ptr r = split_node(n, half);
+        if(i > half) {
+            return emplace_in_node(r, i - half, wstl::move(tmp));
+        }
+        return emplace_in_node(n, i, wstl::move(tmp));
+    }
+    return emplace_in_node(n, i, wstl::forward<Args>(args)...);
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::pop_back()
+{
+    WSTL_DEBUG(!empty());
+    base_ptr n = root_.prev;
+    data_allocator::destroy(slot(n, n->count - 1));
+    --size_;
+    if(0 == --n->count) {
+        destroy_node(n);
+    }
+}
+
+template <class T, size_t K>
+typename unrolled_list<T, K>::iterator unrolled_list<T, K>::erase(const_iterator pos)
+{
+    WSTL_DEBUG(pos != cend());
+    base_ptr n = pos.node_;
+    const size_type i = pos.index_;
+    T* p = slot(n, 0);
+    wstl::move(p + i + 1, p + n->count, p + i);
+    data_allocator::destroy(p + n->count - 1);
+    --size_;
+    if(0 == --n->count) {
+        base_ptr next = n->next;
+        destroy_node(n);
+        return iterator(next, 0);
+    }
+    try_merge(n);
+    return make_iter(n, i);
+}
+
+template <class T, size_t K>
+typename unrolled_list<T, K>::iterator
+unrolled_list<T, K>::erase(const_iterator first, const_iterator last)
+{
+    if(first == last) {
+        return iterator(last.node_, last.index_);
+    }
+
+    base_ptr fn = first.node_;
+    base_ptr ln = last.node_;
+    const size_type fi = first.index_;
+    const size_type li = last.index_;
+    if(fn == ln) {
+        // [last] is inside this node, so the node keeps at least one element
+        T* p = slot(fn, 0);
+        const size_type k = li - fi;
+        wstl::move(p + li, p + fn->count, p + fi);
+        data_allocator::destroy(p + fn->count - k, p + fn->count);
+        fn->count -= k;
+        size_ -= k;
+        try_merge(fn);
+        return make_iter(fn, fi);
+    }
+
+    // the tail of the first node
+    size_ -= fn->count - fi;
+    data_allocator::destroy(slot(fn, fi), slot(fn, fn->count));
+    fn->count = fi;
+
+    // whole nodes in between
+    for(base_ptr cur = fn->next; cur != ln;) {
+        base_ptr next = cur->next;
+        size_ -= cur->count;
+        destroy_node(cur);
+        cur = next;
+    }
+
+    // the head of the last node
+    if(li > 0) {
+        T* q = slot(ln, 0);
+        wstl::move(q + li, q + ln->count, q);
+        data_allocator::destroy(q + ln->count - li, q + ln->count);
+        ln->count -= li;
+        size_ -= li;
+    }
+
+    if(0 == fn->count) {
+        destroy_node(fn);
+        return iterator(ln, 0);
+    }
+    try_merge(fn);
+    return make_iter(fn, fi);
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::clear() noexcept
+{
+    for(base_ptr cur = root_.next; cur != &root_;) {
+        base_ptr next = cur->next;
+        destroy_node(cur);
+        cur = next;
+    }
+    init();
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::resize(size_type new_size, const value_type& value)
+{
+    if(new_size >= size_) {
+        fill_insert(cend(), new_size - size_, value);
+        return;
+    }
+
+    // walk whole nodes, then step inside the one that holds [new_size]
+    base_ptr n = root_.next;
+    size_type skipped = 0;
+    while (skipped + n->count <= new_size)
+    {
+        skipped += n->count;
+        n = n->next;
+    }
+    erase(const_iterator(n, new_size - skipped), cend());
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::swap(unrolled_list& rhs) noexcept
+{
+    wstl::swap(root_.prev, rhs.root_.prev);
+    wstl::swap(root_.next, rhs.root_.next);
+    wstl::swap(size_, rhs.size_);
+
+    // the neighbours still point at the other sentinel
+    if(0 == size_) {
+        root_.prev = root_.next = &root_;
+    }
+    else {
+        root_.next->prev = &root_;
+        root_.prev->next = &root_;
+    }
+    if(0 == rhs.size_) {
+        rhs.root_.prev = rhs.root_.next = &rhs.root_;
+    }
+    else {
+        rhs.root_.next->prev = &rhs.root_;
+        rhs.root_.prev->next = &rhs.root_;
+    }
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::splice(const_iterator pos, unrolled_list& x)
+{
+    WSTL_DEBUG(this != &x);
+    if(x.empty()) {
+        return;
+    }
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - x.size_, "unrolled_list<T>'s size too big");
+
+    base_ptr n = pos.node_;
+    if(pos.index_ > 0) {
+        n = split_node(n, pos.index_);
+    }
+
+    base_ptr f = x.root_.next;
+    base_ptr l = x.root_.prev;
+    f->prev = n->prev;
+    n->prev->next = f;
+    l->next = n;
+    n->prev = l;
+
+    size_ += x.size_;
+    x.init();
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::splice(const_iterator pos, unrolled_list& x, const_iterator it)
+{
+    WSTL_DEBUG(this != &x && it != x.cend());
+    emplace(pos, wstl::move(const_cast<reference>(*it)));
+    x.erase(it);
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::splice(const_iterator pos, unrolled_list& x,
+                                 const_iterator first, const_iterator last)
+{
+    WSTL_DEBUG(this != &x);
+    if(first == last) {
+        return;
+    }
+
+    // split at [last] before [first], a split at [first] would move [last]
+    base_ptr ln = last.node_;
+    if(last.index_ > 0) {
+        ln = x.split_node(ln, last.index_);
+    }
+    base_ptr fn = first.node_;
+    if(first.index_ > 0) {
+        fn = x.split_node(fn, first.index_);
+    }
+
+    size_type n = 0;
+    for(base_ptr cur = fn; cur != ln; cur = cur->next) {
+        n += cur->count;
+    }
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - n, "unrolled_list<T>'s size too big");
+
+    base_ptr l = ln->prev;
+    fn->prev->next = ln;
+    ln->prev = fn->prev;
+    x.size_ -= n;
+
+    base_ptr p = pos.node_;
+    if(pos.index_ > 0) {
+        p = split_node(p, pos.index_);
+    }
+    fn->prev = p->prev;
+    p->prev->next = fn;
+    l->next = p;
+    p->prev = l;
+    size_ += n;
+}
+
+template <class T, size_t K>
+template <class UnaryPredicate>
+void unrolled_list<T, K>::remove_if(UnaryPredicate pred)
+{
+    auto e = end();
+    auto w = begin();
+    for(; w != e && !pred(*w); ++w) {
+        ;
+    }
+    if(w == e) {
+        return;
+    }
+
+    auto r = w;
+    for(++r; r != e; ++r) {
+        if(!pred(*r)) {
+            *w = wstl::move(*r);
+            ++w;
+        }
+    }
+    erase(w, e);
+}
+
+template <class T, size_t K>
+template <class BinaryPredicate>
+void unrolled_list<T, K>::unique(BinaryPredicate pred)
+{
+    auto e = end();
+    auto w = begin();
+    if(w == e) {
+        return;
+    }
+
+    auto r = w;
+    while (++r != e)
+    {
+        if(!pred(*w, *r)) {
+            if(++w != r) {
+                *w = wstl::move(*r);
+            }
+        }
+    }
+    erase(++w, e);
+}
+
+template <class T, size_t K>
+template <class Compare>
+void unrolled_list<T, K>::merge(unrolled_list& x, Compare comp)
+{
+    if(this == &x || x.empty()) {
+        return;
+    }
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - x.size_, "unrolled_list<T>'s size too big");
+
+    unrolled_list result;
+    auto take = [&result](unrolled_list& from, iterator& it) {
+        result.emplace_back(wstl::move(*it));
+        base_ptr n = it.node_;
+        ++it;
+        if(it.node_ != n) {
+            // every element of [n] has been moved out
+            from.size_ -= n->count;
+            from.destroy_node(n);
+        }
+    };
+
+    auto a = begin();
+    auto b = x.begin();
+    const auto ae = end();
+    const auto be = x.end();
+    while (a != ae && b != be)
+    {
+        if(comp(*b, *a)) {
+            take(x, b);
+        }
+        else {
+            take(*this, a);
+        }
+    }
+    for(; a != ae;) {
+        take(*this, a);
+    }
+    for(; b != be;) {
+        take(x, b);
+    }
+
+    x.init();
+    init();
+    swap(result);
+}
+
+template <class T, size_t K>
+void unrolled_list<T, K>::reverse() noexcept
+{
+    if(size_ <= 1) {
+        return;
+    }
+
+    base_ptr cur = &root_;
+    do
+    {
+        wstl::swap(cur->prev, cur->next);
+        if(cur != &root_) {
+            T* p = slot(cur, 0);
+            for(size_type i = 0, j = cur->count - 1; i < j; ++i, --j) {
+                wstl::swap(p[i], p[j]);
+            }
+        }
+        cur = cur->prev;
+    } while (cur != &root_);
+}
+
+template <class T, size_t K>
+bool operator==(const unrolled_list<T, K>& lhs, const unrolled_list<T, K>& rhs)
+{
+    if(lhs.size() != rhs.size()) {
+        return false;
+    }
+    auto f1 = lhs.cbegin();
+    auto f2 = rhs.cbegin();
+    for(; f1 != lhs.cend(); ++f1, ++f2) {
+        if(!(*f1 == *f2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T, size_t K>
+bool operator!=(const unrolled_list<T, K>& lhs, const unrolled_list<T, K>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, size_t K>
+void swap(unrolled_list<T, K>& lhs, unrolled_list<T, K>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+}   // wstl
+
+#endif
@@ -20,6 +20,22 @@
 namespace wstl
 {
 
+/**
+ * @brief the capacity after making room for [add_size] more elements: 1.5x the
+ *        old one, at least 16, shared by the containers that grow like vector
+ * @note the caller checks old_cap + add_size <= max_size first
+ */
+inline size_t grow_capacity(size_t old_cap, size_t add_size, size_t max_size) noexcept
+{
+    if(old_cap > max_size - old_cap / 2) {
+        return old_cap + add_size > max_size - 16 ?
+                old_cap + add_size : old_cap + add_size + 16;
+    }
+    return old_cap == 0 ?
+            wstl::max(add_size, static_cast<size_t>(16)) :
+            wstl::max(old_cap + old_cap / 2, old_cap + add_size);
+}
+
 template <class T>
 class vector
 {
@@ -284,6 +300,8 @@ public:
 
     void resize(size_type new_size, const value_type& value);
 
+    void resize_for_overwrite(size_type n);
+
     void swap(vector& rhs) noexcept;
 
 private:
@@ -318,6 +336,9 @@ private:
     void    shrink_to_fit();
     void    reinsert(size_type size);
 
+    void    default_init(iterator, iterator, std::true_type) noexcept {}
+    void    default_init(iterator first, iterator last, std::false_type);
+
 };
 
 template <class T>
@@ -369,6 +390,42 @@ void vector<T>::resize(size_type new_size, const value_type& value)
     }
 }
 
+/**
+ * @brief resize to n elements, new elements are default-initialized, so trivial
+ *        types are left as they are for the caller to overwrite
+ */
+template <class T>
+void vector<T>::resize_for_overwrite(size_type n)
+{
+    const size_type len = size();
+    if(n <= len) {
+        erase(begin_ + n, end_);
+        return;
+    }
+    if(n > capacity()) {
+        reserve(get_new_cap(n - len));
+    }
+    default_init(end_, begin_ + n, std::is_trivially_default_constructible<value_type>());
+    end_ = begin_ + n;
+}
+
+template <class T>
+void vector<T>::default_init(iterator first, iterator last, std::false_type)
+{
+    iterator cur = first;
+    try
+    {
+        for(; cur != last; ++cur) {
+            ::new(static_cast<void*>(cur)) value_type;
+        }
+    }
+    catch(...)
+    {
+        data_allocator::destroy(first, cur);
+        throw;
+    }
+}
+
 template <class T>
 void vector<T>::swap(vector<T>& rhs) noexcept
 {
@@ -613,14 +670,7 @@ typename vector<T>::size_type vector<T>::get_new_cap(size_type add_size)
     const auto old_size = capacity();
     THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
                             "vector<T>'s size too big");
-    if(old_size > max_size() - old_size / 2) {
-        return old_size + add_size > max_size() - 16 ?
-                old_size + add_size : old_size + add_size + 16;
-    }
-    const size_type new_size = old_size == 0 ?
-                    wstl::max(add_size, static_cast<size_type>(16)) :
-                    wstl::max(old_size + old_size / 2, old_size + add_size);
-    return new_size;                    
+    return wstl::grow_capacity(old_size, add_size, max_size());
 }
 
 
@@ -855,6 +905,9 @@ void swap(vector<T>& lhs, vector<T>& rhs)
 }
 
 }   // namespace wstl
+
+#include "wbitvector.hpp"
+
 #endif
 
 /**
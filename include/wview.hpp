@@ -0,0 +1,395 @@
+#ifndef WVIEW_HPP__
+#define WVIEW_HPP__
+
+/**
+ * @file wview.hpp
+ * @brief Read-only views over snapshots laid out to be used in place, typically
+ *        a file opened as mmap_vector<unsigned char> in mmap_mode::read_only
+ * @note    layout, all integers in native byte order:
+ *          [view_header, 128 bytes][column 0][pad][column 1][pad]
+ *          every column starts on a VIEW_ALIGN boundary, so a page aligned
+ *          mapping gives aligned elements
+ */
+
+#include "wspan.hpp"
+#include "wexcepdef.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+
+namespace wstl
+{
+
+#ifndef VIEW_ALIGN
+#define VIEW_ALIGN 64
+#endif
+
+static const uint32_t view_format_version = 1;
+
+enum class view_kind : uint32_t
+{
+    vector      = 1,
+    sorted_map  = 2
+};
+
+struct view_column
+{
+    uint64_t offset;        // from the start of the header
+    uint64_t elem_size;
+};
+
+struct view_header
+{
+    char        magic[8];           // "WSTLVIEW"
+    uint32_t    version;
+    uint32_t    byte_order;         // 0x01020304 as written
+    uint32_t    kind;
+    uint32_t    column_count;
+    uint64_t    count;              // elements per column
+    uint64_t    checksum;           // view_checksum of the columns, in order
+    view_column columns[2];
+    uint8_t     reserved[56];       // zero, for later versions
+};
+
+static_assert(sizeof(view_header) == 128, "view_header is two cache lines");
+
+/**
+ * @brief a 64-bit hash of [p, p + bytes), eight bytes per step
+ * @note not cryptographic, it catches torn writes and bit rot
+ */
+inline uint64_t view_checksum(const void* p, size_t bytes, uint64_t seed = 0) noexcept
+{
+    const uint64_t k1 = 0x9E3779B97F4A7C15ULL;
+    const uint64_t k2 = 0xC2B2AE3D27D4EB4FULL;
+    const unsigned char* s = static_cast<const unsigned char*>(p);
+    uint64_t h = seed ^ (bytes * k1);
+    for(; bytes >= 8; bytes -= 8, s += 8) {
+        uint64_t w;
+        std::memcpy(&w, s, 8);
+        h ^= w * k2;
+        h = ((h << 31) | (h >> 33)) * k1;
+    }
+    uint64_t tail = 0;
+    if(bytes > 0) {
+        std::memcpy(&tail, s, bytes);
+    }
+    h ^= tail * k2;
+    h ^= h >> 29;
+    h *= k1;
+    return h ^ (h >> 32);
+}
+
+inline size_t view_align(size_t n) noexcept
+{
+    return (n + VIEW_ALIGN - 1) / VIEW_ALIGN * VIEW_ALIGN;
+}
+
+/******************************************* */
+// writing
+
+inline void view_write(std::ostream& os, const void* p, size_t bytes)
+{
+    os.write(static_cast<const char*>(p), static_cast<std::streamsize>(bytes));
+    THROW_RUNTIME_ERROR_IF(!os, "view: write failed");
+}
+
+// the columns are (data, bytes) pairs, each is padded to VIEW_ALIGN
+inline void write_view(std::ostream& os, view_kind kind, uint64_t count,
+                       const span<const unsigned char>* columns, uint32_t column_count)
+{
+    WSTL_DEBUG(column_count >= 1 && column_count <= 2);
+    view_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "WSTLVIEW", 8);
+    header.version = view_format_version;
+    header.byte_order = 0x01020304;
+    header.kind = static_cast<uint32_t>(kind);
+    header.column_count = column_count;
+    header.count = count;
+
+    uint64_t offset = view_align(sizeof(view_header));
+    uint64_t checksum = 0;
+    for(uint32_t i = 0; i < column_count; ++i) {
+        header.columns[i].offset = offset;
+        header.columns[i].elem_size = 0 == count ? 0 : columns[i].size() / count;
+        checksum = view_checksum(columns[i].data(), columns[i].size(), checksum);
+        offset += view_align(columns[i].size());
+    }
+    header.checksum = checksum;
+
+    static const unsigned char zeros[VIEW_ALIGN] = {};
+    view_write(os, &header, sizeof(header));
+    view_write(os, zeros, view_align(sizeof(header)) - sizeof(header));
+    for(uint32_t i = 0; i < column_count; ++i) {
+        view_write(os, columns[i].data(), columns[i].size());
+        view_write(os, zeros, view_align(columns[i].size()) - columns[i].size());
+    }
+}
+
+template <class T>
+void write_vector_view(std::ostream& os, span<const T> values)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "views hold trivially copyable elements");
+    const span<const unsigned char> column = as_bytes(values);
+    write_view(os, view_kind::vector, values.size(), &column, 1);
+}
+
+// keys must be sorted ascending, values[i] belongs to keys[i]
+template <class K, class V>
+void write_sorted_map_view(std::ostream& os, span<const K> keys, span<const V> values)
+{
+    static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                  "views hold trivially copyable elements");
+    THROW_RUNTIME_ERROR_IF(keys.size() != values.size(), "sorted_map_view: keys and values differ in length");
+    for(size_t i = 1; i < keys.size(); ++i) {
+        THROW_RUNTIME_ERROR_IF(keys[i] < keys[i - 1], "sorted_map_view: keys are not sorted");
+    }
+    const span<const unsigned char> columns[2] = {as_bytes(keys), as_bytes(values)};
+    write_view(os, view_kind::sorted_map, keys.size(), columns, 2);
+}
+
+/******************************************* */
+// reading
+
+/**
+ * @brief checks the header of [bytes] against the expected kind and element
+ *        sizes and returns it, throws std::runtime_error when it does not fit
+ */
+inline const view_header& open_view(span<const unsigned char> bytes, view_kind kind,
+                                    const size_t* elem_sizes, const size_t* elem_aligns, uint32_t column_count)
+{
+    THROW_RUNTIME_ERROR_IF(bytes.size() < sizeof(view_header), "view: buffer too small for the header");
+    THROW_RUNTIME_ERROR_IF(reinterpret_cast<uintptr_t>(bytes.data()) % alignof(view_header) != 0,
+                           "view: buffer is not aligned");
+    const view_header& header = *reinterpret_cast<const view_header*>(bytes.data());
+    THROW_RUNTIME_ERROR_IF(std::memcmp(header.magic, "WSTLVIEW", 8) != 0, "view: bad magic");
+    THROW_RUNTIME_ERROR_IF(header.version > view_format_version, "view: written by a newer version");
+    THROW_RUNTIME_ERROR_IF(header.byte_order != 0x01020304, "view: written with another byte order");
+    THROW_RUNTIME_ERROR_IF(header.kind != static_cast<uint32_t>(kind) || header.column_count != column_count,
+                           "view: holds another kind of container");
+    for(uint32_t i = 0; i < column_count; ++i) {
+        const view_column& col = header.columns[i];
+        THROW_RUNTIME_ERROR_IF(header.count != 0 && col.elem_size != elem_sizes[i],
+                               "view: element size does not match");
+        THROW_RUNTIME_ERROR_IF(col.offset > bytes.size() || header.count > (bytes.size() - col.offset) / elem_sizes[i],
+                               "view: buffer too small for the columns");
+        THROW_RUNTIME_ERROR_IF(reinterpret_cast<uintptr_t>(bytes.data() + col.offset) % elem_aligns[i] != 0,
+                               "view: column is not aligned");
+    }
+    return header;
+}
+
+inline bool verify_view(span<const unsigned char> bytes)
+{
+    const view_header& header = *reinterpret_cast<const view_header*>(bytes.data());
+    uint64_t checksum = 0;
+    for(uint32_t i = 0; i < header.column_count; ++i) {
+        const view_column& col = header.columns[i];
+        checksum = view_checksum(bytes.data() + col.offset, header.count * col.elem_size, checksum);
+    }
+    return checksum == header.checksum;
+}
+
+/**
+ * @brief A const vector over the elements of a vector view, nothing is copied
+ * @note    1. the bytes must outlive the view, open checks the header only,
+ *             verify() reads every byte and compares the checksum
+ *          2. the read API is vector's: iterators, [], at, front, back, data
+ */
+template <class T>
+class vector_view
+{
+    static_assert(std::is_trivially_copyable<T>::value, "views hold trivially copyable elements");
+
+public:
+    typedef T                                       value_type;
+    typedef const T*                                pointer;
+    typedef const T*                                const_pointer;
+    typedef const T&                                reference;
+    typedef const T&                                const_reference;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+    typedef const T*                                iterator;
+    typedef const T*                                const_iterator;
+    typedef wstl::reverse_iterator<const_iterator>  reverse_iterator;
+    typedef wstl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+private:
+    span<const unsigned char>   bytes_;
+    span<const T>               values_;
+
+public:
+    vector_view() noexcept {}
+
+    explicit vector_view(span<const unsigned char> bytes) : bytes_(bytes) {
+        const size_t size = sizeof(T);
+        const size_t align = alignof(T);
+        const view_header& header = open_view(bytes, view_kind::vector, &size, &align, 1);
+        values_ = span<const T>(reinterpret_cast<const T*>(bytes.data() + header.columns[0].offset),
+                                static_cast<size_type>(header.count));
+    }
+
+    bool verify() const {
+        return bytes_.empty() || verify_view(bytes_);
+    }
+
+    // iterator
+    const_iterator begin() const noexcept {
+        return values_.begin();
+    }
+    const_iterator end() const noexcept {
+        return values_.end();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return values_.empty();
+    }
+    size_type size() const noexcept {
+        return values_.size();
+    }
+
+    // visit
+    const_reference operator[](size_type n) const {
+        WSTL_DEBUG(n < size());
+        return values_[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size()), "vector_view<T>::at() subscript out of range");
+        return values_[n];
+    }
+    const_reference front() const {
+        WSTL_DEBUG(!empty());
+        return values_.front();
+    }
+    const_reference back() const {
+        WSTL_DEBUG(!empty());
+        return values_.back();
+    }
+    const_pointer data() const noexcept {
+        return values_.data();
+    }
+    span<const T> as_span() const noexcept {
+        return values_;
+    }
+};
+
+/**
+ * @brief A const map over a sorted key column and its value column
+ * @note    1. lookups binary search the key column, which is stored apart from
+ *             the values so the search touches keys only
+ *          2. keys compare with operator<, equal keys keep their written order
+ */
+template <class K, class V>
+class sorted_map_view
+{
+    static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                  "views hold trivially copyable elements");
+
+public:
+    typedef K               key_type;
+    typedef V               mapped_type;
+    typedef size_t          size_type;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+private:
+    span<const unsigned char>   bytes_;
+    span<const K>               keys_;
+    span<const V>               values_;
+
+public:
+    sorted_map_view() noexcept {}
+
+    explicit sorted_map_view(span<const unsigned char> bytes) : bytes_(bytes) {
+        const size_t sizes[2] = {sizeof(K), sizeof(V)};
+        const size_t aligns[2] = {alignof(K), alignof(V)};
+        const view_header& header = open_view(bytes, view_kind::sorted_map, sizes, aligns, 2);
+        const size_type n = static_cast<size_type>(header.count);
+        keys_ = span<const K>(reinterpret_cast<const K*>(bytes.data() + header.columns[0].offset), n);
+        values_ = span<const V>(reinterpret_cast<const V*>(bytes.data() + header.columns[1].offset), n);
+    }
+
+    bool verify() const {
+        return bytes_.empty() || verify_view(bytes_);
+    }
+
+    // capacity
+    bool empty() const noexcept {
+        return keys_.empty();
+    }
+    size_type size() const noexcept {
+        return keys_.size();
+    }
+
+    // columns
+    span<const K> keys() const noexcept {
+        return keys_;
+    }
+    span<const V> values() const noexcept {
+        return values_;
+    }
+    const K& key_at(size_type n) const {
+        WSTL_DEBUG(n < size());
+        return keys_[n];
+    }
+    const V& value_at(size_type n) const {
+        WSTL_DEBUG(n < size());
+        return values_[n];
+    }
+
+    // lookup
+    size_type lower_bound(const K& key) const noexcept {
+        size_type first = 0;
+        size_type len = keys_.size();
+        while(len > 0) {
+            const size_type half = len / 2;
+            if(keys_[first + half] < key) {
+                first += half + 1;
+                len -= half + 1;
+            }
+            else {
+                len = half;
+            }
+        }
+        return first;
+    }
+    // the index of key, npos when absent
+    size_type index_of(const K& key) const noexcept {
+        const size_type i = lower_bound(key);
+        return i < size() && !(key < keys_[i]) ? i : npos;
+    }
+    const V* find(const K& key) const noexcept {
+        const size_type i = index_of(key);
+        return npos == i ? nullptr : values_.data() + i;
+    }
+    bool contains(const K& key) const noexcept {
+        return npos != index_of(key);
+    }
+    const V& at(const K& key) const {
+        const V* p = find(key);
+        THROW_OUT_OF_RANGE_IF(nullptr == p, "sorted_map_view<K, V>::at() key not found");
+        return *p;
+    }
+};
+
+template <class K, class V>
+const typename sorted_map_view<K, V>::size_type sorted_map_view<K, V>::npos;
+
+}   // wstl
+
+#endif
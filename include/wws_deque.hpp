@@ -0,0 +1,231 @@
+#ifndef WWS_DEQUE_HPP__
+#define WWS_DEQUE_HPP__
+
+#include "wmemory.hpp"
+#include "walgorithm.hpp"
+
+#include <atomic>
+
+namespace wstl
+{
+
+#ifndef WSTL_CACHE_LINE_SIZE
+#define WSTL_CACHE_LINE_SIZE 64
+#endif
+
+#ifndef WS_DEQUE_INIT_SIZE
+#define WS_DEQUE_INIT_SIZE 64
+#endif
+
+/**
+ * @brief Chase-Lev work-stealing deque
+ * @note    1. the owner thread calls push_back() / pop_back() at the bottom,
+ *             any thread may call steal_front() at the top
+ *          2. slots are read racily by thieves, so T must be trivially copyable,
+ *             tasks are usually stored as pointers or small handles
+ *          3. the circular array doubles when full, a thief may still be reading
+ *             the old one, so it is kept in a retired chain and released by the
+ *             destructor (all of them together are smaller than the live array)
+ */
+template <class T>
+class ws_deque
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "the value_type of ws_deque should be trivially copyable");
+
+public:
+    typedef T               value_type;
+    typedef size_t          size_type;
+    typedef ptrdiff_t       difference_type;
+
+private:
+    struct circular_array
+    {
+        difference_type         mask;
+        std::atomic<T>*         slots;
+        circular_array*         retired;        // the array this one replaced
+
+        size_type capacity() const noexcept {
+            return static_cast<size_type>(mask + 1);
+        }
+
+        T load(difference_type i) const noexcept {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void store(difference_type i, const T& value) noexcept {
+            slots[i & mask].store(value, std::memory_order_relaxed);
+        }
+    };
+
+    typedef wstl::allocator<circular_array>     array_allocator;
+    typedef wstl::allocator<std::atomic<T>>     slot_allocator;
+
+private:
+    alignas(WSTL_CACHE_LINE_SIZE) std::atomic<difference_type>  top_;
+    alignas(WSTL_CACHE_LINE_SIZE) std::atomic<difference_type>  bottom_;
+    std::atomic<circular_array*>                                array_;
+
+public:
+    explicit ws_deque(size_type n = WS_DEQUE_INIT_SIZE) : top_(0), bottom_(0)
+    {
+        size_type cap = 2;
+        while (cap < n)
+        {
+            cap <<= 1;
+        }
+        array_.store(create_array(cap, nullptr), std::memory_order_relaxed);
+    }
+
+    ws_deque(const ws_deque&) = delete;
+    ws_deque& operator=(const ws_deque&) = delete;
+
+    ~ws_deque() {
+        circular_array* a = array_.load(std::memory_order_relaxed);
+        while (a != nullptr)
+        {
+            circular_array* retired = a->retired;
+            destroy_array(a);
+            a = retired;
+        }
+    }
+
+public:
+    /**
+     * @brief size() / empty() are a snapshot when other threads are stealing
+     */
+    size_type size() const noexcept {
+        const difference_type b = bottom_.load(std::memory_order_relaxed);
+        const difference_type t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_type>(b - t) : 0;
+    }
+
+    bool empty() const noexcept {
+        return 0 == size();
+    }
+
+    size_type capacity() const noexcept {
+        return array_.load(std::memory_order_relaxed)->capacity();
+    }
+
+    // owner only
+    void push_back(const value_type& value);
+    bool pop_back(value_type& value);
+
+    // any thread
+    bool steal_front(value_type& value);
+
+private:
+    circular_array* create_array(size_type cap, circular_array* retired);
+    void            destroy_array(circular_array* a);
+    circular_array* grow(circular_array* a, difference_type b, difference_type t);
+};
+
+/************* private ***************/
+
+template <class T>
+typename ws_deque<T>::circular_array*
+ws_deque<T>::create_array(size_type cap, circular_array* retired)
+{
+    circular_array* a = array_allocator::allocate(1);
+    try
+    {
+        a->slots = slot_allocator::allocate(cap);
+    }
+    catch(...)
+    {
+        array_allocator::deallocate(a);
+        throw;
+    }
+    for(size_type i = 0; i < cap; ++i) {
+        wstl::construct(a->slots + i);
+    }
+    a->mask = static_cast<difference_type>(cap) - 1;
+    a->retired = retired;
+    return a;
+}
+
+template <class T>
+void ws_deque<T>::destroy_array(circular_array* a)
+{
+    slot_allocator::deallocate(a->slots, a->capacity());
+    array_allocator::deallocate(a);
+}
+
+template <class T>
+typename ws_deque<T>::circular_array*
+ws_deque<T>::grow(circular_array* a, difference_type b, difference_type t)
+{
+    THROW_LENGTH_ERROR_IF(a->capacity() > static_cast<size_type>(-1) / 2 / sizeof(T),
+                          "ws_deque<T>'s size too big");
+    circular_array* bigger = create_array(a->capacity() << 1, a);
+    for(difference_type i = t; i != b; ++i) {
+        bigger->store(i, a->load(i));
+    }
+    array_.store(bigger, std::memory_order_release);
+    return bigger;
+}
+
+/************* public ***************/
+
+template <class T>
+void ws_deque<T>::push_back(const value_type& value)
+{
+    const difference_type b = bottom_.load(std::memory_order_relaxed);
+    const difference_type t = top_.load(std::memory_order_acquire);
+    circular_array* a = array_.load(std::memory_order_relaxed);
+    if(b - t > a->mask) {
+        a = grow(a, b, t);
+    }
+    a->store(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+}
+
+template <class T>
+bool ws_deque<T>::pop_back(value_type& value)
+{
+    const difference_type b = bottom_.load(std::memory_order_relaxed) - 1;
+    circular_array* a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    difference_type t = top_.load(std::memory_order_relaxed);
+
+    if(t > b) {
+        // already empty
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    value = a->load(b);
+    if(t == b) {
+        // the last element, race the thieves for it
+        const bool won = top_.compare_exchange_strong(t, t + 1,
+                                                      std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template <class T>
+bool ws_deque<T>::steal_front(value_type& value)
+{
+    difference_type t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const difference_type b = bottom_.load(std::memory_order_acquire);
+    if(t >= b) {
+        return false;
+    }
+
+    circular_array* a = array_.load(std::memory_order_acquire);
+    value = a->load(t);
+    return top_.compare_exchange_strong(t, t + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed);
+}
+
+}   // wstl
+
+#endif
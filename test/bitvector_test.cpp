@@ -0,0 +1,135 @@
+#include "wvector.hpp"
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+typedef wstl::vector<bool> bitvec;
+
+static bool sameAs(const bitvec& v, const std::vector<bool>& m)
+{
+    if(v.size() != m.size()) return false;
+    for(size_t i = 0; i < m.size(); ++i) {
+        if(v[i] != m[i]) return false;
+    }
+    size_t c = 0;
+    for(bool b : m) c += b;
+    return v.count() == c;
+}
+
+void testBasic()
+{
+    bitvec v;
+    assert(v.empty() && v.none() && v.find_first() == bitvec::npos && "vector<bool>() error");
+
+    bitvec w(130, true);
+    assert(w.size() == 130 && w.count() == 130 && w.all() && w.word_count() == 3 && "vector<bool>(n, v) error");
+    assert(sizeof(bitvec::word_type) * w.word_count() * 8 < 130 * 2 && "packing error");
+
+    w[3] = false;
+    w.reset(64).flip(129);
+    assert(!w[3] && !w.test(64) && !w.back() && w.count() == 127 && "proxy/set error");
+    w.flip();
+    assert(w.count() == 3 && w.find_first() == 3 && w.find_next(3) == 64 &&
+           w.find_next(64) == 129 && w.find_next(129) == bitvec::npos && "flip/find error");
+
+    bitvec x = {true, false, true, true};
+    assert(x.size() == 4 && x.count() == 3 && x.front() && !x[1] && "initializer_list error");
+    x.push_back(false);
+    x.pop_back();
+    x.insert(x.begin() + 1, 2, true);
+    assert(x == bitvec({true, true, true, false, true, true}) && "insert error");
+    x.erase(x.begin(), x.begin() + 3);
+    assert(x == bitvec({false, true, true}) && x < bitvec({true}) && "erase/compare error");
+
+    *x.begin() = *(x.end() - 1);
+    wstl::swap(x[1], *x.rbegin());
+    assert(x.all() && "iterator proxy error");
+
+    bool thrown = false;
+    try
+    {
+        x.at(3);
+    }
+    catch(const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "at() error");
+
+    wstl::dynamic_bitset a(200), b(200);
+    for(size_t i = 0; i < 200; i += 2) a.set(i);
+    for(size_t i = 0; i < 200; i += 3) b.set(i);
+    assert((a & b).count() == 34 && (a | b).count() == 133 && (a ^ b).count() == 99 && "bulk ops error");
+    assert((~a).count() == 100 && (~a & a).none() && "operator~ error");
+
+    a.resize(10);
+    a.resize(70, true);
+    assert(a.count() == 5 + 60 && a.find_next(9) == 10 && "resize error");
+    a.clear();
+    a.shrink_to_fit();
+    assert(a.empty() && a.capacity() == 0 && "clear/shrink error");
+
+    LOGI("test vector<bool> basic passed!");
+}
+
+// random operations against std::vector<bool>
+void testRandom()
+{
+    bitvec v;
+    std::vector<bool> m;
+    std::srand(11);
+    for(int step = 0; step < 20000; ++step) {
+        const int op = std::rand() % 6;
+        const bool value = std::rand() & 1;
+        if(op <= 1 || m.empty()) {
+            v.push_back(value);
+            m.push_back(value);
+        }
+        else if(op == 2) {
+            const size_t pos = static_cast<size_t>(std::rand()) % (m.size() + 1);
+            const size_t n = static_cast<size_t>(std::rand()) % 70;
+            v.insert(v.cbegin() + pos, n, value);
+            m.insert(m.begin() + pos, n, value);
+        }
+        else if(op == 3) {
+            const size_t f = static_cast<size_t>(std::rand()) % m.size();
+            const size_t l = f + static_cast<size_t>(std::rand()) % (m.size() - f + 1);
+            v.erase(v.cbegin() + f, v.cbegin() + l);
+            m.erase(m.begin() + f, m.begin() + l);
+        }
+        else if(op == 4) {
+            const size_t i = static_cast<size_t>(std::rand()) % m.size();
+            v[i] = value;
+            m[i] = value;
+        }
+        else {
+            const size_t n = static_cast<size_t>(std::rand()) % 300;
+            v.resize(n, value);
+            m.resize(n, value);
+        }
+    }
+    assert(sameAs(v, m) && "random error");
+
+    size_t expect = bitvec::npos;
+    for(size_t i = 0; i < m.size(); ++i) {
+        if(m[i]) { expect = i; break; }
+    }
+    for(size_t i = v.find_first(); ; i = v.find_next(i)) {
+        assert(i == expect && "random find error");
+        if(i == bitvec::npos) break;
+        expect = bitvec::npos;
+        for(size_t j = i + 1; j < m.size(); ++j) {
+            if(m[j]) { expect = j; break; }
+        }
+    }
+
+    LOGI("test vector<bool> random operations passed!");
+}
+
+int main()
+{
+    testBasic();
+    testRandom();
+    return 0;
+}
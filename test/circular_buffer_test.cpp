@@ -0,0 +1,148 @@
+#include "test_common.hpp"
+#include "wcircular_buffer.hpp"
+#include "wqueue.hpp"
+
+#include <string>
+
+void testConstruct()
+{
+    wstl::circular_buffer<int> cb;
+    assert(cb.empty() && cb.capacity() == 0 && "circular_buffer() error");
+
+    wstl::circular_buffer<int> cb_n(10);
+    assert(cb_n.size() == 10 && cb_n[0] == 0 && cb_n[9] == 0 && "circular_buffer(n) error");
+
+    wstl::circular_buffer<int> cb_n_value(10, 5);
+    assert(cb_n_value.size() == 10 && cb_n_value[0] == 5 && cb_n_value.back() == 5 && "circular_buffer(n,value) error");
+
+    int arr[] = {1,2,3,4,5};
+    wstl::circular_buffer<int> cb_iter(arr, arr + 5);
+    assert(cb_iter.size() == 5 && cb_iter.front() == 1 && cb_iter.back() == 5 && "circular_buffer(iter,iter) error");
+
+    wstl::circular_buffer<int> cb_list{1,2,3,4,5};
+    assert(cb_list == cb_iter && "circular_buffer(ilist) error");
+
+    wstl::circular_buffer<int> cb_copy(cb_list);
+    assert(cb_copy == cb_list && "circular_buffer(const circular_buffer&) error");
+
+    wstl::circular_buffer<int> cb_move(wstl::move(cb_copy));
+    assert(cb_move.size() == 5 && cb_copy.empty() && "circular_buffer(circular_buffer&&) error");
+
+    wstl::circular_buffer<int> cb_assign;
+    cb_assign = cb_move;
+    assert(cb_assign == cb_move && "operator=(const circular_buffer&) error");
+    cb_assign = {7,8};
+    assert(cb_assign.size() == 2 && cb_assign[1] == 8 && "operator=(ilist) error");
+
+    LOGI("test circular_buffer construct passed!");
+}
+
+void testPushAndPop()
+{
+    wstl::circular_buffer<std::string> cb;
+    cb.reserve(4);
+    cb.push_back("b");
+    cb.push_back("c");
+    cb.push_front("a");
+    cb.emplace_back(2, 'd');
+    assert(cb.full() && cb.capacity() == 4 && "circular_buffer push error");
+    assert(cb[0] == "a" && cb[3] == "dd" && "circular_buffer order error");
+
+    // grows while full
+    cb.push_front("z");
+    assert(cb.size() == 5 && cb.capacity() > 4 && cb.front() == "z" && cb.back() == "dd" && "circular_buffer grow error");
+
+    cb.pop_front();
+    cb.pop_back();
+    assert(cb.size() == 3 && cb.front() == "a" && cb.back() == "c" && "circular_buffer pop error");
+
+    std::string joined;
+    for(auto it = cb.begin(); it != cb.end(); ++it) {
+        joined += *it;
+    }
+    assert(joined == "abc" && (cb.end() - cb.begin()) == 3 && cb.begin()[2] == "c" && "circular_buffer iterator error");
+
+    cb.clear();
+    assert(cb.empty() && "circular_buffer clear error");
+
+    LOGI("test circular_buffer push/pop passed!");
+}
+
+void testOverwriteAndSpans()
+{
+    wstl::circular_buffer<int> cb;
+    cb.reserve(4);
+    cb.set_overwrite(true);
+    for(int i = 0; i < 6; ++i) {
+        cb.push_back(i);
+    }
+    assert(cb.size() == 4 && cb.capacity() == 4 && cb.front() == 2 && cb.back() == 5 && "circular_buffer overwrite back error");
+
+    auto spans = cb.as_spans();
+    assert(spans.first.size() == 2 && spans.first.data()[0] == 2 && "circular_buffer as_spans first error");
+    assert(spans.second.size() == 2 && spans.second.data()[0] == 4 && "circular_buffer as_spans second error");
+
+    cb.push_front(1);
+    assert(cb.size() == 4 && cb.front() == 1 && cb.back() == 4 && "circular_buffer overwrite front error");
+
+    int* data = cb.linearize();
+    assert(data[0] == 1 && data[3] == 4 && cb.as_spans().second.empty() && "circular_buffer linearize error");
+
+    // a copy keeps the capacity, so it keeps dropping its oldest elements
+    wstl::circular_buffer<int> copy(cb);
+    for(int i = 10; i < 16; ++i) {
+        copy.push_back(i);
+    }
+    assert(copy.overwrite() && copy.capacity() == 4 && copy.size() == 4 && copy.front() == 12 &&
+           copy.back() == 15 && "circular_buffer copy overwrite error");
+
+    copy = {20, 21, 22, 23, 24, 25};
+    assert(copy.capacity() == 4 && copy.size() == 4 && copy.front() == 22 && copy.back() == 25 &&
+           "circular_buffer assign ilist overwrite error");
+
+    LOGI("test circular_buffer overwrite/spans passed!");
+}
+
+void testSelfReference()
+{
+    // an argument that refers to an element survives the growth it triggers
+    wstl::circular_buffer<std::string> cb;
+    cb.reserve(2);
+    cb.push_back(std::string(40, 'a'));
+    cb.push_back(std::string(40, 'b'));
+    cb.push_back(cb[0]);
+    assert(cb.size() == 3 && cb.back() == std::string(40, 'a') && cb.front() == std::string(40, 'a') &&
+           "circular_buffer push_back own element error");
+    cb.shrink_to_fit();
+    cb.push_front(cb[1]);
+    assert(cb.size() == 4 && cb.front() == std::string(40, 'b') && cb[2] == std::string(40, 'b') &&
+           "circular_buffer push_front own element error");
+
+    LOGI("test circular_buffer self reference passed!");
+}
+
+void testQueueAdapter()
+{
+    wstl::queue<int, wstl::circular_buffer<int>> q{1,2,3};
+    q.push(4);
+    q.emplace(5);
+    assert(q.size() == 5 && q.front() == 1 && q.back() == 5 && "queue<circular_buffer> push error");
+
+    q.pop();
+    assert(q.size() == 4 && q.front() == 2 && "queue<circular_buffer> pop error");
+
+    wstl::queue<int, wstl::circular_buffer<int>> q_copy(q);
+    assert(q_copy == q && "queue<circular_buffer> operator== error");
+
+    LOGI("test queue<circular_buffer> passed!");
+}
+
+int main()
+{
+    testConstruct();
+    testPushAndPop();
+    testOverwriteAndSpans();
+    testSelfReference();
+    testQueueAdapter();
+    return 0;
+}
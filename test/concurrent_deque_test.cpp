@@ -0,0 +1,88 @@
+#include "test_common.hpp"
+#include "wconcurrent_deque.hpp"
+
+#include <string>
+#include <thread>
+
+void testSingleThread()
+{
+    wstl::concurrent_deque<int> dq;
+    assert(dq.empty() && "concurrent_deque() error");
+
+    int value = 0;
+    assert(!dq.try_pop_front(value) && "concurrent_deque try_pop_front on empty error");
+
+    // cross several segments so they get linked, retired and recycled
+    const int count = static_cast<int>(wstl::concurrent_deque<int>::buffer_size) * 5 + 7;
+    for(int round = 0; round < 3; ++round) {
+        for(int i = 0; i < count; ++i) {
+            dq.push_back(i);
+        }
+        assert(!dq.empty() && "concurrent_deque push_back error");
+        for(int i = 0; i < count; ++i) {
+            assert(dq.try_pop_front(value) && value == i && "concurrent_deque FIFO order error");
+        }
+        assert(dq.empty() && !dq.try_pop_front(value) && "concurrent_deque drain error");
+    }
+
+    wstl::concurrent_deque<std::string> str_dq;
+    str_dq.emplace_back(3, 'a');
+    str_dq.push_back(std::string("hello"));
+    str_dq.push_back(std::string("left in the deque"));
+    std::string str;
+    assert(str_dq.try_pop_front(str) && str == "aaa" && "concurrent_deque emplace_back error");
+    assert(str_dq.try_pop_front(str) && str == "hello" && "concurrent_deque push_back(&&) error");
+
+    LOGI("test concurrent_deque single thread passed!");
+}
+
+void testThreads()
+{
+    const int producers = 4;
+    const int consumers = 4;
+    const int per_producer = 100000;
+
+    wstl::concurrent_deque<long long> dq;
+    std::atomic<long long> sum(0);
+    std::atomic<int> popped(0);
+
+    std::thread threads[producers + consumers];
+    for(int p = 0; p < producers; ++p) {
+        threads[p] = std::thread([&dq, p, per_producer]() {
+            for(int i = 0; i < per_producer; ++i) {
+                dq.push_back(static_cast<long long>(p) * per_producer + i);
+            }
+        });
+    }
+    for(int c = 0; c < consumers; ++c) {
+        threads[producers + c] = std::thread([&]() {
+            long long value = 0;
+            while (popped.load() < producers * per_producer)
+            {
+                if(dq.try_pop_front(value)) {
+                    sum.fetch_add(value);
+                    popped.fetch_add(1);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(auto& t : threads) {
+        t.join();
+    }
+
+    const long long n = static_cast<long long>(producers) * per_producer;
+    assert(popped.load() == n && sum.load() == n * (n - 1) / 2 && "concurrent_deque MPMC sum error");
+    assert(dq.empty() && "concurrent_deque MPMC drain error");
+
+    LOGI("test concurrent_deque threads passed!");
+}
+
+int main()
+{
+    testSingleThread();
+    testThreads();
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "wconcurrent_lru_cache.hpp"
+#include "test_common.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+typedef wstl::concurrent_lru_cache<int, int> int_cache;
+
+void testSingleThread()
+{
+    int_cache cache(256, 6);
+    assert(cache.shard_count() == 8 && "shard count error");
+
+    for(int i = 0; i < 32; ++i) {
+        cache.put(i, i * 3);
+    }
+    int v = 0;
+    assert(cache.get(5, v) && v == 15 && "get error");
+    assert(!cache.get(100, v) && "get(missing) error");
+    assert(cache.contains(31) && cache.erase(31) && !cache.contains(31) && "erase error");
+    assert(cache.size() == 31 && "size error");
+
+    wstl::lru_cache_stats st = cache.stats();
+    assert(st.hits == 1 && st.misses == 1 && st.insertions == 32 && "stats error");
+
+    cache.clear();
+    assert(cache.size() == 0 && "clear error");
+
+    LOGI("test concurrent_lru_cache single thread passed!");
+}
+
+void testThreads()
+{
+    const int kThreads = 4;
+    const int kOps = 50000;
+    const int kCapacity = 256;
+    int_cache cache(kCapacity, 8);
+    std::atomic<int> evicted(0);
+    cache.set_eviction_callback([&](const int&, int&) {
+        evicted.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::atomic<bool> bad_value(false);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            unsigned seed = static_cast<unsigned>(t + 1);
+            for(int i = 0; i < kOps; ++i) {
+                seed = seed * 1103515245u + 12345u;
+                const int key = static_cast<int>((seed >> 8) % 1024);
+                int v = 0;
+                if(cache.get(key, v)) {
+                    if(v != key * 3) bad_value.store(true);
+                }
+                else {
+                    cache.put(key, key * 3);
+                }
+            }
+        });
+    }
+    for(auto& th : threads) {
+        th.join();
+    }
+
+    wstl::lru_cache_stats st = cache.stats();
+    assert(!bad_value.load() && "concurrent value error");
+    assert(st.hits + st.misses == static_cast<size_t>(kThreads * kOps) && "concurrent stats error");
+    assert(cache.size() <= static_cast<size_t>(kCapacity) && "concurrent capacity error");
+    assert(st.evictions == static_cast<size_t>(evicted.load()) &&
+           st.insertions - st.evictions == cache.size() && "concurrent eviction error");
+
+    LOGI("test concurrent_lru_cache threads passed!");
+}
+
+int main()
+{
+    testSingleThread();
+    testThreads();
+    return 0;
+}
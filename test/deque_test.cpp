@@ -1,5 +1,8 @@
 #include "test_common.hpp"
 #include "wdeque.hpp"
+#include "wlist.hpp"
+
+#include <string>
 
 void testConstruct()
 {
@@ -138,6 +141,237 @@ void testSwap()
     LOGI("test swap passed!");
 }
 
+void testRecycle()
+{
+    // a FIFO window sliding across many buffers
+    wstl::deque<int> window;
+    int next_pop = 0;
+    for(int i = 0; i < 20000; ++i) {
+        window.push_back(i);
+        if(window.size() > 1500) {
+            assert(window.front() == next_pop && "sliding window order error");
+            window.pop_front();
+            ++next_pop;
+        }
+    }
+    assert(window.size() == 1500 && window.back() == 19999 && "sliding window size error");
+
+    // oscillate around a buffer boundary at both ends
+    const int buf = static_cast<int>(wstl::deque<int>::buffer_size);
+    wstl::deque<int> edge;
+    for(int i = 0; i < buf; ++i) {
+        edge.push_back(i);
+    }
+    for(int round = 0; round < 100; ++round) {
+        edge.push_back(-1);
+        edge.push_front(-2);
+        assert(edge.back() == -1 && edge.front() == -2 && "boundary push error");
+        edge.pop_back();
+        edge.pop_front();
+    }
+    assert(edge.size() == static_cast<size_t>(buf) && edge.front() == 0 && edge.back() == buf - 1 && "boundary pop error");
+
+    edge.shrink_to_fit();
+    edge.push_back(buf);
+    assert(edge.size() == static_cast<size_t>(buf + 1) && edge[buf] == buf && "shrink_to_fit error");
+
+    wstl::deque<int> front_growth;
+    for(int i = 0; i < 20 * buf; ++i) {
+        front_growth.push_front(i);
+    }
+    assert(front_growth.front() == 20 * buf - 1 && front_growth.back() == 0 && "push_front growth error");
+
+    LOGI("test recycle passed!");
+}
+
+void testSegmentedAlgorithms()
+{
+    const int n = 3 * static_cast<int>(wstl::deque<int>::buffer_size) + 17;
+    wstl::deque<int> src;
+    for(int i = 0; i < n; ++i) {
+        src.push_back(i);
+    }
+    src.pop_front();
+    src.push_front(0);      // begin_ no longer at the start of a buffer
+
+    wstl::deque<int> dst(n, -1);
+    assert(wstl::copy(src.begin() + 5, src.end(), dst.begin()) == dst.end() - 5 && "copy(deque, deque) error");
+    assert(dst[0] == 5 && dst[n - 6] == n - 1 && dst[n - 5] == -1 && "copy(deque, deque) value error");
+
+    int* arr = new int[n];
+    assert(wstl::copy(src.begin(), src.end(), arr) == arr + n && arr[0] == 0 && arr[n - 1] == n - 1 && "copy(deque, pointer) error");
+    wstl::fill(dst.begin(), dst.end(), 7);
+    assert(dst.front() == 7 && dst.back() == 7 && dst[n / 2] == 7 && "fill(deque) error");
+    wstl::copy(arr, arr + n, dst.begin());
+    assert(dst[0] == 0 && dst[n - 1] == n - 1 && "copy(pointer, deque) error");
+    delete[] arr;
+
+    // overlapping shift, as erase() does
+    wstl::copy_backward(dst.begin(), dst.end() - 3, dst.end());
+    assert(dst[3] == 0 && dst[n - 1] == n - 4 && dst[2] == 2 && "copy_backward(deque, deque) error");
+    wstl::copy(dst.begin() + 3, dst.end(), dst.begin());
+    assert(dst[0] == 0 && dst[n - 4] == n - 4 && "copy(deque, deque) overlap error");
+
+    assert(*wstl::find(src.begin(), src.end(), n - 2) == n - 2 && "find(deque) error");
+    assert(wstl::find(src.begin(), src.end(), n) == src.end() && "find(deque) not found error");
+
+    wstl::deque<std::string> words(n, "word");
+    wstl::deque<std::string> moved(n);
+    wstl::move(words.begin(), words.end(), moved.begin());
+    assert(moved[0] == "word" && moved[n - 1] == "word" && words[0].empty() && "move(deque, deque) error");
+
+    wstl::deque<std::string> inserted{"a", "b"};
+    inserted.insert(inserted.begin() + 1, moved.begin(), moved.end());
+    assert(inserted.size() == static_cast<size_t>(n + 2) && inserted[1] == "word" && inserted.back() == "b" && "insert(deque range) error");
+    inserted.insert(inserted.end() - 1, static_cast<size_t>(n), "x");
+    assert(inserted[n + 1] == "x" && inserted.back() == "b" && "insert(n, value) error");
+
+    LOGI("test segmented algorithms passed!");
+}
+
+void testAppendRange()
+{
+    const int n = 2 * static_cast<int>(wstl::deque<int>::buffer_size) + 9;
+    int* arr = new int[n];
+    for(int i = 0; i < n; ++i) {
+        arr[i] = i;
+    }
+
+    wstl::deque<int> dq{-1};
+    dq.append_range(arr, arr + n);
+    assert(dq.size() == static_cast<size_t>(n + 1) && dq[1] == 0 && dq.back() == n - 1 && "append_range error");
+    dq.prepend_range(arr, arr + n);
+    assert(dq.size() == static_cast<size_t>(2 * n + 1) && dq.front() == 0 && dq[n - 1] == n - 1 && dq[n] == -1 && "prepend_range error");
+    delete[] arr;
+
+    wstl::list<std::string> words{"a", "b", "c"};
+    wstl::deque<std::string> ws{"x"};
+    ws.append_range(words.begin(), words.end());
+    ws.prepend_range(words.begin(), words.end());
+    assert(ws.size() == 7 && ws[0] == "a" && ws[2] == "c" && ws[3] == "x" && ws[6] == "c" && "append_range(list) error");
+
+    wstl::deque<int> raw{1, 2};
+    raw.resize_for_overwrite(static_cast<size_t>(n));
+    assert(raw.size() == static_cast<size_t>(n) && raw[1] == 2 && "resize_for_overwrite grow error");
+    raw[n - 1] = 42;
+    assert(raw.back() == 42 && "resize_for_overwrite write error");
+    raw.resize_for_overwrite(1);
+    assert(raw.size() == 1 && raw[0] == 1 && "resize_for_overwrite shrink error");
+    ws.resize_for_overwrite(9);
+    assert(ws.size() == 9 && ws[8].empty() && "resize_for_overwrite(string) error");
+
+    LOGI("test append range passed!");
+}
+
+void testBufSize()
+{
+    // 4 elements per buffer: every few operations cross a buffer and touch the map
+    wstl::deque<int, 4> small;
+    assert((wstl::deque<int, 4>::buffer_size == 4) && "deque<T, BufSize> buffer_size error");
+    wstl::deque<int> ref;
+    unsigned seed = 7;
+    for(int i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const unsigned op = (seed >> 16) % 6;
+        if(op == 0 || op == 1) {
+            small.push_back(i);
+            ref.push_back(i);
+        }
+        else if(op == 2) {
+            small.push_front(i);
+            ref.push_front(i);
+        }
+        else if(op == 3 && !ref.empty()) {
+            small.pop_front();
+            ref.pop_front();
+        }
+        else if(op == 4 && !ref.empty()) {
+            small.pop_back();
+            ref.pop_back();
+        }
+        else if(op == 5 && ref.size() > 2) {
+            small.erase(small.begin() + 1);
+            ref.erase(ref.begin() + 1);
+        }
+    }
+    assert(small.size() == ref.size() && "deque<T, BufSize> size error");
+    for(size_t i = 0; i < ref.size(); ++i) {
+        assert(small[i] == ref[i] && "deque<T, BufSize> value error");
+    }
+
+    // a FIFO drifting to the back is recentered instead of growing the map
+    wstl::deque<int, 4> fifo;
+    for(int i = 0; i < 100000; ++i) {
+        fifo.push_back(i);
+        if(fifo.size() > 10) fifo.pop_front();
+    }
+    assert(fifo.front() == 99990 && fifo.back() == 99999 && "deque recenter map error");
+    for(int i = 0; i < 100000; ++i) {
+        fifo.push_front(i);
+        if(fifo.size() > 10) fifo.pop_back();
+    }
+    assert(fifo.front() == 99999 && fifo.back() == 99990 && "deque recenter map at front error");
+
+    // buffers smaller than a pointer still have room for the spare chain link
+    wstl::deque<char, 2> tiny;
+    for(int i = 0; i < 100; ++i) {
+        tiny.push_back(static_cast<char>(i));
+    }
+    for(int i = 0; i < 60; ++i) {
+        tiny.pop_front();
+    }
+    for(int i = 0; i < 60; ++i) {
+        tiny.push_front(static_cast<char>(59 - i));
+    }
+    assert(tiny.size() == 100 && tiny.front() == 0 && tiny[99] == 99 && "deque<char, 2> spare buffer error");
+    assert(tiny.memory_usage().reserved_bytes >= tiny.memory_usage().buffers * sizeof(char*) && "deque<char, 2> reserved error");
+
+    // shrinking across buffers destroys every element it drops
+    wstl::deque<std::string, 2> words;
+    for(int i = 0; i < 9; ++i) {
+        words.push_back(std::string(40, static_cast<char>('a' + i)));
+    }
+    words.resize_for_overwrite(4);
+    assert(words.size() == 4 && words.back() == std::string(40, 'd') && "resize_for_overwrite shrink error");
+    for(int i = 0; i < 6; ++i) {
+        words.push_back(std::string(40, 'z'));
+    }
+    words.erase(words.begin(), words.begin() + 5);
+    assert(words.size() == 5 && words.front() == std::string(40, 'z') && "erase across buffers error");
+
+    LOGI("test buffer size passed!");
+}
+
+void testMemoryUsage()
+{
+    const size_t buf = wstl::deque<int>::buffer_size;
+    wstl::deque<int> dq;
+    for(size_t i = 0; i < 100 * buf; ++i) {
+        dq.push_back(static_cast<int>(i));
+    }
+    wstl::deque_memory_usage peak = dq.memory_usage();
+    assert(peak.live_bytes == 100 * buf * sizeof(int) && peak.buffers >= 100 && peak.map_slots > 100 && "memory_usage() error");
+    assert(peak.reserved_bytes >= peak.live_bytes + peak.map_slots * sizeof(int*) && "memory_usage() reserved error");
+
+    while (dq.size() > buf / 2)
+    {
+        dq.pop_front();
+    }
+    dq.shrink_to_fit();
+    wstl::deque_memory_usage after = dq.memory_usage();
+    assert(after.buffers <= 2 && after.spare_buffers == 0 && after.map_slots == DEQUE_MAP_INIT_SIZE && "shrink_to_fit compact error");
+    assert(after.reserved_bytes < peak.reserved_bytes / 10 && "shrink_to_fit reserved error");
+    assert(dq.size() == buf / 2 && dq.back() == static_cast<int>(100 * buf - 1) && "shrink_to_fit value error");
+
+    dq.push_front(-1);
+    for(size_t i = 0; i < 3 * buf; ++i) {
+        dq.push_back(0);
+    }
+    assert(dq.front() == -1 && dq[buf / 2] == static_cast<int>(100 * buf - 1) && "push after shrink_to_fit error");
+
+    LOGI("test memory usage passed!");
+}
+
 int main()
 {
     testConstruct();
@@ -147,5 +381,10 @@ int main()
     testInsert();
     testErase();
     testSwap();
+    testRecycle();
+    testSegmentedAlgorithms();
+    testAppendRange();
+    testBufSize();
+    testMemoryUsage();
     return 0;
 }
\ No newline at end of file
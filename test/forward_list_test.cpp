@@ -0,0 +1,191 @@
+#include "wforward_list.hpp"
+#include "wpool_allocator.hpp"
+#include "test_common.hpp"
+
+#include <string>
+#include <thread>
+
+typedef wstl::forward_list<int>                             int_flist;
+typedef wstl::forward_list<int, wstl::pool_allocator>       pool_flist;
+
+template <class List>
+static bool idsAre(const List& lst, std::initializer_list<int> ids)
+{
+    auto it = lst.begin();
+    for(int id : ids) {
+        if(it == lst.end() || *it != id) return false;
+        ++it;
+    }
+    return it == lst.end();
+}
+
+void testConstructor()
+{
+    int_flist empty_list;
+    assert(empty_list.empty() && empty_list.begin() == empty_list.end() && "forward_list() error");
+
+    int_flist n_list(4, 7);
+    assert(wstl::distance(n_list.begin(), n_list.end()) == 4 && n_list.front() == 7 && "forward_list(n, value) error");
+
+    int_flist ilist{1, 2, 3};
+    int_flist copy_list(ilist);
+    assert(copy_list == ilist && idsAre(copy_list, {1, 2, 3}) && "forward_list(const&) error");
+
+    int_flist move_list(wstl::move(copy_list));
+    assert(copy_list.empty() && move_list == ilist && "forward_list(&&) error");
+
+    move_list = {5, 6};
+    copy_list = move_list;
+    assert(idsAre(copy_list, {5, 6}) && "operator= error");
+
+    copy_list.assign(3, 1);
+    assert(idsAre(copy_list, {1, 1, 1}) && "assign(n, value) error");
+
+    wstl::forward_list<std::string> str_list{"a", "b"};
+    str_list.push_front("z");
+    assert(str_list.front() == "z" && "forward_list<string> error");
+
+    // the node is one pointer plus the value
+    static_assert(sizeof(wstl::forward_list_node<long>) == 2 * sizeof(void*), "forward_list node size error");
+
+    LOGI("test forward_list constructor passed!");
+}
+
+void testInsertErase()
+{
+    int_flist lst;
+    lst.push_front(3);
+    lst.push_front(1);
+    auto it = lst.insert_after(lst.begin(), 2);
+    assert(*it == 2 && idsAre(lst, {1, 2, 3}) && "insert_after error");
+
+    it = lst.insert_after(it, {20, 21});
+    assert(*it == 21 && idsAre(lst, {1, 2, 20, 21, 3}) && "insert_after(ilist) error");
+
+    it = lst.erase_after(lst.begin());
+    assert(*it == 20 && idsAre(lst, {1, 20, 21, 3}) && "erase_after error");
+
+    auto last = lst.begin();
+    wstl::advance(last, 3);
+    it = lst.erase_after(lst.begin(), last);
+    assert(*it == 3 && idsAre(lst, {1, 3}) && "erase_after(range) error");
+
+    lst.emplace_after(lst.before_begin(), 0);
+    lst.pop_front();
+    assert(idsAre(lst, {1, 3}) && "emplace_after/pop_front error");
+
+    lst.resize(4, 9);
+    assert(idsAre(lst, {1, 3, 9, 9}) && "resize(grow) error");
+    lst.resize(1);
+    assert(idsAre(lst, {1}) && "resize(shrink) error");
+
+    lst.clear();
+    assert(lst.empty() && "clear error");
+
+    LOGI("test forward_list insert/erase passed!");
+}
+
+void testListOperations()
+{
+    int_flist a{1, 2, 3};
+    int_flist b{10, 20, 30, 40};
+
+    a.splice_after(a.begin(), b, b.begin());
+    assert(idsAre(a, {1, 20, 2, 3}) && idsAre(b, {10, 30, 40}) && "splice_after(element) error");
+
+    a.splice_after(a.before_begin(), b, b.begin(), b.end());
+    assert(idsAre(a, {30, 40, 1, 20, 2, 3}) && idsAre(b, {10}) && "splice_after(range) error");
+
+    a.splice_after(a.before_begin(), b);
+    assert(b.empty() && idsAre(a, {10, 30, 40, 1, 20, 2, 3}) && "splice_after(list) error");
+
+    a.sort();
+    assert(idsAre(a, {1, 2, 3, 10, 20, 30, 40}) && "sort error");
+
+    a.remove_if([](int v) { return v >= 20; });
+    assert(idsAre(a, {1, 2, 3, 10}) && "remove_if error");
+
+    b = {0, 2, 2, 5, 11};
+    a.merge(b);
+    assert(b.empty() && idsAre(a, {0, 1, 2, 2, 2, 3, 5, 10, 11}) && "merge error");
+
+    a.unique();
+    assert(idsAre(a, {0, 1, 2, 3, 5, 10, 11}) && "unique error");
+
+    a.remove(5);
+    a.reverse();
+    assert(idsAre(a, {11, 10, 3, 2, 1, 0}) && "remove/reverse error");
+
+    a.sort(wstl::greater<int>());
+    assert(idsAre(a, {11, 10, 3, 2, 1, 0}) && "sort(comp) error");
+
+    wstl::forward_list<std::string> words{"x", "y", "x", "z", "x"};
+    words.remove(words.front());
+    assert(words == wstl::forward_list<std::string>({"y", "z"}) && "remove(own element) error");
+
+    LOGI("test forward_list list operations passed!");
+}
+
+void testPoolAllocator()
+{
+    {
+        pool_flist lst;
+        for(int i = 0; i < 5000; ++i) {
+            lst.push_front(i);
+        }
+        lst.sort();
+        assert(lst.front() == 0 && wstl::distance(lst.begin(), lst.end()) == 5000 && "pool forward_list error");
+    }
+
+    // freed nodes are handed out again
+    int* p = wstl::pool_allocator<int>::allocate();
+    wstl::pool_allocator<int>::deallocate(p);
+    int* q = wstl::pool_allocator<int>::allocate();
+    assert(p == q && "pool_allocator reuse error");
+    wstl::pool_allocator<int>::deallocate(q);
+
+    int* arr = wstl::pool_allocator<int>::allocate(8);
+    wstl::pool_allocator<int>::deallocate(arr, 8);
+
+    // a pool outlives its thread until the last of its nodes is freed elsewhere
+    typedef wstl::forward_list<long, wstl::pool_allocator> pool_llist;
+    const size_t chunks_before = wstl::pool_allocator<wstl::forward_list_node<long>>::chunk_count();
+    pool_llist produced;
+    std::thread producer([&produced]() {
+        for(long i = 0; i < 5000; ++i) {
+            produced.push_front(i);
+        }
+        pool_llist scratch(3000, 1L);
+    });
+    producer.join();
+    assert(wstl::pool_allocator<wstl::forward_list_node<long>>::chunk_count() > chunks_before &&
+           produced.front() == 4999 && "pool_allocator cross thread error");
+    produced.clear();
+    assert(wstl::pool_allocator<wstl::forward_list_node<long>>::chunk_count() == chunks_before &&
+           "pool_allocator thread exit leak error");
+
+    // frees from another thread go back to the owner's pool
+    std::thread consumer([&produced]() {
+        for(long i = 0; i < 3000; ++i) {
+            produced.push_front(i);
+        }
+    });
+    consumer.join();
+    std::thread cleaner([&produced]() {
+        produced.clear();
+    });
+    cleaner.join();
+    assert(wstl::pool_allocator<wstl::forward_list_node<long>>::chunk_count() == chunks_before &&
+           "pool_allocator remote free error");
+
+    LOGI("test pool_allocator passed!");
+}
+
+int main()
+{
+    testConstructor();
+    testInsertErase();
+    testListOperations();
+    testPoolAllocator();
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "winline_deque.hpp"
+#include "test_common.hpp"
+
+#include <string>
+
+void testPushPop()
+{
+    wstl::inline_deque<int, 4> dq;
+    assert(dq.empty() && dq.capacity() == 4 && "inline_deque() error");
+
+    dq.push_back(2);
+    dq.push_back(3);
+    dq.push_front(1);
+    dq.push_front(0);
+    assert(dq.full() && dq.front() == 0 && dq.back() == 3 && dq[1] == 1 && "push error");
+
+    bool thrown = false;
+    try
+    {
+        dq.push_back(4);
+    }
+    catch(const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && dq.size() == 4 && dq.back() == 3 && "push when full error");
+
+    // wrap around several times
+    for(int i = 4; i < 100; ++i) {
+        dq.pop_front();
+        dq.push_back(i);
+    }
+    assert(dq.front() == 96 && dq.back() == 99 && "wrap error");
+    int expect = 96;
+    for(auto it = dq.begin(); it != dq.end(); ++it) {
+        assert(*it == expect++ && "iterator error");
+    }
+    auto spans = dq.as_spans();
+    assert(spans.first.size() + spans.second.size() == 4 && "as_spans error");
+
+    dq.pop_back();
+    dq.pop_front();
+    assert(dq.size() == 2 && dq.front() == 97 && dq.back() == 98 && "pop error");
+
+    LOGI("test inline_deque push/pop passed!");
+}
+
+void testCopyMove()
+{
+    wstl::inline_deque<std::string, 5> a = {"b", "c"};
+    a.emplace_front("a");
+    a.emplace_back(2, 'd');
+    wstl::inline_deque<std::string, 5> b(a);
+    assert(b == a && b.size() == 4 && b[3] == "dd" && "copy error");
+
+    wstl::inline_deque<std::string, 5> c(wstl::move(a));
+    assert(c == b && "move error");
+
+    a = {"x"};
+    wstl::swap(a, c);
+    assert(a == b && c.size() == 1 && c.front() == "x" && "swap error");
+    a.clear();
+    assert(a.empty() && a != b && "clear error");
+
+    LOGI("test inline_deque copy/move passed!");
+}
+
+int main()
+{
+    testPushPop();
+    testCopyMove();
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "test_common.hpp"
+#include "wintrusive_list.hpp"
+
+struct timer_tag {};
+
+struct Conn : public wstl::intrusive_list_hook<>,
+              public wstl::auto_unlink_hook<timer_tag>
+{
+    int id;
+
+    explicit Conn(int i = 0) : id(i) {}
+
+    bool operator<(const Conn& rhs) const {
+        return id < rhs.id;
+    }
+
+    bool operator==(const Conn& rhs) const {
+        return id == rhs.id;
+    }
+};
+
+typedef wstl::intrusive_list<Conn>              conn_list;
+typedef wstl::intrusive_list<Conn, timer_tag>   timer_list;
+
+static bool idsAre(const conn_list& lst, std::initializer_list<int> ids)
+{
+    auto it = lst.begin();
+    for(int id : ids) {
+        if(it == lst.end() || it->id != id) return false;
+        ++it;
+    }
+    return it == lst.end();
+}
+
+void testPushAndUnlink()
+{
+    Conn a(1), b(2), c(3);
+    conn_list lst;
+    assert(lst.empty() && lst.size() == 0 && "intrusive_list() error");
+
+    lst.push_back(b);
+    lst.push_front(a);
+    lst.push_back(c);
+    assert(lst.size() == 3 && lst.front().id == 1 && lst.back().id == 3 && "push_front/push_back error");
+    assert(b.wstl::intrusive_list_hook<>::is_linked() && "is_linked error");
+
+    // unlink from the object itself, O(1)
+    b.wstl::intrusive_list_hook<>::unlink();
+    assert(idsAre(lst, {1, 3}) && !b.wstl::intrusive_list_hook<>::is_linked() && "hook unlink error");
+
+    lst.insert(lst.iterator_to(c), b);
+    assert(idsAre(lst, {1, 2, 3}) && "insert/iterator_to error");
+
+    lst.erase(lst.begin());
+    lst.pop_back();
+    assert(idsAre(lst, {2}) && !a.wstl::intrusive_list_hook<>::is_linked() && "erase/pop_back error");
+
+    lst.clear();
+    assert(lst.empty() && !b.wstl::intrusive_list_hook<>::is_linked() && "clear error");
+
+    LOGI("test push and unlink passed!");
+}
+
+void testAutoUnlink()
+{
+    timer_list timers;
+    Conn a(1);
+    timers.push_back(a);
+    {
+        Conn b(2);
+        timers.push_back(b);
+        assert(timers.size() == 2 && "timer list push error");
+    }
+    assert(timers.size() == 1 && timers.front().id == 1 && "auto_unlink_hook error");
+
+    // the same object in two lists through two hooks
+    conn_list conns;
+    conns.push_back(a);
+    timers.pop_front();
+    assert(conns.size() == 1 && timers.empty() && "two hooks error");
+    conns.clear();
+
+    LOGI("test auto unlink passed!");
+}
+
+void testSpliceMergeSort()
+{
+    Conn pool[10];
+    for(int i = 0; i < 10; ++i) {
+        pool[i].id = i;
+    }
+
+    conn_list x, y;
+    for(int i = 0; i < 10; i += 2) x.push_back(pool[i]);
+    for(int i = 1; i < 10; i += 2) y.push_back(pool[i]);
+
+    x.merge(y);
+    assert(y.empty() && idsAre(x, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}) && "merge error");
+
+    x.reverse();
+    assert(idsAre(x, {9, 8, 7, 6, 5, 4, 3, 2, 1, 0}) && "reverse error");
+
+    x.sort();
+    assert(idsAre(x, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}) && "sort error");
+
+    auto mid = x.begin();
+    wstl::advance(mid, 5);
+    y.splice(y.end(), x, mid, x.end());
+    assert(idsAre(x, {0, 1, 2, 3, 4}) && idsAre(y, {5, 6, 7, 8, 9}) && "splice(range) error");
+
+    y.splice(y.begin(), x, x.begin());
+    x.splice(x.begin(), y);
+    assert(y.empty() && idsAre(x, {0, 5, 6, 7, 8, 9, 1, 2, 3, 4}) && "splice error");
+
+    x.remove_if([](const Conn& c) { return c.id % 2 == 1; });
+    assert(idsAre(x, {0, 6, 8, 2, 4}) && "remove_if error");
+
+    x.sort([](const Conn& l, const Conn& r) { return l.id > r.id; });
+    assert(idsAre(x, {8, 6, 4, 2, 0}) && "sort(comp) error");
+
+    x.swap(y);
+    assert(x.empty() && idsAre(y, {8, 6, 4, 2, 0}) && "swap error");
+
+    conn_list z(wstl::move(y));
+    assert(y.empty() && z.size() == 5 && "intrusive_list(&&) error");
+
+    int disposed = 0;
+    z.clear_and_dispose([&](Conn* c) { disposed += c->id; });
+    assert(z.empty() && disposed == 20 && "clear_and_dispose error");
+
+    LOGI("test splice/merge/sort passed!");
+}
+
+void testUnique()
+{
+    Conn c[6] = {Conn(1), Conn(1), Conn(2), Conn(3), Conn(3), Conn(3)};
+    conn_list lst;
+    for(auto& e : c) lst.push_back(e);
+    lst.unique();
+    assert(idsAre(lst, {1, 2, 3}) && !c[1].wstl::intrusive_list_hook<>::is_linked() && "unique error");
+    lst.clear();
+
+    LOGI("test unique passed!");
+}
+
+int main()
+{
+    testPushAndUnlink();
+    testAutoUnlink();
+    testSpliceMergeSort();
+    testUnique();
+    return 0;
+}
@@ -2,6 +2,8 @@
 #include "test_common.hpp"
 #include "wvector.hpp"
 
+#include <string>
+
 void testConstrucotr()
 {
     wstl::list<int> w_list;
@@ -257,6 +259,43 @@ void testReverse()
     LOGI("test reverse passed!");
 }
 
+void testNodeHandle()
+{
+    wstl::list<int> a{1, 2, 3};
+    wstl::list<int> b{10};
+
+    const int* addr = &*(++a.begin());
+    auto nh = a.extract(++a.begin());
+    assert(!nh.empty() && nh.value() == 2 && a.size() == 2 && "extract error");
+
+    nh.value() = 20;
+    auto it = b.insert(b.end(), wstl::move(nh));
+    assert(nh.empty() && *it == 20 && &*it == addr && b.size() == 2 && b.back() == 20 && "insert(node_type) error");
+
+    it = b.insert(b.begin(), wstl::list<int>::node_type());
+    assert(it == b.begin() && b.size() == 2 && "insert(empty node_type) error");
+
+    // an extracted node that is never inserted is destroyed by its handle
+    {
+        auto dropped = a.extract(a.begin());
+        assert(a.size() == 1 && *a.begin() == 3 && "extract front error");
+    }
+
+    // erase keeps the node, the next insert takes it back
+    const int* erased = &b.front();
+    b.pop_front();
+    b.push_back(30);
+    assert(&b.back() == erased && b.size() == 2 && "free node reuse error");
+
+    wstl::list<std::string> s{"x", "y"};
+    auto sh = s.extract(s.begin());
+    s.insert(s.end(), wstl::move(sh));
+    s.shrink_to_fit();
+    assert(s.front() == "y" && s.back() == "x" && "node_type<string> error");
+
+    LOGI("test wlist node handle passed!");
+}
+
 int main()
 {
     testConstrucotr();
@@ -270,5 +309,6 @@ int main()
     testUnique();
     testMerge();
     testReverse();
+    testNodeHandle();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "wlru_cache.hpp"
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <string>
+
+typedef wstl::lru_cache<int, int> int_cache;
+
+template <class Cache>
+static bool keysAre(const Cache& cache, std::initializer_list<int> keys)
+{
+    auto it = cache.begin();
+    for(int k : keys) {
+        if(it == cache.end() || it->key != k) return false;
+        ++it;
+    }
+    return it == cache.end();
+}
+
+void testGetPut()
+{
+    int_cache cache(3);
+    assert(cache.empty() && cache.capacity() == 3 && "lru_cache() error");
+
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    assert(cache.size() == 3 && keysAre(cache, {3, 2, 1}) && "put error");
+
+    int* v = cache.get(1);
+    assert(v != nullptr && *v == 10 && keysAre(cache, {1, 3, 2}) && "get/promote error");
+    assert(cache.get(42) == nullptr && "get(missing) error");
+
+    // 2 is the least recently used
+    cache.put(4, 40);
+    assert(!cache.contains(2) && keysAre(cache, {4, 1, 3}) && "evict error");
+
+    cache.put(3, 33);
+    assert(*cache.peek(3) == 33 && keysAre(cache, {3, 4, 1}) && "put(replace) error");
+    assert(*cache.peek(1) == 10 && keysAre(cache, {3, 4, 1}) && "peek must not promote error");
+
+    assert(cache.erase(4) && !cache.erase(4) && keysAre(cache, {3, 1}) && "erase error");
+
+    const wstl::lru_cache_stats& st = cache.stats();
+    assert(st.hits == 1 && st.misses == 1 && st.insertions == 4 && st.evictions == 1 && "stats error");
+
+    cache.clear();
+    assert(cache.empty() && cache.total_cost() == 0 && !cache.contains(3) && "clear error");
+
+    // a moved-from cache is empty and still usable
+    cache.put(5, 50);
+    int_cache moved(wstl::move(cache));
+    assert(moved.size() == 1 && *moved.peek(5) == 50 && cache.empty() && "move error");
+    cache.put(6, 60);
+    assert(cache.size() == 1 && *cache.get(6) == 60 && !cache.contains(5) && "put after move error");
+
+    LOGI("test lru_cache get/put passed!");
+}
+
+void testCostAndCallback()
+{
+    wstl::lru_cache<std::string, std::string> cache(10);
+    std::string evicted;
+    cache.set_eviction_callback([&](const std::string& k, std::string& v) {
+        evicted += k + "=" + v + ";";
+    });
+
+    cache.put("a", "aaaa", 4);
+    cache.put("b", "bbbb", 4);
+    assert(cache.total_cost() == 8 && "cost error");
+
+    cache.put("c", "ccc", 3);
+    assert(evicted == "a=aaaa;" && cache.total_cost() == 7 && cache.size() == 2 && "evict by cost error");
+
+    assert(!cache.put("big", "x", 11) && !cache.contains("big") && "put(cost > capacity) error");
+
+    cache.set_capacity(3);
+    assert(evicted == "a=aaaa;b=bbbb;" && cache.size() == 1 && cache.contains("c") && "set_capacity error");
+
+    LOGI("test lru_cache cost/callback passed!");
+}
+
+// random operations against a plain list kept in recency order
+void testRandomAgainstList()
+{
+    const int capacity = 64;
+    int_cache cache(capacity);
+    wstl::list<int> model;
+    std::srand(3);
+    for(int step = 0; step < 200000; ++step) {
+        const int key = std::rand() % 200;
+        auto it = model.begin();
+        for(; it != model.end() && *it != key; ++it) {
+            ;
+        }
+        const bool present = it != model.end();
+        const int op = std::rand() % 4;
+        if(op == 0) {
+            assert(cache.erase(key) == present && "random erase error");
+            if(present) model.erase(it);
+        }
+        else if(op == 1) {
+            int* v = cache.get(key);
+            assert((v != nullptr) == present && (!present || *v == key * 7) && "random get error");
+            if(present) model.splice(model.begin(), model, it);
+        }
+        else {
+            cache.put(key, key * 7);
+            if(present) {
+                model.splice(model.begin(), model, it);
+            }
+            else {
+                model.push_front(key);
+                if(model.size() > static_cast<size_t>(capacity)) model.pop_back();
+            }
+        }
+    }
+    assert(cache.size() == model.size() && "random size error");
+    auto m = model.begin();
+    for(auto c = cache.begin(); c != cache.end(); ++c, ++m) {
+        assert(c->key == *m && "random order error");
+    }
+
+    LOGI("test lru_cache random operations passed!");
+}
+
+int main()
+{
+    testGetPut();
+    testCostAndCallback();
+    testRandomAgainstList();
+    return 0;
+}
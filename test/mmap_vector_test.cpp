@@ -0,0 +1,208 @@
+#include "wmmap_vector.hpp"
+#include "wspan.hpp"
+#include "test_common.hpp"
+
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct feature
+{
+    int     id;
+    float   weight;
+};
+
+static std::string temp_path(const char* name)
+{
+    return std::string("/tmp/wstl_") + name + "_" + std::to_string(::getpid());
+}
+
+static size_t file_size(const std::string& path)
+{
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+}
+
+void testWriteReopen()
+{
+    const std::string path = temp_path("mmap_vector");
+    {
+        wstl::mmap_vector<feature> v(path.c_str(), wstl::mmap_mode::truncate);
+        assert(v.is_open() && v.writable() && v.empty() && v.data() == nullptr && "open error");
+        for(int i = 0; i < 5000; ++i) {
+            v.push_back(feature{i, i * 0.5f});
+        }
+        assert(v.size() == 5000 && v.capacity() >= 5000 && v.back().id == 4999 && "push_back error");
+        assert(file_size(path) == v.capacity() * sizeof(feature) && "file grows with capacity error");
+        v.pop_back();
+        v.sync();
+        assert(v.advise(wstl::mmap_advice::sequential) && v.advise(wstl::mmap_advice::willneed) &&
+               "advise error");
+        v.advise(wstl::mmap_advice::hugepage);  // may be declined
+    }
+    assert(file_size(path) == 4999 * sizeof(feature) && "close trims file error");
+
+    {
+        wstl::mmap_vector<feature> v(path.c_str(), wstl::mmap_mode::read_only);
+        assert(!v.writable() && v.size() == 4999 && "reopen error");
+        size_t sum = 0;
+        for(const feature& f : v) {
+            sum += static_cast<size_t>(f.id);
+        }
+        assert(sum == 4998u * 4999u / 2 && v[100].weight == 50.0f && "reopen content error");
+
+        wstl::span<const feature> view(v);
+        assert(view.size() == 4999 && view.data() == v.data() && "span over mapping error");
+
+        bool thrown = false;
+        try
+        {
+            v.push_back(feature{0, 0});
+        }
+        catch(const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        assert(thrown && v.size() == 4999 && "read only grow error");
+    }
+
+    {
+        wstl::mmap_vector<feature> v(path.c_str());
+        feature extra[3] = {{-1, 1}, {-2, 2}, {-3, 3}};
+        v.append(extra, 3);
+        assert(v.size() == 5002 && v[5001].id == -3 && v[0].id == 0 && "append error");
+        v.resize(10);
+        v.shrink_to_fit();
+        assert(v.size() == 10 && v.capacity() < 5002 && v[9].id == 9 && "shrink_to_fit error");
+        v.resize(12);
+        assert(v[10].id == 0 && v[11].weight == 0.0f && "resize zero error");
+        v.resize(14, feature{7, 7});
+        assert(v.size() == 14 && v.back().id == 7 && "resize value error");
+    }
+    assert(file_size(path) == 14 * sizeof(feature) && "file size after reopen error");
+
+    ::unlink(path.c_str());
+    LOGI("test mmap_vector write/reopen passed!");
+}
+
+struct record
+{
+    long    id;
+    double  x;
+    double  y;
+};
+
+void testSyncLength()
+{
+    const std::string path = temp_path("mmap_vector_sync");
+    wstl::mmap_vector<record> v(path.c_str(), wstl::mmap_mode::truncate);
+    for(long i = 0; i < 10; ++i) {
+        v.push_back(record{i, 1.0, 2.0});
+    }
+    assert(file_size(path) > 10 * sizeof(record) && "file at capacity before sync error");
+    v.sync();
+    assert(file_size(path) == 10 * sizeof(record) && v.capacity() == 10 && "sync trims file error");
+    {
+        // what a reader sees if the writer dies right now
+        wstl::mmap_vector<record> r(path.c_str(), wstl::mmap_mode::read_only);
+        assert(r.size() == 10 && r.back().id == 9 && "reopen after sync error");
+    }
+
+    for(long i = 10; i < 1000; ++i) {
+        v.push_back(record{i, 1.0, 2.0});
+    }
+    v.sync(true);
+    assert(file_size(path) == 1000 * sizeof(record) && v[999].id == 999 && v[10].id == 10 &&
+           "grow after sync error");
+    v.close();
+    assert(file_size(path) == 1000 * sizeof(record) && "close after sync error");
+    ::unlink(path.c_str());
+
+    LOGI("test mmap_vector sync length passed!");
+}
+
+void testSelfReference()
+{
+    const std::string path = temp_path("mmap_vector_self");
+    wstl::mmap_vector<record> v(path.c_str(), wstl::mmap_mode::truncate);
+    v.push_back(record{7, 1.0, 2.0});
+    for(int i = 0; i < 2000; ++i) {
+        v.push_back(v[0]);
+    }
+    assert(v.size() == 2001 && v.back().id == 7 && "push_back own element error");
+
+    v.append(v.data(), v.size());
+    assert(v.size() == 4002 && v[4001].id == 7 && "append own elements error");
+
+    v[0].id = 9;
+    v.resize(20000, v[0]);
+    assert(v.size() == 20000 && v.back().id == 9 && "resize with own element error");
+    v.close();
+    ::unlink(path.c_str());
+
+    LOGI("test mmap_vector self reference passed!");
+}
+
+void testErrors()
+{
+    const std::string path = temp_path("mmap_vector_bad");
+    bool thrown = false;
+    try
+    {
+        wstl::mmap_vector<int> v(path.c_str(), wstl::mmap_mode::read_only);
+    }
+    catch(const std::system_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "open missing file error");
+
+    {
+        wstl::mmap_vector<char> bytes(path.c_str(), wstl::mmap_mode::truncate);
+        bytes.push_back('a');
+        bytes.push_back('b');
+        bytes.push_back('c');
+    }
+    thrown = false;
+    try
+    {
+        wstl::mmap_vector<int> v(path.c_str());
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "file size multiple error");
+    ::unlink(path.c_str());
+
+    LOGI("test mmap_vector errors passed!");
+}
+
+void testMove()
+{
+    const std::string path = temp_path("mmap_vector_move");
+    wstl::mmap_vector<int> a(path.c_str(), wstl::mmap_mode::truncate);
+    a.push_back(1);
+    a.push_back(2);
+    wstl::mmap_vector<int> b(wstl::move(a));
+    assert(!a.is_open() && a.empty() && b.size() == 2 && b[1] == 2 && "move error");
+
+    wstl::mmap_vector<int> c;
+    wstl::swap(b, c);
+    assert(!b.is_open() && c.size() == 2 && "swap error");
+    c.close();
+    assert(!c.is_open() && file_size(path) == 2 * sizeof(int) && "close error");
+    ::unlink(path.c_str());
+
+    LOGI("test mmap_vector move passed!");
+}
+
+int main()
+{
+    testWriteReopen();
+    testSyncLength();
+    testSelfReference();
+    testErrors();
+    testMove();
+    return 0;
+}
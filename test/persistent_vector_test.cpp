@@ -0,0 +1,143 @@
+#include "wpersistent_vector.hpp"
+#include "test_common.hpp"
+
+#include <string>
+
+static int live = 0;
+
+struct counted
+{
+    int value;
+
+    counted(int v = 0) : value(v) { ++live; }
+    counted(const counted& rhs) : value(rhs.value) { ++live; }
+    counted& operator=(const counted& rhs) { value = rhs.value; return *this; }
+    ~counted() { --live; }
+};
+
+void testPushPop()
+{
+    wstl::persistent_vector<int> empty;
+    assert(empty.empty() && empty.begin() == empty.end() && "persistent_vector() error");
+
+    // cross the tail, one full root and the growth of two levels
+    const int n = 40000;
+    wstl::persistent_vector<int> v;
+    for(int i = 0; i < n; ++i) {
+        v = v.push_back(i);
+    }
+    assert(v.size() == static_cast<size_t>(n) && v.front() == 0 && v.back() == n - 1 && "push_back error");
+    for(int i = 0; i < n; ++i) {
+        assert(v[i] == i && "index error");
+    }
+    long long sum = 0;
+    for(int x : v) {
+        sum += x;
+    }
+    assert(sum == static_cast<long long>(n) * (n - 1) / 2 && "iterate error");
+    assert(*(v.end() - 1) == n - 1 && v.end() - v.begin() == n && *v.rbegin() == n - 1 && "iterator error");
+
+    wstl::persistent_vector<int> w = v;
+    for(int i = n - 1; i >= 0; --i) {
+        assert(w.back() == i && "pop_back back error");
+        w = w.pop_back();
+    }
+    assert(w.empty() && v.size() == static_cast<size_t>(n) && v[1057] == 1057 && "pop_back error");
+
+    LOGI("test persistent_vector push/pop passed!");
+}
+
+void testVersions()
+{
+    wstl::persistent_vector<std::string> v0 = {"a", "b", "c"};
+    wstl::persistent_vector<std::string> v1 = v0.push_back("d");
+    wstl::persistent_vector<std::string> v2 = v1.set(0, "z");
+    wstl::persistent_vector<std::string> v3 = v2.pop_back();
+    assert(v0.size() == 3 && v0[0] == "a" && "version 0 error");
+    assert(v1.size() == 4 && v1[0] == "a" && v1[3] == "d" && "version 1 error");
+    assert(v2.size() == 4 && v2[0] == "z" && v2[3] == "d" && "version 2 error");
+    assert(v3.size() == 3 && v3[0] == "z" && v3[2] == "c" && "version 3 error");
+
+    wstl::persistent_vector<int> big;
+    {
+        wstl::transient_vector<int> t;
+        for(int i = 0; i < 5000; ++i) {
+            t.push_back(i);
+        }
+        big = t.persistent();
+    }
+    wstl::persistent_vector<int> changed = big.set(1234, -1);
+    assert(big[1234] == 1234 && changed[1234] == -1 && changed[1235] == 1235 && "set error");
+    assert(big != changed && big == big.set(1234, 1234) && "equality error");
+    wstl::persistent_vector<int> copy = big;
+    assert(copy.shares_with(big) && !changed.shares_with(big) && "shares_with error");
+
+    bool thrown = false;
+    try
+    {
+        big.at(5000);
+    }
+    catch(const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "at error");
+
+    LOGI("test persistent_vector versions passed!");
+}
+
+void testTransient()
+{
+    wstl::persistent_vector<int> base = {1, 2, 3};
+    wstl::transient_vector<int> t = base.transient();
+    for(int i = 4; i <= 2000; ++i) {
+        t.push_back(i);
+    }
+    t.set(0, 100);
+    t.pop_back();
+    assert(base.size() == 3 && base[0] == 1 && "transient leaves source error");
+
+    wstl::persistent_vector<int> done = t.persistent();
+    assert(done.size() == 1999 && done[0] == 100 && done.back() == 1999 && "persistent() error");
+
+    // edits after persistent() copy instead of writing into the handed out version
+    t.set(1, -5);
+    t.push_back(7);
+    assert(done[1] == 2 && done.size() == 1999 && t[1] == -5 && t.back() == 7 && "transient reuse error");
+
+    wstl::persistent_vector<int> from_range(base.begin(), base.end());
+    assert(from_range == base && "range construct error");
+
+    LOGI("test transient_vector passed!");
+}
+
+void testLifetime()
+{
+    {
+        wstl::persistent_vector<counted> a;
+        for(int i = 0; i < 3000; ++i) {
+            a = a.push_back(counted(i));
+        }
+        wstl::persistent_vector<counted> b = a.set(10, counted(-1)).pop_back();
+        wstl::transient_vector<counted> t = b.transient();
+        for(int i = 0; i < 100; ++i) {
+            t.pop_back();
+        }
+        t.set(5, counted(5));
+        wstl::persistent_vector<counted> c = t.persistent();
+        assert(a.size() == 3000 && b.size() == 2999 && c.size() == 2899 && "lifetime sizes error");
+        assert(a[10].value == 10 && b[10].value == -1 && c[10].value == -1 && "lifetime values error");
+    }
+    assert(0 == live && "persistent_vector leaks or double destroys elements");
+
+    LOGI("test persistent_vector lifetime passed!");
+}
+
+int main()
+{
+    testPushPop();
+    testVersions();
+    testTransient();
+    testLifetime();
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "wrank_select.hpp"
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+// every rank and select answer against a plain scan
+static void checkAgainstScan(const wstl::vector<bool>& bits)
+{
+    wstl::rank_select rs(bits);
+    assert(rs.size() == bits.size() && "size error");
+
+    std::vector<size_t> ones, zeros;
+    size_t r = 0;
+    for(size_t i = 0; i < bits.size(); ++i) {
+        assert(rs.rank1(i) == r && rs.rank0(i) == i - r && rs.test(i) == bits[i] && "rank error");
+        if(bits[i]) {
+            ones.push_back(i);
+            ++r;
+        }
+        else {
+            zeros.push_back(i);
+        }
+    }
+    assert(rs.rank1(bits.size()) == r && rs.ones() == ones.size() && rs.zeros() == zeros.size() && "rank(size) error");
+    for(size_t k = 0; k < ones.size(); ++k) {
+        assert(rs.select1(k) == ones[k] && "select1 error");
+    }
+    for(size_t k = 0; k < zeros.size(); ++k) {
+        assert(rs.select0(k) == zeros[k] && "select0 error");
+    }
+}
+
+static wstl::vector<bool> randomBits(size_t n, int percent)
+{
+    wstl::vector<bool> bits(n);
+    for(size_t i = 0; i < n; ++i) {
+        bits[i] = std::rand() % 100 < percent;
+    }
+    return bits;
+}
+
+void testEdges()
+{
+    wstl::rank_select empty;
+    assert(empty.size() == 0 && empty.rank1(0) == 0 && "rank_select() error");
+
+    const size_t sizes[] = {1, 63, 64, 65, 511, 512, 513, 4096, 4097};
+    for(size_t n : sizes) {
+        checkAgainstScan(wstl::vector<bool>(n, true));
+        checkAgainstScan(wstl::vector<bool>(n, false));
+        checkAgainstScan(randomBits(n, 50));
+    }
+
+    // bits past [bits] in the last word are ignored
+    wstl::vector<uint64_t> words;
+    words.push_back(~uint64_t(0));
+    words.push_back(~uint64_t(0));
+    wstl::rank_select rs(wstl::move(words), 70);
+    assert(rs.ones() == 70 && rs.rank1(70) == 70 && rs.select1(69) == 69 && "word constructor error");
+
+    LOGI("test rank_select edges passed!");
+}
+
+void testRandom()
+{
+    std::srand(5);
+    const int percents[] = {1, 10, 50, 90, 99};
+    for(int p : percents) {
+        checkAgainstScan(randomBits(200000 + static_cast<size_t>(std::rand() % 1000), p));
+    }
+
+    // long runs, so select has to search across many blocks between samples
+    wstl::vector<bool> runs(300000);
+    for(size_t i = 0; i < runs.size(); ++i) {
+        runs[i] = (i / 40000) % 2 == 1 || i % 7919 == 0;
+    }
+    checkAgainstScan(runs);
+
+    LOGI("test rank_select random passed!");
+}
+
+int main()
+{
+    testEdges();
+    testRandom();
+    return 0;
+}
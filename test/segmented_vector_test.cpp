@@ -0,0 +1,113 @@
+#include "wsegmented_vector.hpp"
+#include "test_common.hpp"
+
+#include <string>
+#include <vector>
+
+void testStableGrowth()
+{
+    wstl::segmented_vector<int> v;
+    assert(v.empty() && v.capacity() == 0 && v.begin() == v.end() && "segmented_vector() error");
+
+    std::vector<int*> addresses;
+    for(int i = 0; i < 100000; ++i) {
+        v.push_back(i);
+        addresses.push_back(&v.back());
+    }
+    assert(v.size() == 100000 && v.front() == 0 && v.back() == 99999 && "push_back error");
+    for(int i = 0; i < 100000; ++i) {
+        assert(v[i] == i && &v[i] == addresses[i] && "index/stability error");
+    }
+
+    // segments double: 16, 32, 64, ...
+    const size_t first = wstl::segmented_vector<int>::first_segment_size;
+    assert(v.segment(0).size() == first && v.segment(1).size() == 2 * first &&
+           v.segment(1).data() == &v[first] && "segment error");
+    size_t total = 0;
+    for(size_t k = 0; k < v.segment_count(); ++k) {
+        total += v.segment(k).size();
+    }
+    assert(total == v.size() && "segment_count error");
+
+    bool thrown = false;
+    try
+    {
+        v.at(100000);
+    }
+    catch(const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "at() error");
+
+    LOGI("test segmented_vector stable growth passed!");
+}
+
+void testIterators()
+{
+    wstl::segmented_vector<int, 2> v;
+    for(int i = 0; i < 60; ++i) {
+        v.push_back(i);
+    }
+    int expect = 0;
+    for(auto it = v.begin(); it != v.end(); ++it) {
+        assert(*it == expect++ && "iterator ++ error");
+    }
+    assert(expect == 60 && v.end() - v.begin() == 60 && "iterator distance error");
+    expect = 59;
+    for(auto it = v.rbegin(); it != v.rend(); ++it) {
+        assert(*it == expect-- && "reverse iterator error");
+    }
+    auto it = v.begin();
+    it += 37;
+    assert(*it == 37 && it[-30] == 7 && *(it - 37) == 0 && (v.end() - 1)[0] == 59 && "iterator jump error");
+    wstl::segmented_vector<int, 2>::const_iterator cit = it;
+    assert(cit.index() == 37 && cit < v.cend() && "const_iterator error");
+
+    // size exactly fills the segments: end() sits on an unallocated segment
+    wstl::segmented_vector<int, 2> full;
+    for(int i = 0; i < 12; ++i) {
+        full.push_back(i);
+    }
+    assert(full.capacity() == 12 && full.end() - full.begin() == 12 && *(full.end() - 1) == 11 && "end() error");
+    auto last = full.begin() + 11;
+    ++last;
+    assert(last == full.end() && "++ to end() error");
+
+    LOGI("test segmented_vector iterators passed!");
+}
+
+void testResizeCopyMove()
+{
+    wstl::segmented_vector<std::string> v(5, "x");
+    v.resize(40, "y");
+    assert(v.size() == 40 && v[4] == "x" && v[39] == "y" && "resize error");
+    v.resize(3);
+    assert(v.size() == 3 && v.capacity() >= 40 && "resize(shrink) error");
+    v.shrink_to_fit();
+    assert(v.capacity() == 16 && "shrink_to_fit error");
+
+    wstl::segmented_vector<std::string> c(v);
+    assert(c == v && "copy error");
+    const std::string* p = &v[1];
+    wstl::segmented_vector<std::string> m(wstl::move(v));
+    assert(v.empty() && &m[1] == p && "move keeps addresses error");
+    m.pop_back();
+    assert(m != c && m.size() == 2 && "pop_back error");
+
+    v = {"a", "b"};
+    wstl::swap(v, m);
+    assert(m.size() == 2 && m[1] == "b" && v[0] == "x" && "swap error");
+    m.clear();
+    assert(m.empty() && "clear error");
+
+    LOGI("test segmented_vector resize/copy/move passed!");
+}
+
+int main()
+{
+    testStableGrowth();
+    testIterators();
+    testResizeCopyMove();
+    return 0;
+}
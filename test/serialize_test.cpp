@@ -0,0 +1,217 @@
+#include "wserialize.hpp"
+#include "test_common.hpp"
+
+#include <sstream>
+#include <string>
+
+struct sample
+{
+    int     id;
+    double  value;
+
+    bool operator==(const sample& rhs) const {
+        return id == rhs.id && value == rhs.value;
+    }
+    bool operator!=(const sample& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+template <class C>
+static C round_trip(const C& c, size_t* bytes = nullptr)
+{
+    std::stringstream ss;
+    wstl::serialize(ss, c);
+    if(bytes) {
+        *bytes = ss.str().size();
+    }
+    C out;
+    wstl::deserialize(ss, out);
+    return out;
+}
+
+void testVector()
+{
+    wstl::vector<sample> v;
+    for(int i = 0; i < 1000; ++i) {
+        v.push_back(sample{i, i * 0.25});
+    }
+    size_t bytes = 0;
+    wstl::vector<sample> out = round_trip(v, &bytes);
+    assert(bytes == sizeof(uint64_t) + v.size() * sizeof(sample) && "vector layout error");
+    assert(out.size() == v.size() && out == v && "vector round trip error");
+
+    assert(round_trip(wstl::vector<int>()).empty() && "empty vector error");
+
+    wstl::vector<std::string> words = {"alpha", "", "gamma"};
+    wstl::vector<std::string> words_out = round_trip(words);
+    assert(words_out.size() == 3 && words_out[0] == "alpha" && words_out[1].empty() &&
+           words_out[2] == "gamma" && "vector<string> error");
+
+    wstl::vector<wstl::vector<int>> nested = {{1, 2}, {}, {3}};
+    wstl::vector<wstl::vector<int>> nested_out = round_trip(nested);
+    assert(nested_out.size() == 3 && nested_out[0][1] == 2 && nested_out[1].empty() &&
+           nested_out[2][0] == 3 && "nested vector error");
+
+    wstl::vector<bool> bits(70);
+    bits.set(0);
+    bits.set(65);
+    bits.set(69);
+    wstl::vector<bool> bits_out = round_trip(bits, &bytes);
+    assert(bytes == sizeof(uint64_t) + 2 * sizeof(wstl::bit_word) && "vector<bool> layout error");
+    assert(bits_out == bits && bits_out.count() == 3 && "vector<bool> round trip error");
+
+    LOGI("test serialize vector passed!");
+}
+
+void testResizeForOverwrite()
+{
+    wstl::vector<int> v = {1, 2, 3};
+    v.resize_for_overwrite(2);
+    assert(v.size() == 2 && v[1] == 2 && "resize_for_overwrite shrink error");
+    v.resize_for_overwrite(100);
+    assert(v.size() == 100 && v.capacity() >= 100 && v[0] == 1 && "resize_for_overwrite grow error");
+
+    wstl::vector<std::string> s = {"a"};
+    s.resize_for_overwrite(5);
+    assert(s.size() == 5 && s[0] == "a" && s[4].empty() && "resize_for_overwrite string error");
+
+    LOGI("test vector resize_for_overwrite passed!");
+}
+
+void testDequeList()
+{
+    wstl::deque<int, 8> d;
+    for(int i = 0; i < 100; ++i) {
+        d.push_back(i);
+    }
+    d.push_front(-1);
+    wstl::deque<int, 8> d_out = round_trip(d);
+    assert(d_out.size() == 101 && d_out.front() == -1 && d_out.back() == 99 && d_out == d &&
+           "deque round trip error");
+
+    wstl::deque<std::string> ds = {"x", "yy"};
+    assert(round_trip(ds) == ds && "deque<string> error");
+
+    wstl::list<sample> l;
+    l.push_back(sample{1, 1.5});
+    l.push_back(sample{2, 2.5});
+    wstl::list<sample> l_out = round_trip(l);
+    assert(l_out.size() == 2 && l_out.front() == l.front() && l_out.back() == l.back() &&
+           "list round trip error");
+
+    LOGI("test serialize deque/list passed!");
+}
+
+void testAdapters()
+{
+    wstl::queue<int> q;
+    q.push(1);
+    q.push(2);
+    q.push(3);
+    wstl::queue<int> q_out;
+    q_out.push(42);
+    std::stringstream ss;
+    wstl::serialize(ss, q);
+    wstl::deserialize(ss, q_out);
+    assert(q_out.size() == 3 && q_out.front() == 1 && q_out.back() == 3 && "queue round trip error");
+
+    wstl::stack<int> s;
+    s.push(5);
+    s.push(6);
+    wstl::stack<int> s_out = round_trip(s);
+    assert(s_out.size() == 2 && s_out.top() == 6 && "stack round trip error");
+
+    wstl::priority_queue<int> pq = {3, 9, 1, 7};
+    wstl::priority_queue<int> pq_out = round_trip(pq);
+    assert(pq_out.size() == 4 && pq_out.top() == 9 && "priority_queue round trip error");
+    pq_out.pop();
+    assert(pq_out.top() == 7 && "priority_queue heap error");
+
+    LOGI("test serialize adapters passed!");
+}
+
+void testTruncated()
+{
+    wstl::vector<int> v = {1, 2, 3, 4};
+    std::stringstream ss;
+    wstl::serialize(ss, v);
+    std::string bytes = ss.str();
+    std::stringstream cut(bytes.substr(0, bytes.size() - 2));
+
+    bool thrown = false;
+    try
+    {
+        wstl::vector<int> out;
+        wstl::deserialize(cut, out);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "truncated input error");
+
+    LOGI("test serialize truncated input passed!");
+}
+
+template <class C>
+static bool rejects_count(uint64_t count)
+{
+    std::stringstream ss;
+    ss.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    try
+    {
+        C out;
+        wstl::deserialize(ss, out);
+    }
+    catch(const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void testBogusCount()
+{
+    // a count the input cannot back fails on the short read, not in the allocator
+    const uint64_t huge = uint64_t(1) << 40;
+    assert(rejects_count<wstl::vector<int>>(huge) && "vector bogus count error");
+    assert(rejects_count<wstl::vector<std::string>>(huge) && "vector<string> bogus count error");
+    assert(rejects_count<wstl::deque<int>>(huge) && "deque bogus count error");
+    assert(rejects_count<wstl::vector<bool>>(huge) && "vector<bool> bogus count error");
+    assert(rejects_count<std::string>(huge) && "string bogus count error");
+    assert(rejects_count<wstl::vector<int>>(~uint64_t(0)) && "count past max_size error");
+
+    // inputs larger than one read step still round trip
+    wstl::vector<int> big(3 * SERIALIZE_READ_CHUNK / sizeof(int) + 7);
+    wstl::deque<int> big_dq;
+    for(size_t i = 0; i < big.size(); ++i) {
+        big[i] = static_cast<int>(i);
+        big_dq.push_back(static_cast<int>(i));
+    }
+    wstl::vector<int> big_out = round_trip(big);
+    assert(big_out == big && big_out.capacity() == big.size() && "multi step vector error");
+    wstl::deque<int> big_dq_out = round_trip(big_dq);
+    assert(big_dq_out.size() == big_dq.size() && big_dq_out.back() == big_dq.back() &&
+           big_dq_out[SERIALIZE_READ_CHUNK / sizeof(int)] == static_cast<int>(SERIALIZE_READ_CHUNK / sizeof(int)) &&
+           "multi step deque error");
+    wstl::vector<bool> big_bits(8 * SERIALIZE_READ_CHUNK + 130);
+    big_bits.set(8 * SERIALIZE_READ_CHUNK + 129);
+    big_bits.set(64);
+    wstl::vector<bool> big_bits_out = round_trip(big_bits);
+    assert(big_bits_out.size() == big_bits.size() && big_bits_out[8 * SERIALIZE_READ_CHUNK + 129] &&
+           big_bits_out[64] && !big_bits_out[65] && "multi step vector<bool> error");
+
+    LOGI("test serialize bogus count passed!");
+}
+
+int main()
+{
+    testVector();
+    testResizeForOverwrite();
+    testDequeList();
+    testAdapters();
+    testTruncated();
+    testBogusCount();
+    return 0;
+}
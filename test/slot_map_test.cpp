@@ -0,0 +1,113 @@
+#include "wslot_map.hpp"
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+void testInsertErase()
+{
+    wstl::slot_map<std::string> sm;
+    assert(sm.empty() && "slot_map() error");
+
+    auto a = sm.insert(std::string("a"));
+    auto b = sm.emplace(3, 'b');
+    auto c = sm.insert(std::string("c"));
+    assert(sm.size() == 3 && sm[a] == "a" && sm[b] == "bbb" && *sm.find(c) == "c" && "insert error");
+
+    // erasing the first object moves the last one into its place, keys still work
+    assert(sm.erase(a) && !sm.erase(a) && "erase error");
+    assert(sm.size() == 2 && !sm.contains(a) && sm.find(a) == nullptr && "erase(stale) error");
+    assert(*sm.begin() == "c" && sm[c] == "c" && sm[b] == "bbb" && "swap-and-pop error");
+
+    // the slot of [a] is reused with a new generation
+    auto d = sm.insert(std::string("d"));
+    assert(d.index == a.index && d != a && !sm.contains(a) && sm.at(d) == "d" && "slot reuse error");
+
+    bool thrown = false;
+    try
+    {
+        sm.at(a);
+    }
+    catch(const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "at(stale) error");
+
+    // erase while scanning
+    for(auto it = sm.begin(); it != sm.end(); ) {
+        if(*it == "bbb") {
+            assert(sm.key_of(it) == b && "key_of error");
+            it = sm.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    assert(sm.size() == 2 && !sm.contains(b) && sm[c] == "c" && sm[d] == "d" && "erase(iterator) error");
+
+    sm.clear();
+    assert(sm.empty() && !sm.contains(c) && !sm.contains(d) && "clear error");
+    auto e = sm.insert(std::string("e"));
+    assert(sm.size() == 1 && sm[e] == "e" && (e.index == c.index || e.index == d.index) && "insert after clear error");
+
+    // a free slot already holds the generation its next key gets, a matching
+    // key from elsewhere must still miss
+    wstl::slot_map<int> x, y;
+    x.erase(x.insert(1));
+    y.erase(y.insert(1));
+    auto foreign = y.insert(2);
+    assert(!x.contains(foreign) && x.find(foreign) == nullptr && !x.erase(foreign) && x.empty() &&
+           "foreign key on free slot error");
+    assert(!x.contains(wstl::slot_map_key{0, 0}) && !y.contains(wstl::slot_map_key{0, 0}) && "zero key error");
+
+    LOGI("test slot_map insert/erase passed!");
+}
+
+// random operations against a model of (key, value) pairs
+void testRandom()
+{
+    wstl::slot_map<int> sm;
+    std::vector<wstl::slot_map_key> live;
+    std::vector<int> values;
+    std::vector<wstl::slot_map_key> dead;
+    std::srand(7);
+    for(int step = 0; step < 100000; ++step) {
+        const int op = std::rand() % 3;
+        if(op != 0 || live.empty()) {
+            const int v = std::rand();
+            live.push_back(sm.insert(v));
+            values.push_back(v);
+        }
+        else {
+            const size_t i = static_cast<size_t>(std::rand()) % live.size();
+            assert(sm.erase(live[i]) && "random erase error");
+            dead.push_back(live[i]);
+            live[i] = live.back();
+            values[i] = values.back();
+            live.pop_back();
+            values.pop_back();
+        }
+    }
+    assert(sm.size() == live.size() && "random size error");
+    for(size_t i = 0; i < live.size(); ++i) {
+        assert(sm.contains(live[i]) && sm[live[i]] == values[i] && "random lookup error");
+    }
+    for(size_t i = 0; i < dead.size(); ++i) {
+        assert(!sm.contains(dead[i]) && "random stale key error");
+    }
+    long long sum = 0, expect = 0;
+    for(int v : sm) sum += v;
+    for(int v : values) expect += v;
+    assert(sum == expect && "random dense scan error");
+
+    LOGI("test slot_map random operations passed!");
+}
+
+int main()
+{
+    testInsertErase();
+    testRandom();
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "wsoa_vector.hpp"
+#include "test_common.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+typedef wstl::soa_vector<float, float, int, std::string> particles;
+
+void testPushAndColumns()
+{
+    particles ps;
+    assert(ps.empty() && ps.capacity() == 0 && particles::column_count == 4 && "soa_vector() error");
+
+    for(int i = 0; i < 100; ++i) {
+        ps.push_back(std::make_tuple(static_cast<float>(i), 0.5f * i, i * 2, std::to_string(i)));
+    }
+    ps.emplace_back(100.0f, 50.0f, 200, "100");
+    assert(ps.size() == 101 && ps.capacity() >= 101 && "push_back error");
+
+    // every column is contiguous and aligned
+    auto xs = ps.column<0>();
+    auto ids = ps.column<2>();
+    assert(xs.size() == 101 && ids.size() == 101 && "column size error");
+    assert(reinterpret_cast<uintptr_t>(xs.data()) % SOA_VECTOR_ALIGN == 0 &&
+           reinterpret_cast<uintptr_t>(ps.data<3>()) % SOA_VECTOR_ALIGN == 0 && "column align error");
+    float sum = 0;
+    for(float x : xs) sum += x;
+    assert(sum == 5050.0f && ids[100] == 200 && ps.get<3>(42) == "42" && "column data error");
+
+    // row proxies write through to the columns
+    auto row = ps[7];
+    std::get<1>(row) = -1.0f;
+    assert(ps.get<1>(7) == -1.0f && "row proxy error");
+    ps[8] = std::make_tuple(1.0f, 2.0f, 3, std::string("eight"));
+    assert(ps.get<0>(8) == 1.0f && ps.get<2>(8) == 3 && ps.get<3>(8) == "eight" && "row assign error");
+    assert(std::get<3>(ps.back()) == "100" && std::get<2>(ps.front()) == 0 && "front/back error");
+
+    ps.erase(0);
+    assert(ps.size() == 100 && ps.get<2>(0) == 2 && ps.get<3>(99) == "100" && "erase error");
+    ps.pop_back();
+    assert(ps.size() == 99 && ps.get<3>(98) == "99" && "pop_back error");
+
+    bool thrown = false;
+    try
+    {
+        ps.at(99);
+    }
+    catch(const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "at() error");
+
+    LOGI("test soa_vector push/columns passed!");
+}
+
+void testCopyMoveResize()
+{
+    particles a;
+    for(int i = 0; i < 40; ++i) {
+        a.emplace_back(1.0f * i, 2.0f * i, i, std::string(30, static_cast<char>('a' + i % 26)));
+    }
+    particles b(a);
+    assert(b.size() == 40 && b.get<3>(3) == a.get<3>(3) && b.data<0>() != a.data<0>() && "copy error");
+
+    particles c(wstl::move(a));
+    assert(a.empty() && c.size() == 40 && c.get<2>(39) == 39 && "move error");
+
+    c.resize(10);
+    assert(c.size() == 10 && c.get<2>(9) == 9 && "resize(shrink) error");
+    c.resize(20);
+    assert(c.size() == 20 && c.get<2>(19) == 0 && c.get<3>(19).empty() && "resize(grow) error");
+    c.shrink_to_fit();
+    assert(c.capacity() == 20 && c.get<3>(5) == b.get<3>(5) && "shrink_to_fit error");
+
+    b = c;
+    assert(b.size() == 20 && b.get<3>(19).empty() && "operator= error");
+    wstl::swap(b, c);
+    c.clear();
+    assert(c.empty() && b.size() == 20 && "clear/swap error");
+
+    LOGI("test soa_vector copy/move/resize passed!");
+}
+
+// copy throws on demand, and its move is not noexcept so growth copies it
+struct fragile
+{
+    static int copies_left;
+    int v;
+    fragile(int x) : v(x) {}
+    fragile(const fragile& rhs) : v(rhs.v) {
+        if(copies_left >= 0 && 0 == copies_left--) {
+            throw std::runtime_error("fragile copy");
+        }
+    }
+    fragile(fragile&& rhs) : v(rhs.v) {}
+};
+
+int fragile::copies_left = -1;
+
+void testGrowthRollback()
+{
+    wstl::soa_vector<std::string, fragile> v;
+    for(int i = 0; i < 16; ++i) {
+        v.emplace_back(std::string(40, static_cast<char>('a' + i)), i);
+    }
+    const size_t cap = v.capacity();
+    fragile::copies_left = 5;
+    bool thrown = false;
+    try
+    {
+        v.reserve(cap * 4);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    fragile::copies_left = -1;
+    assert(thrown && v.capacity() == cap && v.size() == 16 && "reserve rollback error");
+    assert(v.get<0>(0) == std::string(40, 'a') && v.get<0>(15) == std::string(40, 'p') &&
+           v.get<1>(15).v == 15 && "reserve rollback left columns moved from");
+
+    v.reserve(cap * 4);
+    assert(v.capacity() >= cap * 4 && v.get<0>(7) == std::string(40, 'h') && "reserve after rollback error");
+
+    // arguments that refer to a row survive the growth they trigger
+    wstl::soa_vector<std::string, int> self;
+    self.emplace_back(std::string(40, 's'), 1);
+    while (self.size() < self.capacity())
+    {
+        self.emplace_back(std::string("x"), 0);
+    }
+    self.emplace_back(self.get<0>(0), self.get<1>(0));
+    assert(self.get<0>(self.size() - 1) == std::string(40, 's') && self.get<1>(self.size() - 1) == 1 &&
+           "emplace_back own row error");
+
+    // a move-only column is still moved
+    wstl::soa_vector<int, std::unique_ptr<int>> owners;
+    for(int i = 0; i < 100; ++i) {
+        owners.emplace_back(i, std::unique_ptr<int>(new int(i)));
+    }
+    assert(*owners.get<1>(99) == 99 && "move-only column error");
+
+    LOGI("test soa_vector growth rollback passed!");
+}
+
+int main()
+{
+    testPushAndColumns();
+    testCopyMoveResize();
+    testGrowthRollback();
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "wspan.hpp"
+#include "wvector.hpp"
+#include "wstatic_vector.hpp"
+#include "wdeque.hpp"
+#include "test_common.hpp"
+
+#include <type_traits>
+
+static int sum(wstl::span<const int> s)
+{
+    int total = 0;
+    for(int v : s) {
+        total += v;
+    }
+    return total;
+}
+
+void testSpan()
+{
+    int arr[] = {1, 2, 3, 4, 5};
+    wstl::span<int> s(arr);
+    assert(s.size() == 5 && s.data() == arr && s.size_bytes() == sizeof(arr) && "span(arr) error");
+    assert(s.front() == 1 && s.back() == 5 && s[2] == 3 && "span visit error");
+    assert(*s.rbegin() == 5 && "span reverse error");
+
+    wstl::span<int, 5> fixed(arr);
+    static_assert(sizeof(fixed) == sizeof(int*), "static extent keeps only the pointer");
+    assert(fixed.extent == 5 && fixed.size() == 5 && "static span error");
+    wstl::span<const int> widened(fixed);
+    assert(widened.size() == 5 && sum(widened) == 15 && "span conversion error");
+
+    wstl::span<int> empty(arr, 0);
+    assert(empty.empty() && wstl::span<int>().empty() && "empty span error");
+
+    assert(sum(s.first(2)) == 3 && sum(s.last(2)) == 9 && "first/last error");
+    assert(sum(s.subspan(1, 3)) == 9 && sum(s.subspan(3)) == 9 && "subspan error");
+    wstl::span<int, 2> head = s.first<2>();
+    assert(head.size() == 2 && head[1] == 2 && s.last<1>()[0] == 5 && "static first/last error");
+
+    s[0] = 10;
+    assert(arr[0] == 10 && "span write through error");
+
+    auto bytes = wstl::as_bytes(s);
+    assert(bytes.size() == sizeof(arr) && bytes.data() == reinterpret_cast<const unsigned char*>(arr) &&
+           "as_bytes error");
+    wstl::as_writable_bytes(s)[0] = 0;
+    wstl::as_writable_bytes(s)[1] = 0;
+    wstl::as_writable_bytes(s)[2] = 0;
+    wstl::as_writable_bytes(s)[3] = 0;
+    assert(arr[0] == 0 && "as_writable_bytes error");
+
+    LOGI("test span passed!");
+}
+
+void testContainer()
+{
+    wstl::vector<int> v = {1, 2, 3};
+    assert(sum(v) == 6 && "span from vector error");
+    wstl::span<int> sv(v);
+    sv[1] = 20;
+    assert(v[1] == 20 && "vector span write error");
+
+    const wstl::vector<int>& cv = v;
+    wstl::span<const int> csv(cv);
+    assert(csv.data() == v.data() && csv.size() == 3 && "const vector span error");
+    static_assert(!std::is_constructible<wstl::span<int>, const wstl::vector<int>&>::value,
+                  "const vector must not give a mutable span");
+    static_assert(!std::is_constructible<wstl::span<bool>, wstl::vector<bool>&>::value,
+                  "vector<bool> has no contiguous bools");
+
+    wstl::static_vector<int, 8> st = {4, 5, 6};
+    assert(sum(st) == 15 && wstl::make_span(st).size() == 3 && "span from static_vector error");
+    assert(sum(wstl::make_span(v.data(), 2)) == 21 && "make_span error");
+
+    LOGI("test span from containers passed!");
+}
+
+void testSegmentedSpan()
+{
+    typedef wstl::deque<int, 4> deque_type;
+    deque_type dq;
+    assert(dq.segments().size() == 0 && dq.segments().chunk_count() == 0 &&
+           dq.segments().begin() == dq.segments().end() && "empty segments error");
+
+    for(int i = 0; i < 10; ++i) {
+        dq.push_back(i);
+    }
+    dq.push_front(-1);
+    dq.push_front(-2);
+
+    size_t total = 0;
+    size_t chunks = 0;
+    int expect = -2;
+    for(wstl::span<int> chunk : dq.segments()) {
+        assert(!chunk.empty() && chunk.size() <= deque_type::buffer_size && "chunk size error");
+        for(int& x : chunk) {
+            assert(x == expect && "chunk order error");
+            ++expect;
+            x *= 2;
+        }
+        total += chunk.size();
+        ++chunks;
+    }
+    assert(total == dq.size() && dq.segments().size() == dq.size() && "segments size error");
+    assert(chunks == dq.segments().chunk_count() && "chunk_count error");
+    assert(dq.front() == -4 && dq.back() == 18 && "segments write error");
+
+    // a deque ending exactly on a buffer edge has no trailing empty chunk
+    deque_type full;
+    for(int i = 0; i < 8; ++i) {
+        full.push_back(i);
+    }
+    const deque_type& cfull = full;
+    size_t edge_chunks = 0;
+    for(wstl::span<const int> chunk : cfull.segments()) {
+        assert(!chunk.empty() && "edge chunk error");
+        ++edge_chunks;
+    }
+    assert(edge_chunks == cfull.segments().chunk_count() && cfull.segments().size() == 8 &&
+           "edge segments error");
+
+    LOGI("test segmented_span passed!");
+}
+
+int main()
+{
+    testSpan();
+    testContainer();
+    testSegmentedSpan();
+    return 0;
+}
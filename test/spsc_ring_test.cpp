@@ -0,0 +1,161 @@
+#include "test_common.hpp"
+#include "wspsc_ring.hpp"
+#include "wvector.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+void testCapacity()
+{
+    wstl::spsc_ring<int> ring(5);
+    assert(ring.capacity() == 8 && ring.empty() && ring.size() == 0 && "spsc_ring(n) capacity error");
+
+    for(int i = 0; i < 8; ++i) {
+        assert(ring.push(i) && "spsc_ring push error");
+    }
+    assert(!ring.push(8) && ring.size() == 8 && "spsc_ring push on full error");
+
+    assert(ring.front() == 0 && "spsc_ring front error");
+    ring.pop();
+    assert(ring.size() == 7 && ring.front() == 1 && "spsc_ring pop error");
+    assert(ring.push(8) && "spsc_ring push after pop error");
+
+    int value = 0;
+    for(int i = 1; i <= 8; ++i) {
+        assert(ring.try_pop(value) && value == i && "spsc_ring try_pop error");
+    }
+    assert(!ring.try_pop(value) && ring.empty() && "spsc_ring try_pop on empty error");
+
+    LOGI("test spsc_ring capacity passed!");
+}
+
+void testBatch()
+{
+    wstl::spsc_ring<int> ring(8);
+    int arr[] = {1,2,3,4,5,6};
+    assert(ring.push_n(arr, 6) == 6 && ring.size() == 6 && "spsc_ring push_n error");
+
+    int out[8] = {0};
+    assert(ring.pop_n(out, 4) == 4 && out[0] == 1 && out[3] == 4 && "spsc_ring pop_n error");
+
+    // wraps around the end of the buffer
+    assert(ring.push_n(arr, 6) == 6 && ring.size() == 8 && "spsc_ring push_n wrap error");
+    assert(ring.push_n(arr, 1) == 0 && "spsc_ring push_n on full error");
+    assert(ring.pop_n(out, 8) == 8 && out[0] == 5 && out[1] == 6 && out[2] == 1 && out[7] == 6 && "spsc_ring pop_n wrap error");
+    assert(ring.empty() && "spsc_ring pop_n size error");
+
+    wstl::spsc_ring<std::string> str_ring(4);
+    str_ring.emplace(3, 'a');
+    str_ring.push(std::string("hello"));
+    assert(str_ring.front() == "aaa" && "spsc_ring emplace error");
+    std::string strs[2];
+    assert(str_ring.pop_n(strs, 2) == 2 && strs[1] == "hello" && "spsc_ring pop_n string error");
+
+    LOGI("test spsc_ring batch passed!");
+}
+
+// counts live objects, a copy throws once copies_left runs out
+struct tracked
+{
+    static int live;
+    static int copies_left;
+    int v;
+    tracked(int x = 0) : v(x) {
+        ++live;
+    }
+    tracked(const tracked& rhs) : v(rhs.v) {
+        if(copies_left >= 0 && 0 == copies_left--) {
+            throw std::runtime_error("tracked copy");
+        }
+        ++live;
+    }
+    tracked& operator=(const tracked& rhs) {
+        v = rhs.v;
+        return *this;
+    }
+    ~tracked() {
+        --live;
+    }
+};
+
+int tracked::live = 0;
+int tracked::copies_left = -1;
+
+void testBatchRollback()
+{
+    {
+        wstl::spsc_ring<tracked> ring(4);
+        tracked src[3] = {tracked(1), tracked(2), tracked(3)};
+        const int before = tracked::live;
+        assert(ring.push_n(src, 3) == 3 && "spsc_ring push_n error");
+        tracked out[3];
+        assert(ring.pop_n(out, 3) == 3 && "spsc_ring pop_n error");
+
+        // tail sits on the last slot: one element before the wrap, two after
+        tracked::copies_left = 2;
+        bool thrown = false;
+        try
+        {
+            ring.push_n(src, 3);
+        }
+        catch(const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        tracked::copies_left = -1;
+        assert(thrown && ring.empty() && tracked::live == before + 3 && "spsc_ring push_n rollback error");
+        assert(ring.push_n(src, 3) == 3 && ring.front().v == 1 && "spsc_ring push_n after rollback error");
+    }
+    assert(tracked::live == 0 && "spsc_ring leaked elements error");
+
+    LOGI("test spsc_ring batch rollback passed!");
+}
+
+void testThreads()
+{
+    const int count = 1000000;
+    wstl::spsc_ring<int> ring(1024);
+
+    std::thread producer([&ring, count]() {
+        int batch[64];
+        int next = 0;
+        while (next < count)
+        {
+            int n = 0;
+            for(; n < 64 && next + n < count; ++n) {
+                batch[n] = next + n;
+            }
+            const int pushed = static_cast<int>(ring.push_n(batch, n));
+            if(0 == pushed) std::this_thread::yield();
+            next += pushed;
+        }
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < count)
+    {
+        int value = 0;
+        if(ring.try_pop(value)) {
+            ordered = ordered && value == expected;
+            ++expected;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    assert(ordered && ring.empty() && "spsc_ring producer/consumer order error");
+
+    LOGI("test spsc_ring threads passed!");
+}
+
+int main()
+{
+    testCapacity();
+    testBatch();
+    testBatchRollback();
+    testThreads();
+    return 0;
+}
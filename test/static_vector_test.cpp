@@ -0,0 +1,131 @@
+#include "wstatic_vector.hpp"
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// every heap allocation in this program goes through here
+static size_t g_allocations = 0;
+
+void* operator new(size_t n)
+{
+    ++g_allocations;
+    void* p = std::malloc(n ? n : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+struct Quote
+{
+    int     id;
+    double  px;
+    Quote(int i, double p) : id(i), px(p) {}
+};
+
+void testNoAllocation()
+{
+    const size_t before = g_allocations;
+    {
+        wstl::static_vector<Quote, 64> book;
+        for(int i = 0; i < 64; ++i) {
+            book.emplace_back(i, i * 0.5);
+        }
+        book.erase(book.begin() + 10, book.begin() + 20);
+        book.insert(book.begin(), Quote(-1, 0.0));
+        wstl::static_vector<Quote, 64> copy(book);
+        copy.pop_back();
+        book.swap(copy);
+        assert(book.size() == 54 && copy.size() == 55 && book.front().id == -1 && "operations error");
+    }
+    assert(g_allocations == before && "static_vector allocated error");
+
+    LOGI("test static_vector no allocation passed!");
+}
+
+void testVectorApi()
+{
+    wstl::static_vector<std::string, 8> v = {"b", "d"};
+    v.insert(v.begin(), "a");
+    v.insert(v.begin() + 2, "c");
+    v.emplace(v.end(), 2, 'e');
+    assert(v.size() == 5 && v[0] == "a" && v[2] == "c" && v[3] == "d" && v.back() == "ee" && "insert/emplace error");
+
+    v.insert(v.begin() + 1, 2u, std::string("x"));
+    assert(v.size() == 7 && v[1] == "x" && v[2] == "x" && v[3] == "b" && "insert(n) error");
+    std::string more[] = {"y", "z"};
+    bool thrown = false;
+    try
+    {
+        v.insert(v.end(), 2u, std::string("full"));
+    }
+    catch(const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && v.size() == 7 && "insert past capacity error");
+    v.insert(v.begin(), more, more + 1);
+    assert(v.full() && v[0] == "y" && "insert(range) error");
+
+    thrown = false;
+    try
+    {
+        v.push_back("overflow");
+    }
+    catch(const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && v.size() == 8 && "push_back when full error");
+
+    v.erase(v.begin());
+    v.erase(v.begin() + 1, v.begin() + 3);
+    assert(v.size() == 5 && v[0] == "a" && v[1] == "b" && "erase error");
+
+    wstl::static_vector<std::string, 8> w(wstl::move(v));
+    assert(w.size() == 5 && w[4] == "ee" && "move error");
+    w.resize(7, "r");
+    assert(w.size() == 7 && w[6] == "r" && "resize error");
+    w.resize(2);
+    v = w;
+    assert(v == w && !(v < w) && v.size() == 2 && "assign/compare error");
+    v.assign(3, "q");
+    assert(v.size() == 3 && v[2] == "q" && v != w && "assign(n) error");
+    wstl::swap(v, w);
+    assert(v.size() == 2 && w.size() == 3 && "swap error");
+    v.clear();
+    assert(v.empty() && "clear error");
+
+    // a range that does not fit leaves the vector untouched
+    wstl::static_vector<int, 4> small = {1, 2, 3};
+    int extra[] = {7, 8};
+    thrown = false;
+    try
+    {
+        small.insert(small.begin(), extra, extra + 2);
+    }
+    catch(const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && small.size() == 3 && small[0] == 1 && small[2] == 3 && "insert(range) overflow error");
+
+    LOGI("test static_vector vector api passed!");
+}
+
+int main()
+{
+    testNoAllocation();
+    testVectorApi();
+    return 0;
+}
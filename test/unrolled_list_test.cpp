@@ -0,0 +1,198 @@
+#include "wunrolled_list.hpp"
+#include "test_common.hpp"
+#include "wdeque.hpp"
+
+#include <cstdlib>
+#include <string>
+
+// 4 elements per node, so a handful of elements already spans several nodes
+typedef wstl::unrolled_list<int, 4> small_list;
+
+template <class List, class Ref>
+static bool sameAs(const List& lst, const Ref& ref)
+{
+    if(lst.size() != ref.size()) return false;
+    auto it = lst.begin();
+    for(auto& v : ref) {
+        if(!(*it == v)) return false;
+        ++it;
+    }
+    return it == lst.end();
+}
+
+static bool idsAre(const small_list& lst, std::initializer_list<int> ids)
+{
+    return sameAs(lst, ids);
+}
+
+void testConstructor()
+{
+    small_list empty_list;
+    assert(empty_list.empty() && empty_list.begin() == empty_list.end() && "unrolled_list() error");
+
+    small_list n_list(10, 7);
+    assert(n_list.size() == 10 && n_list.front() == 7 && n_list.back() == 7 && "unrolled_list(n, value) error");
+
+    small_list ilist{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    assert(idsAre(ilist, {1, 2, 3, 4, 5, 6, 7, 8, 9}) && "unrolled_list(ilist) error");
+
+    small_list copy_list(ilist);
+    assert(copy_list == ilist && "unrolled_list(const&) error");
+
+    small_list move_list(wstl::move(copy_list));
+    assert(copy_list.empty() && move_list == ilist && "unrolled_list(&&) error");
+
+    copy_list = {3, 2, 1};
+    move_list = copy_list;
+    assert(idsAre(move_list, {3, 2, 1}) && "operator= error");
+
+    int reversed = 0;
+    for(auto it = ilist.rbegin(); it != ilist.rend(); ++it) {
+        reversed = reversed * 10 + *it;
+    }
+    assert(reversed == 987654321 && "reverse_iterator error");
+
+    wstl::unrolled_list<std::string> str_list(3, "unrolled");
+    assert(str_list.size() == 3 && str_list.back() == "unrolled" && "unrolled_list<string> error");
+
+    LOGI("test unrolled_list constructor passed!");
+}
+
+void testInsertErase()
+{
+    small_list lst;
+    for(int i = 0; i < 8; ++i) {
+        lst.push_back(i);
+    }
+    lst.push_front(-1);
+
+    // insert into the middle of a full node splits it
+    auto it = lst.begin();
+    wstl::advance(it, 3);
+    it = lst.insert(it, 100);
+    assert(*it == 100 && idsAre(lst, {-1, 0, 1, 100, 2, 3, 4, 5, 6, 7}) && "insert error");
+
+    it = lst.insert(lst.end(), 3, 9);
+    assert(*it == 9 && lst.size() == 13 && lst.back() == 9 && "insert(n, value) error");
+
+    lst.erase(it, lst.end());
+    it = lst.erase(lst.begin());
+    assert(*it == 0 && idsAre(lst, {0, 1, 100, 2, 3, 4, 5, 6, 7}) && "erase error");
+
+    auto first = lst.begin();
+    auto last = lst.end();
+    wstl::advance(first, 2);
+    wstl::advance(last, -2);
+    it = lst.erase(first, last);
+    assert(*it == 6 && idsAre(lst, {0, 1, 6, 7}) && "erase(range) error");
+
+    lst.pop_back();
+    lst.pop_front();
+    assert(idsAre(lst, {1, 6}) && "pop error");
+
+    lst.resize(5, 2);
+    assert(idsAre(lst, {1, 6, 2, 2, 2}) && "resize(grow) error");
+    lst.resize(1);
+    assert(idsAre(lst, {1}) && "resize(shrink) error");
+
+    lst.clear();
+    assert(lst.empty() && lst.begin() == lst.end() && "clear error");
+
+    // an element of the list as the value to insert, into a full node
+    small_list self_ref{1, 2, 3, 4};
+    auto mid = self_ref.begin();
+    wstl::advance(mid, 1);
+    self_ref.insert(mid, self_ref.back());
+    assert(idsAre(self_ref, {1, 4, 2, 3, 4}) && "insert(own element) error");
+
+    LOGI("test unrolled_list insert/erase passed!");
+}
+
+void testRandomAgainstDeque()
+{
+    small_list lst;
+    wstl::deque<int> ref;
+    std::srand(7);
+    for(int step = 0; step < 20000; ++step) {
+        const int op = std::rand() % 6;
+        const size_t pos = ref.empty() ? 0 : static_cast<size_t>(std::rand()) % (ref.size() + 1);
+        auto it = lst.begin();
+        wstl::advance(it, static_cast<long>(pos));
+        if(op < 3 || ref.empty()) {
+            lst.insert(it, step);
+            ref.insert(ref.begin() + pos, step);
+        }
+        else if(pos < ref.size()) {
+            auto r = lst.erase(it);
+            auto rr = ref.erase(ref.begin() + pos);
+            assert((rr == ref.end() ? r == lst.end() : *r == *rr) && "random erase result error");
+        }
+    }
+    assert(sameAs(lst, ref) && "random insert/erase error");
+
+    LOGI("test unrolled_list random insert/erase passed!");
+}
+
+void testSplice()
+{
+    small_list a{1, 2, 3, 4, 5, 6};
+    small_list b{10, 20, 30};
+
+    auto pos = a.begin();
+    wstl::advance(pos, 2);
+    a.splice(pos, b);
+    assert(b.empty() && idsAre(a, {1, 2, 10, 20, 30, 3, 4, 5, 6}) && "splice(list) error");
+
+    auto first = a.begin();
+    auto last = a.begin();
+    wstl::advance(first, 1);
+    wstl::advance(last, 5);
+    b.splice(b.end(), a, first, last);
+    assert(idsAre(a, {1, 3, 4, 5, 6}) && idsAre(b, {2, 10, 20, 30}) && "splice(range) error");
+    assert(a.size() == 5 && b.size() == 4 && "splice(range) size error");
+
+    b.splice(b.begin(), a, a.begin());
+    assert(idsAre(a, {3, 4, 5, 6}) && idsAre(b, {1, 2, 10, 20, 30}) && "splice(element) error");
+
+    LOGI("test unrolled_list splice passed!");
+}
+
+void testRemoveUniqueMerge()
+{
+    small_list lst{1, 1, 2, 3, 3, 3, 4, 5, 5, 6};
+    lst.unique();
+    assert(idsAre(lst, {1, 2, 3, 4, 5, 6}) && "unique error");
+
+    lst.remove_if([](int v) { return v % 2 == 0; });
+    assert(idsAre(lst, {1, 3, 5}) && "remove_if error");
+
+    lst.remove(3);
+    assert(idsAre(lst, {1, 5}) && "remove error");
+
+    small_list x{0, 2, 4, 6, 8, 10, 12};
+    lst = {1, 3, 5, 7, 9};
+    lst.merge(x);
+    assert(x.empty() && idsAre(lst, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12}) && "merge error");
+
+    lst.reverse();
+    assert(idsAre(lst, {12, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0}) && "reverse error");
+
+    wstl::unrolled_list<std::string, 3> words{"a", "a", "b", "c", "c", "d"};
+    words.unique();
+    words.remove("c");
+    wstl::unrolled_list<std::string, 3> more{"c", "e"};
+    words.merge(more);
+    assert(sameAs(words, std::initializer_list<std::string>{"a", "b", "c", "d", "e"}) && "unrolled_list<string> error");
+
+    LOGI("test unrolled_list remove/unique/merge passed!");
+}
+
+int main()
+{
+    testConstructor();
+    testInsertErase();
+    testRandomAgainstDeque();
+    testSplice();
+    testRemoveUniqueMerge();
+    return 0;
+}
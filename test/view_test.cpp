@@ -0,0 +1,159 @@
+#include "wview.hpp"
+#include "wvector.hpp"
+#include "wmmap_vector.hpp"
+#include "test_common.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+struct point
+{
+    int     x;
+    int     y;
+};
+
+// a stringstream's buffer has no alignment promise, copy into one that does
+static wstl::vector<uint64_t> aligned_copy(const std::string& bytes)
+{
+    wstl::vector<uint64_t> words((bytes.size() + 7) / 8, 0);
+    std::memcpy(words.data(), bytes.data(), bytes.size());
+    return words;
+}
+
+static wstl::span<const unsigned char> byte_span(const wstl::vector<uint64_t>& words, size_t bytes)
+{
+    return wstl::span<const unsigned char>(reinterpret_cast<const unsigned char*>(words.data()), bytes);
+}
+
+void testVectorView()
+{
+    wstl::vector<point> points;
+    for(int i = 0; i < 100; ++i) {
+        points.push_back(point{i, -i});
+    }
+    std::stringstream ss;
+    wstl::write_vector_view<point>(ss, points);
+    const std::string bytes = ss.str();
+    assert(bytes.size() == sizeof(wstl::view_header) + wstl::view_align(100 * sizeof(point)) && "vector view layout error");
+
+    const wstl::vector<uint64_t> buf = aligned_copy(bytes);
+    wstl::vector_view<point> view(byte_span(buf, bytes.size()));
+    assert(view.size() == 100 && view[42].y == -42 && view.back().x == 99 && "vector_view visit error");
+    const size_t offset = reinterpret_cast<const char*>(view.data()) - reinterpret_cast<const char*>(buf.data());
+    assert(offset % VIEW_ALIGN == 0 && "vector_view column offset error");
+    int sum = 0;
+    for(const point& p : view) {
+        sum += p.x;
+    }
+    assert(sum == 4950 && view.verify() && "vector_view iterate/verify error");
+
+    bool thrown = false;
+    try
+    {
+        view.at(100);
+    }
+    catch(const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "vector_view at error");
+
+    // the wrong element type and a damaged byte are both caught
+    thrown = false;
+    try
+    {
+        wstl::vector_view<int> wrong(byte_span(buf, bytes.size()));
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "vector_view element size check error");
+
+    wstl::vector<uint64_t> damaged = buf;
+    reinterpret_cast<unsigned char*>(damaged.data())[sizeof(wstl::view_header) + 5] ^= 1;
+    assert(!wstl::vector_view<point>(byte_span(damaged, bytes.size())).verify() && "checksum error");
+
+    thrown = false;
+    try
+    {
+        wstl::vector_view<point> cut(byte_span(buf, bytes.size() - 512));
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "vector_view truncated buffer error");
+
+    std::stringstream empty_ss;
+    wstl::write_vector_view<int>(empty_ss, wstl::span<const int>());
+    const std::string empty_bytes = empty_ss.str();
+    const wstl::vector<uint64_t> empty_buf = aligned_copy(empty_bytes);
+    wstl::vector_view<int> empty_view(byte_span(empty_buf, empty_bytes.size()));
+    assert(empty_view.empty() && empty_view.verify() && "empty vector_view error");
+
+    LOGI("test vector_view passed!");
+}
+
+void testSortedMapView()
+{
+    wstl::vector<uint32_t> keys;
+    wstl::vector<double> values;
+    for(uint32_t k = 0; k < 1000; ++k) {
+        keys.push_back(k * 3);
+        values.push_back(k * 0.5);
+    }
+
+    const std::string path = "/tmp/wstl_view_" + std::to_string(::getpid());
+    {
+        std::ofstream out(path.c_str(), std::ios::binary);
+        wstl::write_sorted_map_view<uint32_t, double>(out, keys, values);
+    }
+
+    wstl::mmap_vector<unsigned char> file(path.c_str(), wstl::mmap_mode::read_only);
+    wstl::sorted_map_view<uint32_t, double> map(file);
+    assert(map.size() == 1000 && map.verify() && "sorted_map_view open error");
+    assert(map.contains(2997) && !map.contains(2998) && !map.contains(5000) && "contains error");
+    assert(*map.find(300) == 50.0 && map.find(1) == nullptr && map.at(0) == 0.0 && "find error");
+    assert(map.lower_bound(4) == 2 && map.index_of(4) == map.npos && map.key_at(2) == 6 &&
+           map.value_at(2) == 1.0 && "lower_bound error");
+    assert(map.keys().size() == 1000 && map.values()[999] == 499.5 && "columns error");
+
+    bool thrown = false;
+    try
+    {
+        wstl::vector_view<uint32_t> wrong_kind(file);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "view kind check error");
+
+    thrown = false;
+    try
+    {
+        std::stringstream ss;
+        uint32_t unsorted[] = {2, 1};
+        double vals[] = {0, 0};
+        wstl::write_sorted_map_view<uint32_t, double>(ss, unsorted, vals);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown && "unsorted keys error");
+
+    file.close();
+    ::unlink(path.c_str());
+    LOGI("test sorted_map_view passed!");
+}
+
+int main()
+{
+    testVectorView();
+    testSortedMapView();
+    return 0;
+}
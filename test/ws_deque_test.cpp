@@ -0,0 +1,86 @@
+#include "test_common.hpp"
+#include "wws_deque.hpp"
+
+#include <thread>
+
+void testOwner()
+{
+    wstl::ws_deque<int> dq(4);
+    assert(dq.empty() && dq.capacity() == 4 && "ws_deque(n) error");
+
+    for(int i = 0; i < 10; ++i) {
+        dq.push_back(i);
+    }
+    assert(dq.size() == 10 && dq.capacity() == 16 && "ws_deque push_back grow error");
+
+    int value = 0;
+    assert(dq.pop_back(value) && value == 9 && "ws_deque pop_back error");
+    assert(dq.steal_front(value) && value == 0 && "ws_deque steal_front error");
+    assert(dq.size() == 8 && "ws_deque size error");
+
+    while (dq.pop_back(value))
+    {
+        ;
+    }
+    assert(value == 1 && dq.empty() && "ws_deque pop_back drain error");
+    assert(!dq.steal_front(value) && "ws_deque steal_front on empty error");
+
+    LOGI("test ws_deque owner passed!");
+}
+
+void testSteal()
+{
+    const int count = 200000;
+    const int thieves = 3;
+    wstl::ws_deque<int> dq(8);
+    std::atomic<long long> sum(0);
+    std::atomic<int> taken(0);
+    std::atomic<bool> done(false);
+
+    std::thread threads[thieves];
+    for(auto& t : threads) {
+        t = std::thread([&]() {
+            int value = 0;
+            while (!done.load() || !dq.empty())
+            {
+                if(dq.steal_front(value)) {
+                    sum.fetch_add(value);
+                    taken.fetch_add(1);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    int value = 0;
+    for(int i = 1; i <= count; ++i) {
+        dq.push_back(i);
+        if(i % 3 == 0 && dq.pop_back(value)) {
+            sum.fetch_add(value);
+            taken.fetch_add(1);
+        }
+    }
+    while (dq.pop_back(value))
+    {
+        sum.fetch_add(value);
+        taken.fetch_add(1);
+    }
+    done.store(true);
+    for(auto& t : threads) {
+        t.join();
+    }
+
+    const long long n = count;
+    assert(taken.load() == count && sum.load() == n * (n + 1) / 2 && "ws_deque steal each item once error");
+
+    LOGI("test ws_deque steal passed!");
+}
+
+int main()
+{
+    testOwner();
+    testSteal();
+    return 0;
+}